@@ -0,0 +1,304 @@
+// 可参数化的合成 C 语料生成器：性能测试的标准输入
+// 同一组参数与种子总是生成逐字节相同的语料；预置错误以 `// BUG: <类别>` 标注，可直接用于 --eval
+//
+// 用法: node scripts/gen_corpus.js [--out=tests/corpus] [--seed=1] [--files=100] [--functions=8]
+//         [--function-size=20] [--lines=0] [--depth=3] [--includes=2] [--headers=16]
+//         [--pointer-density=0.3] [--macros=0.2] [--bug-rate=0.5] [--bugs=uninit:1,wild:1,...]
+//         [--dir-fanout=0]
+//
+//   --lines=N        每个文件生成到至少 N 行为止（忽略 --functions），用于单文件巨型输入
+//   --dir-fanout=K   K > 0 时按每目录 K 项分层存放文件，用于深层目录树
+//   --bugs           各类错误的相对权重，类别见 BUG_KINDS
+
+const fs = require('fs');
+const path = require('path');
+
+const DEFAULTS = {
+  out: 'tests/corpus',
+  seed: 1,
+  files: 100,
+  functions: 8,
+  'function-size': 20,
+  lines: 0,
+  depth: 3,
+  includes: 2,
+  headers: 16,
+  'pointer-density': 0.3,
+  macros: 0.2,
+  'bug-rate': 0.5,
+  bugs: 'uninit:1,wild:1,null:1,loop:1,leak:1,overflow:1,format:1,header:1',
+  'dir-fanout': 0,
+};
+
+// 错误类别 -> 评测标签（与 CLI 的 normalizeCategoryLabel 对应）
+const BUG_KINDS = {
+  uninit: 'Uninitialized',
+  wild: 'Wild pointer',
+  null: 'Null pointer',
+  loop: 'Dead loop',
+  leak: 'Memory leak',
+  overflow: 'Range overflow',
+  format: 'Format',
+  header: 'Header',
+};
+
+function parseArgs(argv) {
+  const options = { ...DEFAULTS };
+  for (const arg of argv) {
+    const m = arg.match(/^--([\w-]+)=(.*)$/);
+    if (!m || !(m[1] in DEFAULTS)) {
+      console.error(`未知参数: ${arg}`);
+      process.exit(1);
+    }
+    options[m[1]] = typeof DEFAULTS[m[1]] === 'number' ? Number(m[2]) : m[2];
+  }
+  const weights = [];
+  for (const part of String(options.bugs).split(',').filter(Boolean)) {
+    const [kind, weight] = part.split(':');
+    if (!(kind in BUG_KINDS)) {
+      console.error(`未知错误类别: ${kind}`);
+      process.exit(1);
+    }
+    weights.push([kind, weight === undefined ? 1 : Number(weight)]);
+  }
+  options.weights = weights.filter(([, w]) => w > 0);
+  return options;
+}
+
+// mulberry32：确定性 32 位伪随机数
+function createRandom(seed) {
+  let state = seed >>> 0;
+  const next = () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+  return {
+    next,
+    int: (n) => Math.floor(next() * n),
+    chance: (p) => next() < p,
+    pick: (items) => items[Math.floor(next() * items.length)],
+    weighted: (pairs) => {
+      const total = pairs.reduce((sum, [, w]) => sum + w, 0);
+      let r = next() * total;
+      for (const [item, w] of pairs) {
+        if ((r -= w) < 0) return item;
+      }
+      return pairs[pairs.length - 1][0];
+    },
+  };
+}
+
+class FileBuilder {
+  // includeDir: 从该文件所在目录到语料根下 include/ 的相对路径
+  constructor(options, rng, index, includeDir) {
+    this.options = options;
+    this.rng = rng;
+    this.index = index;
+    this.includeDir = includeDir;
+    this.lines = [];
+    this.bugs = {};
+    this.temp = 0;
+  }
+
+  fresh(prefix) {
+    return `${prefix}${this.temp++}`;
+  }
+
+  emit(indent, text, bug) {
+    const pad = '    '.repeat(indent);
+    this.lines.push(bug ? `${pad}${text} // BUG: ${BUG_KINDS[bug]}` : `${pad}${text}`);
+    if (bug) this.bugs[bug] = (this.bugs[bug] || 0) + 1;
+  }
+
+  header(headerCount) {
+    const { rng, options } = this;
+    if (options.weights.some(([kind]) => kind === 'header') && rng.chance(options['bug-rate'] / 4)) {
+      this.emit(0, '#include <stdiox.h>', 'header');
+    }
+    this.emit(0, '#include <stdio.h>');
+    this.emit(0, '#include <stdlib.h>');
+    const fanout = Math.min(options.includes, headerCount);
+    const chosen = new Set();
+    while (chosen.size < fanout) chosen.add(rng.int(headerCount));
+    for (const h of [...chosen].sort((a, b) => a - b)) this.emit(0, `#include "${this.includeDir}/hdr_${h}.h"`);
+    if (options.macros > 0) {
+      this.emit(0, '#define SQUARE(x) ((x) * (x))');
+      this.emit(0, '#define CLAMP(v, lo, hi) ((v) < (lo) ? (lo) : (v) > (hi) ? (hi) : (v))');
+      this.emit(0, `#define LIMIT_${this.index} ${16 + rng.int(240)}`);
+    }
+    this.emit(0, '');
+  }
+
+  func(name) {
+    const { rng, options } = this;
+    this.emit(0, `int ${name}(int n) {`);
+    this.emit(1, 'int total = 0;');
+    this.emit(1, 'int local = n;');
+    const size = Math.max(1, options['function-size']);
+    let statements = 0;
+    while (statements < size) {
+      statements += this.block(1, 0, size - statements);
+    }
+    // 预置错误放在返回前（死循环不影响其余语句的可达性）
+    const kinds = options.weights.filter(([kind]) => kind !== 'header');
+    if (kinds.length > 0 && rng.chance(options['bug-rate'])) {
+      this.bug(1, rng.weighted(kinds));
+    }
+    this.emit(1, 'return total;');
+    this.emit(0, '}');
+    this.emit(0, '');
+  }
+
+  // 生成一条语句（可能是嵌套的复合语句），返回消耗的语句数
+  block(indent, depth, budget) {
+    const { rng, options } = this;
+    if (depth < options.depth && budget > 2 && rng.chance(0.3)) {
+      const i = this.fresh('i');
+      const shape = rng.int(3);
+      if (shape === 0) this.emit(indent, `for (int ${i} = 0; ${i} < n; ${i}++) {`);
+      else if (shape === 1) this.emit(indent, `if (local > ${rng.int(100)}) {`);
+      else this.emit(indent, `while (local > ${rng.int(10)}) {`);
+      let used = 1;
+      const inner = 1 + rng.int(Math.min(budget - 1, 6));
+      while (used < inner) used += this.block(indent + 1, depth + 1, inner - used);
+      if (shape === 2) this.emit(indent + 1, 'local--;');
+      this.emit(indent, '}');
+      return used;
+    }
+    if (rng.chance(options['pointer-density'])) {
+      this.pointerStatement(indent);
+    } else if (rng.chance(options.macros)) {
+      this.emit(indent, `total += CLAMP(SQUARE(local), 0, LIMIT_${this.index});`);
+    } else {
+      this.emit(indent, rng.pick([
+        `total += local * ${1 + rng.int(9)};`,
+        `local = (local + total) % ${2 + rng.int(97)};`,
+        `total ^= local << ${rng.int(8)};`,
+        'printf("%d %d\\n", total, local);',
+      ]));
+    }
+    return 1;
+  }
+
+  pointerStatement(indent) {
+    const { rng } = this;
+    const p = this.fresh('p');
+    if (rng.chance(0.5)) {
+      this.emit(indent, `int *${p} = &local;`);
+      this.emit(indent, `*${p} += total;`);
+    } else {
+      this.emit(indent, `int *${p} = malloc(sizeof(int) * 4);`);
+      this.emit(indent, `if (${p} != NULL) {`);
+      this.emit(indent + 1, `${p}[0] = local;`);
+      this.emit(indent + 1, `total += ${p}[0];`);
+      this.emit(indent + 1, `free(${p});`);
+      this.emit(indent, '}');
+    }
+  }
+
+  bug(indent, kind) {
+    const v = this.fresh('b');
+    switch (kind) {
+      case 'uninit':
+        this.emit(indent, `int ${v};`);
+        this.emit(indent, `total += ${v};`, kind);
+        break;
+      case 'wild':
+        this.emit(indent, `int *${v};`);
+        this.emit(indent, `*${v} = local;`, kind);
+        break;
+      case 'null':
+        this.emit(indent, `int *${v} = NULL;`);
+        this.emit(indent, `*${v} = local;`, kind);
+        break;
+      case 'loop':
+        this.emit(indent, 'while (1) {', kind);
+        this.emit(indent + 1, 'total++;');
+        this.emit(indent, '}');
+        break;
+      case 'leak':
+        this.emit(indent, `char *${v} = malloc(64);`, kind);
+        this.emit(indent, `${v}[0] = (char)local;`);
+        break;
+      case 'overflow':
+        this.emit(indent, `unsigned char ${v} = 300;`, kind);
+        this.emit(indent, `total += ${v};`);
+        break;
+      case 'format':
+        this.emit(indent, 'printf("%d %d\\n", total);', kind);
+        break;
+    }
+  }
+
+  build(headerCount) {
+    const { options } = this;
+    this.header(headerCount);
+    let count = 0;
+    const names = [];
+    const more = () => (options.lines > 0 ? this.lines.length < options.lines : count < options.functions);
+    while (more()) {
+      const name = `f${this.index}_${count++}`;
+      names.push(name);
+      this.func(name);
+    }
+    this.emit(0, 'int main(void) {');
+    this.emit(1, 'int total = 0;');
+    for (const name of names) this.emit(1, `total += ${name}(${names.length});`);
+    this.emit(1, 'return total > 0 ? 0 : 1;');
+    this.emit(0, '}');
+    return this.lines.join('\n') + '\n';
+  }
+}
+
+// 第 i 个文件的相对路径；dir-fanout 为 K 时按 K 进制分层
+function relativePath(i, files, fanout) {
+  const name = `gen_${String(i).padStart(String(files - 1).length, '0')}.c`;
+  if (!(fanout > 0) || files <= fanout) return name;
+  const parts = [];
+  for (let rest = Math.floor(i / fanout), span = Math.ceil(files / fanout); span > 1; span = Math.ceil(span / fanout)) {
+    parts.unshift(`d${rest % fanout}`);
+    rest = Math.floor(rest / fanout);
+  }
+  return path.join(...parts, name);
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const root = path.resolve(process.cwd(), options.out);
+
+  const headerCount = Math.max(1, options.headers);
+  fs.mkdirSync(path.join(root, 'include'), { recursive: true });
+  for (let h = 0; h < headerCount; h++) {
+    const guard = `HDR_${h}_H`;
+    const decls = [];
+    for (let k = 0; k < 4; k++) decls.push(`int hdr_${h}_fn${k}(int value);`);
+    fs.writeFileSync(path.join(root, 'include', `hdr_${h}.h`),
+      `#ifndef ${guard}\n#define ${guard}\n\n${decls.join('\n')}\n\n#endif\n`, 'utf8');
+  }
+
+  const totals = {};
+  let lines = 0;
+  for (let i = 0; i < options.files; i++) {
+    const relative = relativePath(i, options.files, options['dir-fanout']);
+    const file = path.join(root, relative);
+    // 分层存放时每深一层加一个 ../，头文件不依赖 -I 也能找到
+    const includeDir = '../'.repeat(relative.split(path.sep).length - 1) + 'include';
+    // 每个文件使用独立的子种子，文件内容不受生成顺序影响
+    const builder = new FileBuilder(options, createRandom((options.seed * 0x9e3779b1 + i) >>> 0), i, includeDir);
+    const code = builder.build(headerCount);
+    fs.mkdirSync(path.dirname(file), { recursive: true });
+    fs.writeFileSync(file, code, 'utf8');
+    lines += builder.lines.length;
+    for (const [kind, n] of Object.entries(builder.bugs)) totals[BUG_KINDS[kind]] = (totals[BUG_KINDS[kind]] || 0) + n;
+  }
+
+  const { weights, ...params } = options;
+  const manifest = { params, files: options.files, lines, bugs: totals };
+  fs.writeFileSync(path.join(root, 'manifest.json'), JSON.stringify(manifest, null, 2) + '\n', 'utf8');
+  console.log(`Generated ${options.files} files (${lines} lines) in ${root}`);
+}
+
+main();
@@ -0,0 +1,108 @@
+// 定长稠密位向量：数据流分析的格元素，按局部变量 id 或定义点 id 索引
+
+export class BitVector {
+  readonly size: number;
+  private readonly words: Uint32Array;
+
+  constructor(size: number) {
+    this.size = size;
+    this.words = new Uint32Array((size + 31) >>> 5);
+  }
+
+  has(i: number): boolean {
+    return (this.words[i >>> 5] & (1 << (i & 31))) !== 0;
+  }
+
+  set(i: number): void {
+    this.words[i >>> 5] |= 1 << (i & 31);
+  }
+
+  clear(i: number): void {
+    this.words[i >>> 5] &= ~(1 << (i & 31));
+  }
+
+  /**
+   * 全部置 1（仅前 size 位）
+   */
+  fill(): void {
+    this.words.fill(0xffffffff);
+    const tail = this.size & 31;
+    if (tail && this.words.length > 0) {
+      this.words[this.words.length - 1] = (1 << tail) - 1;
+    }
+  }
+
+  reset(): void {
+    this.words.fill(0);
+  }
+
+  copyFrom(other: BitVector): void {
+    this.words.set(other.words);
+  }
+
+  /**
+   * this |= other，返回是否发生变化
+   */
+  unionWith(other: BitVector): boolean {
+    let changed = false;
+    for (let w = 0; w < this.words.length; w++) {
+      const next = this.words[w] | other.words[w];
+      if (next !== this.words[w]) {
+        this.words[w] = next;
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  /**
+   * this &= other，返回是否发生变化
+   */
+  intersectWith(other: BitVector): boolean {
+    let changed = false;
+    for (let w = 0; w < this.words.length; w++) {
+      const next = this.words[w] & other.words[w];
+      if (next !== this.words[w]) {
+        this.words[w] = next;
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  /**
+   * this &= ~other
+   */
+  subtract(other: BitVector): void {
+    for (let w = 0; w < this.words.length; w++) {
+      this.words[w] &= ~other.words[w];
+    }
+  }
+
+  equals(other: BitVector): boolean {
+    for (let w = 0; w < this.words.length; w++) {
+      if (this.words[w] !== other.words[w]) return false;
+    }
+    return true;
+  }
+
+  clone(): BitVector {
+    const copy = new BitVector(this.size);
+    copy.words.set(this.words);
+    return copy;
+  }
+
+  /**
+   * 遍历所有置位的下标
+   */
+  forEach(callback: (i: number) => void): void {
+    for (let w = 0; w < this.words.length; w++) {
+      let bits = this.words[w];
+      while (bits !== 0) {
+        const low = bits & -bits;
+        callback((w << 5) + (31 - Math.clz32(low)));
+        bits ^= low;
+      }
+    }
+  }
+}
@@ -0,0 +1,159 @@
+// 全程序调用图：汇总所有被扫描文件中的函数定义，按名字解析直接调用（static 函数仅在本文件可见），
+// 并给出强连通分量的自底向上顺序（被调者先于调用者），供函数摘要逐分量计算
+
+import { ASTNode } from '../core/ast_parser';
+import { AnalysisSession } from './session';
+import { childOfType, named } from './syntax';
+import { functionName } from './cfg';
+
+export interface ProgramUnit {
+  file: string;
+  root: ASTNode;
+  lines?: string[];
+}
+
+export interface CallGraphNode {
+  id: number;
+  name: string;
+  file: string;
+  node: ASTNode;
+  isStatic: boolean;
+}
+
+export class CallGraph {
+  readonly nodes: CallGraphNode[] = [];
+  private readonly globals = new Map<string, number>();
+  private readonly statics = new Map<string, number>();
+  private readonly byNode = new Map<ASTNode, number>();
+  private succStart: Int32Array = new Int32Array(1);
+  private succ: Int32Array = new Int32Array(0);
+  private predStart: Int32Array = new Int32Array(1);
+  private pred: Int32Array = new Int32Array(0);
+  private sccCache?: number[][];
+
+  constructor(units: ProgramUnit[]) {
+    for (const unit of units) {
+      const session = AnalysisSession.for(unit.root, unit.lines);
+      for (const fn of session.functions()) {
+        const name = functionName(fn);
+        if (!name) continue;
+        const isStatic = named(fn).some(child => child.type === 'storage_class_specifier' && child.text === 'static');
+        const id = this.nodes.length;
+        this.nodes.push({ id, name, file: unit.file, node: fn, isStatic });
+        this.byNode.set(fn, id);
+        if (isStatic) this.statics.set(`${unit.file}\0${name}`, id);
+        else if (!this.globals.has(name)) this.globals.set(name, id);
+      }
+    }
+    this.buildEdges();
+  }
+
+  /**
+   * 在某文件中按名字解析被调函数：先找本文件的 static 定义，再找外部定义
+   */
+  resolve(name: string, file: string): CallGraphNode | undefined {
+    const id = this.statics.get(`${file}\0${name}`) ?? this.globals.get(name);
+    return id === undefined ? undefined : this.nodes[id];
+  }
+
+  nodeOf(fn: ASTNode): CallGraphNode | undefined {
+    const id = this.byNode.get(fn);
+    return id === undefined ? undefined : this.nodes[id];
+  }
+
+  callees(id: number): Int32Array {
+    return this.succ.subarray(this.succStart[id], this.succStart[id + 1]);
+  }
+
+  callers(id: number): Int32Array {
+    return this.pred.subarray(this.predStart[id], this.predStart[id + 1]);
+  }
+
+  /**
+   * 强连通分量（Tarjan，迭代实现），被调者所在分量排在调用者之前
+   */
+  sccs(): number[][] {
+    if (this.sccCache) return this.sccCache;
+    const count = this.nodes.length;
+    const index = new Int32Array(count).fill(-1);
+    const low = new Int32Array(count);
+    const onStack = new Uint8Array(count);
+    const stack: number[] = [];
+    const result: number[][] = [];
+    let counter = 0;
+
+    // 显式调用栈：节点与其下一个待访问后继的下标
+    const work: Array<[number, number]> = [];
+    for (let root = 0; root < count; root++) {
+      if (index[root] >= 0) continue;
+      work.push([root, 0]);
+      while (work.length > 0) {
+        const frame = work[work.length - 1];
+        const [v, next] = frame;
+        if (next === 0 && index[v] < 0) {
+          index[v] = low[v] = counter++;
+          stack.push(v);
+          onStack[v] = 1;
+        }
+        const targets = this.callees(v);
+        if (next < targets.length) {
+          frame[1]++;
+          const w = targets[next];
+          if (index[w] < 0) work.push([w, 0]);
+          else if (onStack[w]) low[v] = Math.min(low[v], index[w]);
+          continue;
+        }
+        work.pop();
+        if (work.length > 0) {
+          const parent = work[work.length - 1][0];
+          low[parent] = Math.min(low[parent], low[v]);
+        }
+        if (low[v] === index[v]) {
+          const component: number[] = [];
+          let w: number;
+          do {
+            w = stack.pop()!;
+            onStack[w] = 0;
+            component.push(w);
+          } while (w !== v);
+          result.push(component);
+        }
+      }
+    }
+    this.sccCache = result;
+    return result;
+  }
+
+  private buildEdges(): void {
+    const lists: number[][] = this.nodes.map(() => []);
+    for (const caller of this.nodes) {
+      const seen = new Set<number>();
+      const stack: ASTNode[] = [];
+      const body = childOfType(caller.node, 'compound_statement');
+      if (body) stack.push(body);
+      while (stack.length > 0) {
+        const node = stack.pop()!;
+        if (node.type === 'call_expression') {
+          const callee = named(node)[0];
+          const target = callee && callee.type === 'identifier' ? this.resolve(callee.text, caller.file) : undefined;
+          if (target && !seen.has(target.id)) {
+            seen.add(target.id);
+            lists[caller.id].push(target.id);
+          }
+        }
+        for (const child of node.children) stack.push(child);
+      }
+    }
+    this.succStart = new Int32Array(this.nodes.length + 1);
+    lists.forEach((list, i) => { this.succStart[i + 1] = this.succStart[i] + list.length; });
+    this.succ = new Int32Array(this.succStart[this.nodes.length]);
+    lists.forEach((list, i) => this.succ.set(list, this.succStart[i]));
+
+    const reverse: number[][] = this.nodes.map(() => []);
+    lists.forEach((list, caller) => { for (const callee of list) reverse[callee].push(caller); });
+    this.predStart = new Int32Array(this.nodes.length + 1);
+    reverse.forEach((list, i) => { this.predStart[i + 1] = this.predStart[i] + list.length; });
+    this.pred = new Int32Array(this.predStart[this.nodes.length]);
+    reverse.forEach((list, i) => this.pred.set(list, this.predStart[i]));
+  }
+}
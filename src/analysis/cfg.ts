@@ -0,0 +1,564 @@
+// 函数级控制流图：基本块只保存按执行顺序排列的语句/条件表达式，
+// 边以压缩行（CSR）形式存放在 Int32Array 中；同时记录循环及块所属的最内层循环
+
+import { ASTNode } from '../core/ast_parser';
+import { named, childOfType, isToken, isConstantTrue, isConstantFalse, stripParens } from './syntax';
+
+/**
+ * 不返回的函数：调用后控制流直接到达函数出口
+ */
+export const NORETURN_FUNCTIONS = new Set([
+  'exit', '_exit', '_Exit', 'quick_exit', 'abort', 'longjmp', 'siglongjmp', '__builtin_unreachable'
+]);
+
+export interface LoopInfo {
+  id: number;
+  node: ASTNode;
+  header: number;    // 循环头（while/for 的条件块，do-while 的循环体入口）
+  parent: number;    // 外层循环 id，-1 表示不在循环内
+}
+
+/**
+ * 条件分支：块末尾的条件表达式及其为真/为假时的后继（该边不存在时为 -1）
+ */
+export interface BranchInfo {
+  condition: ASTNode;
+  whenTrue: number;
+  whenFalse: number;
+}
+
+export class ControlFlowGraph {
+  readonly entry = 0;
+  readonly exit = 1;
+  readonly blockCount: number;
+  private rpo: Int32Array | null = null;
+  private loopExits: Int8Array;
+  private loopIndex: Map<string, LoopInfo> | null = null;
+
+  constructor(
+    readonly functionNode: ASTNode,
+    readonly name: string,
+    /** 每个块的语句/表达式 */
+    readonly items: ASTNode[][],
+    private readonly succOffsets: Int32Array,
+    private readonly succTargets: Int32Array,
+    private readonly predOffsets: Int32Array,
+    private readonly predTargets: Int32Array,
+    /** 每个块所属的最内层循环 id，-1 表示不在循环内 */
+    readonly blockLoop: Int32Array,
+    readonly loops: LoopInfo[],
+    /** goto 到未定义的标签等无法精确建模的情况下为 false */
+    readonly complete: boolean,
+    /** 以条件结尾的块的分支信息（if/while/do/for） */
+    readonly branches: ReadonlyMap<number, BranchInfo> = new Map()
+  ) {
+    this.blockCount = items.length;
+    this.loopExits = new Int8Array(loops.length).fill(-1);
+  }
+
+  successors(block: number): Int32Array {
+    return this.succTargets.subarray(this.succOffsets[block], this.succOffsets[block + 1]);
+  }
+
+  predecessors(block: number): Int32Array {
+    return this.predTargets.subarray(this.predOffsets[block], this.predOffsets[block + 1]);
+  }
+
+  /**
+   * 从入口可达块的逆后序（结果缓存）
+   */
+  reversePostorder(): Int32Array {
+    if (this.rpo) return this.rpo;
+    const visited = new Uint8Array(this.blockCount);
+    const order: number[] = [];
+    // 迭代式 DFS，避免深层嵌套函数栈溢出
+    const blocks: number[] = [this.entry];
+    const cursors: number[] = [this.succOffsets[this.entry]];
+    visited[this.entry] = 1;
+    while (blocks.length > 0) {
+      const top = blocks.length - 1;
+      const block = blocks[top];
+      if (cursors[top] < this.succOffsets[block + 1]) {
+        const next = this.succTargets[cursors[top]++];
+        if (!visited[next]) {
+          visited[next] = 1;
+          blocks.push(next);
+          cursors.push(this.succOffsets[next]);
+        }
+      } else {
+        order.push(block);
+        blocks.pop();
+        cursors.pop();
+      }
+    }
+    this.rpo = Int32Array.from(order.reverse());
+    return this.rpo;
+  }
+
+  /**
+   * 按源码位置查找循环（节点可能来自同一棵树的不同副本，不能按对象比较）
+   */
+  loopAt(node: ASTNode): LoopInfo | undefined {
+    if (!this.loopIndex) {
+      this.loopIndex = new Map();
+      for (const loop of this.loops) this.loopIndex.set(positionKey(loop.node), loop);
+    }
+    return this.loopIndex.get(positionKey(node));
+  }
+
+  /**
+   * 块是否属于某循环（含其内层循环）
+   */
+  inLoop(block: number, loop: number): boolean {
+    for (let l = this.blockLoop[block]; l >= 0; l = this.loops[l].parent) {
+      if (l === loop) return true;
+    }
+    return false;
+  }
+
+  /**
+   * 从循环头出发能否离开循环（break、return、goto 到循环外、exit() 或条件为假）
+   */
+  loopCanExit(loop: LoopInfo): boolean {
+    const cached = this.loopExits[loop.id];
+    if (cached >= 0) return cached === 1;
+    const canExit = this.searchLoopExit(loop);
+    this.loopExits[loop.id] = canExit ? 1 : 0;
+    return canExit;
+  }
+
+  /**
+   * 同 loopCanExit，但不经过 blocked 判定为不可行的边（如条件恒真的循环条件的假分支）
+   */
+  loopCanExitWithout(loop: LoopInfo, blocked: (from: number, to: number) => boolean): boolean {
+    return this.searchLoopExit(loop, blocked);
+  }
+
+  private searchLoopExit(loop: LoopInfo, blocked?: (from: number, to: number) => boolean): boolean {
+    const visited = new Uint8Array(this.blockCount);
+    const stack = [loop.header];
+    visited[loop.header] = 1;
+    let canExit = false;
+    while (stack.length > 0 && !canExit) {
+      const block = stack.pop()!;
+      for (const next of this.successors(block)) {
+        if (blocked && blocked(block, next)) continue;
+        if (!this.inLoop(next, loop.id)) {
+          canExit = true;
+          break;
+        }
+        if (!visited[next]) {
+          visited[next] = 1;
+          stack.push(next);
+        }
+      }
+    }
+    return canExit;
+  }
+}
+
+export function positionKey(node: ASTNode): string {
+  return `${node.startPosition.row}:${node.startPosition.column}`;
+}
+
+/**
+ * 为 function_definition 节点构建控制流图
+ */
+export function buildCFG(functionNode: ASTNode): ControlFlowGraph {
+  return new CFGBuilder(functionNode).build();
+}
+
+/**
+ * function_definition 的函数声明器
+ */
+export function functionDeclarator(functionNode: ASTNode): ASTNode | undefined {
+  let declarator = named(functionNode).find(child => child.type.endsWith('declarator'));
+  while (declarator && declarator.type !== 'function_declarator') {
+    declarator = named(declarator).find(child => child.type.endsWith('declarator'));
+  }
+  return declarator;
+}
+
+/**
+ * function_definition 的函数名
+ */
+export function functionName(functionNode: ASTNode): string {
+  const declarator = functionDeclarator(functionNode);
+  const name = declarator ? named(declarator)[0] : undefined;
+  return name ? name.text : '';
+}
+
+/**
+ * 语句是否为对不返回函数的调用（exit(1); abort();）
+ */
+export function isNoReturnCall(expr: ASTNode): boolean {
+  const call = stripParens(expr);
+  if (call.type !== 'call_expression') return false;
+  const callee = named(call)[0];
+  return !!callee && callee.type === 'identifier' && NORETURN_FUNCTIONS.has(callee.text);
+}
+
+interface JumpTargets {
+  breakTarget: number;
+  continueTarget: number;   // switch 中沿用外层循环的 continue 目标，-1 表示无
+}
+
+interface SwitchState {
+  head: number;
+  hasDefault: boolean;
+}
+
+class CFGBuilder {
+  private readonly items: ASTNode[][] = [];
+  private readonly succs: number[][] = [];
+  private readonly blockLoop: number[] = [];
+  private readonly loops: LoopInfo[] = [];
+  private readonly targets: JumpTargets[] = [];
+  private readonly switches: SwitchState[] = [];
+  private readonly labels = new Map<string, number>();
+  private readonly branches = new Map<number, BranchInfo>();
+  private readonly definedLabels = new Set<string>();
+  private currentLoop = -1;
+  private current: number;
+
+  constructor(private readonly functionNode: ASTNode) {
+    this.newBlock();   // entry
+    this.newBlock();   // exit
+    this.current = this.newBlock();
+    this.addEdge(0, this.current);
+  }
+
+  build(): ControlFlowGraph {
+    const body = childOfType(this.functionNode, 'compound_statement');
+    if (body) this.statement(body);
+    this.jump(1);
+
+    let complete = true;
+    for (const label of this.labels.keys()) {
+      if (!this.definedLabels.has(label)) complete = false;
+    }
+
+    const count = this.items.length;
+    const succOffsets = new Int32Array(count + 1);
+    const predOffsets = new Int32Array(count + 1);
+    for (let b = 0; b < count; b++) {
+      succOffsets[b + 1] = succOffsets[b] + this.succs[b].length;
+      for (const to of this.succs[b]) predOffsets[to + 1]++;
+    }
+    for (let b = 0; b < count; b++) predOffsets[b + 1] += predOffsets[b];
+
+    const succTargets = new Int32Array(succOffsets[count]);
+    const predTargets = new Int32Array(predOffsets[count]);
+    const fill = predOffsets.slice(0, count);
+    for (let b = 0; b < count; b++) {
+      succTargets.set(this.succs[b], succOffsets[b]);
+      for (const to of this.succs[b]) predTargets[fill[to]++] = b;
+    }
+
+    return new ControlFlowGraph(
+      this.functionNode, functionName(this.functionNode), this.items,
+      succOffsets, succTargets, predOffsets, predTargets,
+      Int32Array.from(this.blockLoop), this.loops, complete, this.branches
+    );
+  }
+
+  private newBlock(): number {
+    this.items.push([]);
+    this.succs.push([]);
+    this.blockLoop.push(this.currentLoop);
+    return this.items.length - 1;
+  }
+
+  private addEdge(from: number, to: number): void {
+    if (from < 0) return;
+    const row = this.succs[from];
+    if (!row.includes(to)) row.push(to);
+  }
+
+  /**
+   * 当前块；位于 return/break 之后的不可达代码时新建一个无前驱的块
+   */
+  private block(): number {
+    if (this.current < 0) this.current = this.newBlock();
+    return this.current;
+  }
+
+  private append(item: ASTNode): void {
+    this.items[this.block()].push(item);
+  }
+
+  private jump(target: number): void {
+    this.addEdge(this.current, target);
+    this.current = -1;
+  }
+
+  private startBlock(preds: number[]): number {
+    const id = this.newBlock();
+    for (const pred of preds) this.addEdge(pred, id);
+    this.current = id;
+    return id;
+  }
+
+  private branch(block: number, condition: ASTNode | undefined, whenTrue: number, whenFalse: number): void {
+    if (condition) this.branches.set(block, { condition, whenTrue, whenFalse });
+  }
+
+  private enterLoop(node: ASTNode): LoopInfo {
+    const loop: LoopInfo = { id: this.loops.length, node, header: -1, parent: this.currentLoop };
+    this.loops.push(loop);
+    this.currentLoop = loop.id;
+    return loop;
+  }
+
+  private leaveLoop(loop: LoopInfo): void {
+    this.currentLoop = loop.parent;
+  }
+
+  private labelBlock(name: string): number {
+    let block = this.labels.get(name);
+    if (block === undefined) {
+      block = this.newBlock();
+      this.labels.set(name, block);
+    }
+    return block;
+  }
+
+  private statement(node: ASTNode): void {
+    switch (node.type) {
+      case 'compound_statement':
+        for (const child of named(node)) this.statement(child);
+        return;
+      case 'declaration':
+        this.append(node);
+        return;
+      case 'expression_statement': {
+        const expr = named(node)[0];
+        if (!expr) return;
+        this.append(expr);
+        if (isNoReturnCall(expr)) this.jump(1);
+        return;
+      }
+      case 'if_statement':
+        this.ifStatement(node);
+        return;
+      case 'while_statement':
+        this.whileStatement(node);
+        return;
+      case 'do_statement':
+        this.doStatement(node);
+        return;
+      case 'for_statement':
+        this.forStatement(node);
+        return;
+      case 'switch_statement':
+        this.switchStatement(node);
+        return;
+      case 'case_statement':
+        this.caseStatement(node);
+        return;
+      case 'return_statement': {
+        const value = named(node)[0];
+        if (value) this.append(value);
+        this.jump(1);
+        return;
+      }
+      case 'break_statement': {
+        const target = this.targets[this.targets.length - 1];
+        if (target) this.jump(target.breakTarget);
+        return;
+      }
+      case 'continue_statement': {
+        const target = this.targets[this.targets.length - 1];
+        if (target && target.continueTarget >= 0) this.jump(target.continueTarget);
+        return;
+      }
+      case 'goto_statement': {
+        const label = childOfType(node, 'statement_identifier');
+        if (label) this.jump(this.labelBlock(label.text));
+        return;
+      }
+      case 'labeled_statement': {
+        const parts = named(node);
+        const label = parts.find(child => child.type === 'statement_identifier');
+        if (label) {
+          const block = this.labelBlock(label.text);
+          this.definedLabels.add(label.text);
+          // 前向 goto 先创建了该块，此处按标签实际位置修正所属循环
+          this.blockLoop[block] = this.currentLoop;
+          this.addEdge(this.current, block);
+          this.current = block;
+        }
+        for (const child of parts) {
+          if (child !== label) this.statement(child);
+        }
+        return;
+      }
+      default:
+        if (!node.type.startsWith('preproc') && node.type !== 'comment') this.append(node);
+    }
+  }
+
+  private ifStatement(node: ASTNode): void {
+    const parts = named(node);
+    const condition = parts[0];
+    const consequence = parts[1];
+    let alternative = parts[2];
+    if (alternative && alternative.type === 'else_clause') alternative = named(alternative)[0];
+
+    if (condition) this.append(condition);
+    const head = this.block();
+
+    const thenStart = this.startBlock(isConstantFalse(condition) ? [] : [head]);
+    if (consequence) this.statement(consequence);
+    const thenEnd = this.current;
+
+    let elseEnd = isConstantTrue(condition) ? -1 : head;
+    let whenFalse = -1;
+    if (alternative) {
+      whenFalse = this.startBlock([elseEnd]);
+      this.statement(alternative);
+      elseEnd = this.current;
+    }
+
+    if (thenEnd < 0 && elseEnd < 0) {
+      this.current = -1;
+    } else {
+      const join = this.startBlock([thenEnd, elseEnd]);
+      if (!alternative) whenFalse = join;
+    }
+    this.branch(head, condition,
+      isConstantFalse(condition) ? -1 : thenStart,
+      isConstantTrue(condition) ? -1 : whenFalse);
+  }
+
+  private whileStatement(node: ASTNode): void {
+    const [condition, body] = named(node);
+    const before = this.block();
+    const after = this.newBlock();
+
+    const loop = this.enterLoop(node);
+    const header = this.startBlock([before]);
+    loop.header = header;
+    if (condition) this.append(condition);
+    if (!isConstantTrue(condition)) this.addEdge(header, after);
+
+    this.targets.push({ breakTarget: after, continueTarget: header });
+    const bodyStart = this.startBlock(isConstantFalse(condition) ? [] : [header]);
+    this.branch(header, condition, isConstantFalse(condition) ? -1 : bodyStart, isConstantTrue(condition) ? -1 : after);
+    if (body) this.statement(body);
+    this.jump(header);
+    this.targets.pop();
+    this.leaveLoop(loop);
+
+    this.current = after;
+  }
+
+  private doStatement(node: ASTNode): void {
+    const parts = named(node);
+    const body = parts.find(child => child.type !== 'parenthesized_expression');
+    const condition = parts.find(child => child.type === 'parenthesized_expression');
+    const before = this.block();
+    const after = this.newBlock();
+
+    const loop = this.enterLoop(node);
+    const conditionBlock = this.newBlock();
+    const bodyStart = this.startBlock([before]);
+    loop.header = bodyStart;
+
+    this.targets.push({ breakTarget: after, continueTarget: conditionBlock });
+    if (body) this.statement(body);
+    this.jump(conditionBlock);
+    this.targets.pop();
+
+    if (condition) this.items[conditionBlock].push(condition);
+    if (!isConstantFalse(condition)) this.addEdge(conditionBlock, bodyStart);
+    if (!isConstantTrue(condition)) this.addEdge(conditionBlock, after);
+    this.branch(conditionBlock, condition, isConstantFalse(condition) ? -1 : bodyStart, isConstantTrue(condition) ? -1 : after);
+    this.leaveLoop(loop);
+
+    this.current = after;
+  }
+
+  private forStatement(node: ASTNode): void {
+    // for (init; cond; update) body：按匿名的 ';' 与 ')' 记号划分各部分（子节点没有字段名）
+    let init: ASTNode | undefined;
+    let condition: ASTNode | undefined;
+    let update: ASTNode | undefined;
+    let body: ASTNode | undefined;
+    let section = 0;
+    for (const child of node.children) {
+      if (isToken(child)) {
+        if (child.text === ';') section++;
+        else if (child.text === ')') section = 3;
+        continue;
+      }
+      if (section === 0) {
+        init = child;
+        // 声明自带 ';'
+        if (child.type === 'declaration') section = 1;
+      } else if (section === 1) condition = child;
+      else if (section === 2) update = child;
+      else body = child;
+    }
+
+    if (init) this.append(init);
+    const before = this.block();
+    const after = this.newBlock();
+
+    const loop = this.enterLoop(node);
+    const header = this.startBlock([before]);
+    loop.header = header;
+    if (condition) this.append(condition);
+    if (condition && !isConstantTrue(condition)) this.addEdge(header, after);
+
+    const updateBlock = this.newBlock();
+    this.targets.push({ breakTarget: after, continueTarget: updateBlock });
+    const bodyStart = this.startBlock([header]);
+    this.branch(header, condition, bodyStart, isConstantTrue(condition) ? -1 : after);
+    if (body) this.statement(body);
+    this.jump(updateBlock);
+    this.targets.pop();
+
+    if (update) this.items[updateBlock].push(update);
+    this.addEdge(updateBlock, header);
+    this.leaveLoop(loop);
+
+    this.current = after;
+  }
+
+  private switchStatement(node: ASTNode): void {
+    const parts = named(node);
+    const condition = parts.find(child => child.type === 'parenthesized_expression');
+    const body = parts.find(child => child.type === 'compound_statement');
+
+    if (condition) this.append(condition);
+    const head = this.block();
+    const after = this.newBlock();
+    const outer = this.targets[this.targets.length - 1];
+
+    this.targets.push({ breakTarget: after, continueTarget: outer ? outer.continueTarget : -1 });
+    this.switches.push({ head, hasDefault: false });
+    // case 标签之前的语句不可达
+    this.current = -1;
+    if (body) this.statement(body);
+    this.jump(after);
+    const state = this.switches.pop()!;
+    this.targets.pop();
+
+    if (!state.hasDefault) this.addEdge(head, after);
+    this.current = after;
+  }
+
+  private caseStatement(node: ASTNode): void {
+    const state = this.switches[this.switches.length - 1];
+    const isDefault = node.children.some(child => isToken(child) && child.text === 'default');
+    const statements = named(node).slice(isDefault ? 0 : 1);
+
+    if (state) {
+      // 上一个 case 未 break 时贯穿到本块
+      this.startBlock([this.current, state.head]);
+      if (isDefault) state.hasDefault = true;
+    }
+    for (const child of statements) this.statement(child);
+  }
+}
@@ -0,0 +1,104 @@
+// 通用单调数据流求解器：位向量格，按逆后序（后向问题按后序）的工作表迭代到不动点
+
+import { BitVector } from './bitvector';
+import { ControlFlowGraph } from './cfg';
+
+export type Direction = 'forward' | 'backward';
+export type Meet = 'union' | 'intersection';
+
+export interface DataflowProblem {
+  direction: Direction;
+  meet: Meet;
+  width: number;
+  /**
+   * 入口（后向问题为出口）处的边界值
+   */
+  boundary(value: BitVector): void;
+  /**
+   * 块传递函数：由块入口值 input 计算出口值写入 output
+   */
+  transfer(block: number, input: BitVector, output: BitVector): void;
+}
+
+export interface DataflowResult {
+  /** 按数据流方向的块入口值 */
+  input: BitVector[];
+  /** 按数据流方向的块出口值 */
+  output: BitVector[];
+  iterations: number;
+}
+
+/**
+ * 求解数据流问题；仅从入口可达的块参与迭代，其余块的值保持为空集
+ */
+export function solve(cfg: ControlFlowGraph, problem: DataflowProblem): DataflowResult {
+  const count = cfg.blockCount;
+  const forward = problem.direction === 'forward';
+  const order = forward ? cfg.reversePostorder() : cfg.reversePostorder().slice().reverse();
+  const start = forward ? cfg.entry : cfg.exit;
+
+  const input: BitVector[] = new Array(count);
+  const output: BitVector[] = new Array(count);
+  for (let b = 0; b < count; b++) {
+    input[b] = new BitVector(problem.width);
+    output[b] = new BitVector(problem.width);
+    // 交汇为交集时，内部块从全集（格顶）开始下降
+    if (problem.meet === 'intersection') output[b].fill();
+  }
+
+  const position = new Int32Array(count).fill(-1);
+  order.forEach((block, i) => { position[block] = i; });
+
+  // 工作表按位置排序出队：一个待处理标记数组 + 从最小位置开始的扫描
+  const pending = new Uint8Array(order.length).fill(1);
+  let remaining = order.length;
+  let cursor = 0;
+  let iterations = 0;
+  const scratch = new BitVector(problem.width);
+
+  while (remaining > 0) {
+    while (!pending[cursor]) cursor = (cursor + 1) % order.length;
+    pending[cursor] = 0;
+    remaining--;
+    const block = order[cursor];
+    iterations++;
+
+    const into = input[block];
+    if (block === start) {
+      into.reset();
+      problem.boundary(into);
+    } else {
+      const sources = forward ? cfg.predecessors(block) : cfg.successors(block);
+      let first = true;
+      for (const source of sources) {
+        if (position[source] < 0) continue;
+        if (first) {
+          into.copyFrom(output[source]);
+          first = false;
+        } else if (problem.meet === 'union') {
+          into.unionWith(output[source]);
+        } else {
+          into.intersectWith(output[source]);
+        }
+      }
+      if (first) into.reset();
+    }
+
+    scratch.reset();
+    problem.transfer(block, into, scratch);
+    if (scratch.equals(output[block])) continue;
+    output[block].copyFrom(scratch);
+
+    const targets = forward ? cfg.successors(block) : cfg.predecessors(block);
+    for (const target of targets) {
+      const p = position[target];
+      if (p >= 0 && !pending[p]) {
+        pending[p] = 1;
+        remaining++;
+        if (p < cursor) cursor = p;
+      }
+    }
+  }
+
+  return { input, output, iterations };
+}
@@ -0,0 +1,587 @@
+// 区间抽象解释：在函数 CFG 上对整型局部变量做前向区间分析，循环头加宽、收敛后再做几轮收窄；
+// 分支边按条件细化区间，细化为空的边视为不可行。块迭代次数有预算上限，超出时放弃该函数的结论
+
+import { ASTNode } from '../core/ast_parser';
+import { FunctionFlow, LocalVariable } from './variable_flow';
+import { TypeTable } from './type_table';
+import { named, operatorOf, unparen, unwrapDeclarator, isToken, childOfType } from './syntax';
+import { DataModel, DEFAULT_DATA_MODEL, IntegerRange, integerRange, parseLiteral } from '../utils/c_types';
+
+// 表示无穷的界：超出任何 C 整数类型，运算结果按此饱和
+const INF = 1n << 256n;
+
+export interface Interval {
+  lo: bigint;
+  hi: bigint;
+}
+
+const TOP: Interval = { lo: -INF, hi: INF };
+const BOOL: Interval = { lo: 0n, hi: 1n };
+const TRUE: Interval = { lo: 1n, hi: 1n };
+const FALSE: Interval = { lo: 0n, hi: 0n };
+
+/** 每个函数允许的块传递次数上限 */
+export const DEFAULT_INTERVAL_BUDGET = 20000;
+// 循环头前几次更新直接合并，之后加宽
+const WIDENING_DELAY = 2;
+const NARROWING_PASSES = 2;
+
+const COMPARISONS = new Set(['<', '<=', '>', '>=', '==', '!=']);
+const NEGATED: Record<string, string> = { '<': '>=', '<=': '>', '>': '<=', '>=': '<', '==': '!=', '!=': '==' };
+const MIRRORED: Record<string, string> = { '<': '>', '<=': '>=', '>': '<', '>=': '<=', '==': '==', '!=': '!=' };
+
+/**
+ * 赋值结果必然超出目标类型范围
+ */
+export interface OverflowFinding {
+  node: ASTNode;
+  variable: LocalVariable;
+  typeName: string;
+  range: IntegerRange;
+  value: Interval;
+}
+
+// 各追踪变量的区间；null 表示不可达
+type State = Interval[] | null;
+
+export class IntervalAnalysis {
+  /** 在预算内收敛；为 false 时不给出任何结论 */
+  readonly complete: boolean;
+  readonly overflows: OverflowFinding[] = [];
+  iterations = 0;
+  private readonly slotOf: Int32Array;
+  private readonly slotVariables: LocalVariable[] = [];
+  private readonly slotTypes: string[] = [];
+  private readonly slotRanges: IntegerRange[] = [];
+  private readonly input: State[];
+  private readonly infeasible = new Set<number>();
+  private readonly intRange: IntegerRange;
+  private recording = false;
+
+  constructor(readonly flow: FunctionFlow, types: TypeTable, private readonly model: DataModel = DEFAULT_DATA_MODEL,
+              private readonly budget: number = DEFAULT_INTERVAL_BUDGET) {
+    const cfg = flow.cfg;
+    this.intRange = integerRange('int', model)!;
+    this.slotOf = new Int32Array(flow.variables.length).fill(-1);
+    const addressTaken = this.addressTaken();
+    for (const variable of flow.variables) {
+      if (!variable.tracked || variable.isPointer || variable.isArray || addressTaken.has(variable.id)) continue;
+      const declared = types.lookup(variable.name, { row: variable.row, column: variable.column });
+      const range = declared && declared.depth === 0 ? integerRange(declared.base, model) : null;
+      if (!range) continue;
+      this.slotOf[variable.id] = this.slotVariables.length;
+      this.slotVariables.push(variable);
+      this.slotTypes.push(declared!.base);
+      this.slotRanges.push(range);
+    }
+    this.input = new Array(cfg.blockCount).fill(null);
+    this.complete = cfg.complete && this.solve();
+    if (this.complete) this.replay();
+  }
+
+  /**
+   * 块入口处变量的区间；块不可达、变量未追踪或分析未完成时为 undefined
+   */
+  rangeAt(block: number, variable: LocalVariable): Interval | undefined {
+    const state = this.input[block];
+    const slot = this.slotOf[variable.id];
+    return this.complete && state && slot >= 0 ? state[slot] : undefined;
+  }
+
+  /**
+   * 边在区间意义下不可行（如恒为真的条件的假分支）
+   */
+  isInfeasible(from: number, to: number): boolean {
+    return this.infeasible.has(from * this.flow.cfg.blockCount + to);
+  }
+
+  private solve(): boolean {
+    const cfg = this.flow.cfg;
+    const rpo = cfg.reversePostorder();
+    const position = new Int32Array(cfg.blockCount).fill(-1);
+    rpo.forEach((block, i) => { position[block] = i; });
+    // 有回边进入的块是加宽点
+    const widenAt = new Uint8Array(cfg.blockCount);
+    for (const block of rpo) {
+      for (const succ of cfg.successors(block)) {
+        if (position[succ] >= 0 && position[succ] <= position[block]) widenAt[succ] = 1;
+      }
+    }
+    const output: State[] = new Array(cfg.blockCount).fill(null);
+    const visits = new Int32Array(cfg.blockCount);
+
+    const sweep = (mode: 'ascend' | 'narrow'): boolean => {
+      let changed = false;
+      for (const block of rpo) {
+        let next = block === cfg.entry ? this.entryState() : this.joinPredecessors(block, output, position);
+        const previous = this.input[block];
+        if (mode === 'ascend' && widenAt[block] && previous && next && ++visits[block] > WIDENING_DELAY) {
+          next = widen(previous, next);
+        } else if (mode === 'narrow' && previous && next) {
+          next = narrow(previous, next);
+        }
+        if (this.iterations > 0 && sameState(previous, next)) continue;
+        this.input[block] = next;
+        output[block] = this.transfer(block, next);
+        changed = true;
+      }
+      return changed;
+    };
+
+    while (sweep('ascend')) {
+      if (this.iterations > this.budget) return false;
+    }
+    for (let pass = 0; pass < NARROWING_PASSES && sweep('narrow'); pass++) {
+      if (this.iterations > this.budget) return false;
+    }
+    return true;
+  }
+
+  /**
+   * 不动点上逐块回放一次：记录溢出赋值与不可行的分支边
+   */
+  private replay(): void {
+    const cfg = this.flow.cfg;
+    this.recording = true;
+    for (const block of cfg.reversePostorder()) {
+      const state = this.input[block];
+      if (!state) continue;
+      const out = this.transfer(block, state);
+      const branch = cfg.branches.get(block);
+      if (!branch || !out || branch.whenTrue === branch.whenFalse) continue;
+      if (branch.whenTrue >= 0 && !this.refine(out, branch.condition, true)) {
+        this.infeasible.add(block * cfg.blockCount + branch.whenTrue);
+      }
+      if (branch.whenFalse >= 0 && !this.refine(out, branch.condition, false)) {
+        this.infeasible.add(block * cfg.blockCount + branch.whenFalse);
+      }
+    }
+    this.recording = false;
+  }
+
+  private entryState(): State {
+    return this.slotRanges.map(range => ({ lo: range.min, hi: range.max }));
+  }
+
+  private joinPredecessors(block: number, output: State[], position: Int32Array): State {
+    let result: State = null;
+    for (const pred of this.flow.cfg.predecessors(block)) {
+      if (position[pred] < 0) continue;
+      result = joinState(result, this.edgeState(pred, block, output[pred]));
+    }
+    return result;
+  }
+
+  private edgeState(from: number, to: number, out: State): State {
+    const branch = this.flow.cfg.branches.get(from);
+    if (!out || !branch || branch.whenTrue === branch.whenFalse) return out;
+    if (to === branch.whenTrue) return this.refine(out, branch.condition, true);
+    if (to === branch.whenFalse) return this.refine(out, branch.condition, false);
+    return out;
+  }
+
+  private transfer(block: number, input: State): State {
+    this.iterations++;
+    if (!input) return null;
+    const state = input.slice();
+    for (const item of this.flow.cfg.items[block]) this.execute(item, state);
+    return state;
+  }
+
+  private execute(node: ASTNode, state: Interval[]): void {
+    if (node.type !== 'declaration') {
+      this.evaluate(node, state);
+      return;
+    }
+    for (const child of named(node)) {
+      if (!child.type.endsWith('declarator') && child.type !== 'identifier') continue;
+      const info = unwrapDeclarator(child);
+      const variable = info ? this.flow.resolve(info.name) : undefined;
+      if (!variable) continue;
+      const parts = named(child);
+      const init = child.type === 'init_declarator' && parts.length > 1 ? parts[parts.length - 1] : undefined;
+      if (init) {
+        this.assign(variable, this.evaluate(init, state), state, init);
+      } else {
+        // 未初始化：可能是类型范围内的任意值
+        const slot = this.slotOf[variable.id];
+        if (slot >= 0) state[slot] = fullRange(this.slotRanges[slot]);
+      }
+    }
+  }
+
+  /**
+   * 赋值：结果超出类型范围时按回绕处理（单值精确回绕，否则取整个类型范围）；回放时记录必然溢出
+   */
+  private assign(variable: LocalVariable, value: Interval, state: Interval[], node: ASTNode): void {
+    const slot = this.slotOf[variable.id];
+    if (slot < 0) return;
+    const range = this.slotRanges[slot];
+    if (this.recording && (value.lo > range.max || value.hi < range.min)) {
+      this.overflows.push({ node, variable, typeName: this.slotTypes[slot], range, value });
+    }
+    state[slot] = fitInto(value, range);
+  }
+
+  /**
+   * 表达式的区间，同时把其中的赋值/自增自减作用到 state
+   */
+  private evaluate(node: ASTNode, state: Interval[]): Interval {
+    switch (node.type) {
+      case 'number_literal':
+      case 'char_literal': {
+        const literal = parseLiteral(node.text, this.model);
+        return literal && literal.kind === 'int' ? { lo: literal.value, hi: literal.value } : TOP;
+      }
+      case 'identifier': {
+        const slot = this.slotOfNode(node);
+        return slot >= 0 ? state[slot] : TOP;
+      }
+      case 'parenthesized_expression': {
+        const parts = named(node);
+        return parts.length > 0 ? this.evaluate(parts[parts.length - 1], state) : TOP;
+      }
+      case 'cast_expression': {
+        const parts = named(node);
+        const value = parts.length > 0 ? this.evaluate(parts[parts.length - 1], state) : TOP;
+        const descriptor = childOfType(node, 'type_descriptor');
+        const range = descriptor && !descriptor.text.includes('*') ? integerRange(descriptor.text, this.model) : null;
+        return range ? fitInto(value, range) : TOP;
+      }
+      case 'assignment_expression': {
+        const parts = named(node);
+        const left = parts[0];
+        const right = parts[parts.length - 1];
+        const value = right ? this.evaluate(right, state) : TOP;
+        const target = left ? this.flow.resolve(unparen(left)) : undefined;
+        const slot = target ? this.slotOf[target.id] : -1;
+        if (slot < 0) {
+          if (left) this.evaluate(left, state);
+          return value;
+        }
+        const op = operatorOf(node);
+        const result = op === '=' ? value : arithmetic(op.slice(0, -1), state[slot], value);
+        this.assign(target!, result, state, node);
+        return state[slot];
+      }
+      case 'update_expression': {
+        const operand = named(node)[0];
+        const variable = operand ? this.flow.resolve(unparen(operand)) : undefined;
+        const slot = variable ? this.slotOf[variable.id] : -1;
+        if (slot < 0) {
+          if (operand) this.evaluate(operand, state);
+          return TOP;
+        }
+        const old = state[slot];
+        const step = operatorOf(node) === '++' ? 1n : -1n;
+        this.assign(variable!, arithmetic('+', old, { lo: step, hi: step }), state, node);
+        // 前缀形式的值是新值
+        return isToken(node.children[0]) ? state[slot] : old;
+      }
+      case 'unary_expression': {
+        const operand = named(node)[0];
+        const value = operand ? this.evaluate(operand, state) : TOP;
+        // 无符号操作数（如 ~0u、-1u）的结果按其类型回绕
+        const type = operand ? this.promotedRange(operand) : null;
+        const wrap = (result: Interval): Interval => (type && type.min === 0n ? fitInto(result, type) : result);
+        switch (operatorOf(node)) {
+          case '-': return wrap({ lo: saturate(-value.hi), hi: saturate(-value.lo) });
+          case '+': return value;
+          case '~': return wrap({ lo: saturate(-value.hi - 1n), hi: saturate(-value.lo - 1n) });
+          case '!': return truth(value) === true ? FALSE : truth(value) === false ? TRUE : BOOL;
+        }
+        return TOP;
+      }
+      case 'binary_expression': {
+        const [left, right] = named(node);
+        const op = operatorOf(node);
+        if (!left || !right) return TOP;
+        if (op === '&&' || op === '||') return this.logical(op, left, right, state);
+        const a = this.evaluate(left, state);
+        const b = this.evaluate(right, state);
+        return COMPARISONS.has(op) ? compare(op, a, b) : arithmetic(op, a, b);
+      }
+      case 'conditional_expression': {
+        const [condition, consequence, alternative] = named(node);
+        if (!condition || !consequence || !alternative) return TOP;
+        this.evaluate(condition, state);
+        const whenTrue = this.refine(state, condition, true);
+        const whenFalse = this.refine(state, condition, false);
+        const a = whenTrue ? this.evaluate(consequence, whenTrue) : null;
+        const b = whenFalse ? this.evaluate(alternative, whenFalse) : null;
+        const merged = joinState(whenTrue, whenFalse);
+        if (merged) merged.forEach((value, slot) => { state[slot] = value; });
+        return a && b ? hull(a, b) : a || b || TOP;
+      }
+      case 'comma_expression': {
+        let value = TOP;
+        for (const part of named(node)) value = this.evaluate(part, state);
+        return value;
+      }
+      case 'sizeof_expression':
+        return TOP;
+    }
+    for (const child of named(node)) this.evaluate(child, state);
+    return TOP;
+  }
+
+  /**
+   * && / ||：右操作数只在左操作数决定不了结果时求值，其副作用按两条路径合并
+   */
+  private logical(op: string, left: ASTNode, right: ASTNode, state: Interval[]): Interval {
+    const a = this.evaluate(left, state);
+    const shortCircuit = op === '&&' ? false : true;
+    if (truth(a) === shortCircuit) return shortCircuit ? TRUE : FALSE;
+    const continued = this.refine(state, left, !shortCircuit);
+    if (!continued) return shortCircuit ? TRUE : FALSE;
+    const b = truth(this.evaluate(right, continued));
+    const merged = truth(a) === undefined ? joinState(this.refine(state, left, shortCircuit), continued) : continued;
+    if (merged) merged.forEach((value, slot) => { state[slot] = value; });
+    if (b === shortCircuit) return truth(a) === undefined ? BOOL : (shortCircuit ? TRUE : FALSE);
+    return b === undefined || truth(a) === undefined ? BOOL : (shortCircuit ? FALSE : TRUE);
+  }
+
+  /**
+   * 在条件为 expected 的前提下细化 state（不修改输入）；条件不可能取该值时返回 null
+   */
+  private refine(state: State, condition: ASTNode, expected: boolean): State {
+    if (!state) return null;
+    const expr = unparen(condition);
+    if (expr.type === 'binary_expression') {
+      const [left, right] = named(expr);
+      const op = operatorOf(expr);
+      if (left && right && (op === '&&' || op === '||')) {
+        const conjunction = (op === '&&') === expected;
+        if (conjunction) return this.refine(this.refine(state, left, expected), right, expected);
+        return joinState(this.refine(state, left, expected), this.refine(this.refine(state, left, !expected), right, expected));
+      }
+      if (left && right && COMPARISONS.has(op)) {
+        const actual = expected ? op : NEGATED[op];
+        let result: State = state.slice();
+        const leftSlot = this.slotOfNode(unparen(left));
+        const rightSlot = this.slotOfNode(unparen(right));
+        if (leftSlot >= 0) result = restrict(result, leftSlot, actual, this.evaluate(right, state.slice()));
+        if (result && rightSlot >= 0) result = restrict(result, rightSlot, MIRRORED[actual], this.evaluate(left, state.slice()));
+        if (!result || leftSlot >= 0 || rightSlot >= 0) return result;
+      }
+    }
+    if (expr.type === 'unary_expression' && operatorOf(expr) === '!') {
+      const operand = named(expr)[0];
+      return operand ? this.refine(state, operand, !expected) : state;
+    }
+    const slot = this.slotOfNode(expr);
+    if (slot >= 0) return restrict(state.slice(), slot, expected ? '!=' : '==', FALSE);
+    const value = truth(this.evaluate(expr, state.slice()));
+    return value === !expected ? null : state;
+  }
+
+  /**
+   * 表达式经整数提升后的类型范围：只识别字面量、追踪变量、强制转换及其一元组合，其余返回 null
+   */
+  private promotedRange(node: ASTNode): IntegerRange | null {
+    let range: IntegerRange | null = null;
+    switch (node.type) {
+      case 'number_literal':
+      case 'char_literal': {
+        const literal = parseLiteral(node.text, this.model);
+        if (literal && literal.kind === 'int') {
+          const bits = BigInt(literal.bits);
+          range = literal.signed
+            ? { min: -(1n << (bits - 1n)), max: (1n << (bits - 1n)) - 1n }
+            : { min: 0n, max: (1n << bits) - 1n };
+        }
+        break;
+      }
+      case 'identifier': {
+        const slot = this.slotOfNode(node);
+        range = slot >= 0 ? this.slotRanges[slot] : null;
+        break;
+      }
+      case 'cast_expression': {
+        const descriptor = childOfType(node, 'type_descriptor');
+        range = descriptor && !descriptor.text.includes('*') ? integerRange(descriptor.text, this.model) : null;
+        break;
+      }
+      case 'parenthesized_expression':
+      case 'unary_expression': {
+        const parts = named(node);
+        const op = node.type === 'unary_expression' ? operatorOf(node) : '';
+        range = parts.length > 0 && op !== '!' ? this.promotedRange(parts[parts.length - 1]) : null;
+        break;
+      }
+    }
+    if (!range) return null;
+    return range.min >= this.intRange.min && range.max <= this.intRange.max ? this.intRange : range;
+  }
+
+  private slotOfNode(node: ASTNode): number {
+    const variable = node.type === 'identifier' ? this.flow.resolve(node) : undefined;
+    return variable ? this.slotOf[variable.id] : -1;
+  }
+
+  /**
+   * 被取过地址的变量可能经由指针修改，不参与追踪
+   */
+  private addressTaken(): Set<number> {
+    const result = new Set<number>();
+    const stack: ASTNode[] = [this.flow.functionNode];
+    while (stack.length > 0) {
+      const node = stack.pop()!;
+      if (node.type === 'pointer_expression' && operatorOf(node) === '&') {
+        let operand = named(node)[0];
+        while (operand && (operand.type === 'field_expression' || operand.type === 'subscript_expression' || operand.type === 'parenthesized_expression')) {
+          operand = named(operand)[0];
+        }
+        const variable = operand ? this.flow.resolve(operand) : undefined;
+        if (variable) result.add(variable.id);
+      }
+      for (const child of node.children) stack.push(child);
+    }
+    return result;
+  }
+}
+
+function saturate(value: bigint): bigint {
+  return value >= INF ? INF : value <= -INF ? -INF : value;
+}
+
+function hull(a: Interval, b: Interval): Interval {
+  return { lo: a.lo < b.lo ? a.lo : b.lo, hi: a.hi > b.hi ? a.hi : b.hi };
+}
+
+function fullRange(range: IntegerRange): Interval {
+  return { lo: range.min, hi: range.max };
+}
+
+/**
+ * 把值放入类型范围：已在范围内原样保留，单值按二进制补码回绕，其余取整个范围
+ */
+function fitInto(value: Interval, range: IntegerRange): Interval {
+  if (value.lo >= range.min && value.hi <= range.max) return value;
+  if (value.lo === value.hi && value.lo > -INF && value.lo < INF) {
+    const size = range.max - range.min + 1n;
+    const wrapped = ((value.lo - range.min) % size + size) % size + range.min;
+    return { lo: wrapped, hi: wrapped };
+  }
+  return fullRange(range);
+}
+
+/**
+ * 区间的真值：恒真 true、恒假 false、不确定 undefined
+ */
+function truth(value: Interval): boolean | undefined {
+  if (value.lo === 0n && value.hi === 0n) return false;
+  if (value.lo > 0n || value.hi < 0n) return true;
+  return undefined;
+}
+
+function compare(op: string, a: Interval, b: Interval): Interval {
+  switch (op) {
+    case '<': return a.hi < b.lo ? TRUE : a.lo >= b.hi ? FALSE : BOOL;
+    case '<=': return a.hi <= b.lo ? TRUE : a.lo > b.hi ? FALSE : BOOL;
+    case '>': return compare('<', b, a);
+    case '>=': return compare('<=', b, a);
+    case '==':
+      if (a.lo === a.hi && b.lo === b.hi && a.lo === b.lo) return TRUE;
+      return a.hi < b.lo || b.hi < a.lo ? FALSE : BOOL;
+    case '!=': {
+      const equal = compare('==', a, b);
+      return equal === TRUE ? FALSE : equal === FALSE ? TRUE : BOOL;
+    }
+  }
+  return BOOL;
+}
+
+function arithmetic(op: string, a: Interval, b: Interval): Interval {
+  switch (op) {
+    case '+': return { lo: saturate(a.lo + b.lo), hi: saturate(a.hi + b.hi) };
+    case '-': return { lo: saturate(a.lo - b.hi), hi: saturate(a.hi - b.lo) };
+    case '*': return corners(a, b, (x, y) => x * y);
+    case '/':
+      if (b.lo <= 0n && b.hi >= 0n) return TOP;
+      return corners(a, b, (x, y) => x / y);
+    case '%': {
+      if (b.lo <= 0n && b.hi >= 0n) return TOP;
+      const bound = (b.hi > -b.lo ? b.hi : -b.lo) - 1n;
+      if (a.lo >= 0n) return { lo: 0n, hi: a.hi < bound ? a.hi : bound };
+      return { lo: -bound, hi: bound };
+    }
+    case '<<':
+      if (a.lo === a.hi && b.lo === b.hi && b.lo >= 0n && b.lo <= 128n && a.lo > -INF && a.lo < INF) {
+        return { lo: saturate(a.lo << b.lo), hi: saturate(a.lo << b.lo) };
+      }
+      return TOP;
+    case '>>':
+      if (a.lo >= 0n && b.lo === b.hi && b.lo >= 0n && b.lo <= 128n) return { lo: a.lo >> b.lo, hi: a.hi >> b.lo };
+      return TOP;
+    case '&':
+      // 与非负掩码按位与，结果不超过掩码
+      if (b.lo === b.hi && b.lo >= 0n && b.lo < INF) return { lo: 0n, hi: b.lo };
+      if (a.lo === a.hi && a.lo >= 0n && a.lo < INF) return { lo: 0n, hi: a.lo };
+      return TOP;
+  }
+  return TOP;
+}
+
+function corners(a: Interval, b: Interval, f: (x: bigint, y: bigint) => bigint): Interval {
+  const values = [f(a.lo, b.lo), f(a.lo, b.hi), f(a.hi, b.lo), f(a.hi, b.hi)].map(saturate);
+  return { lo: values.reduce((x, y) => (y < x ? y : x)), hi: values.reduce((x, y) => (y > x ? y : x)) };
+}
+
+/**
+ * 按 x op bound 收紧 state[slot]；收紧为空时返回 null
+ */
+function restrict(state: State, slot: number, op: string, bound: Interval): State {
+  if (!state) return null;
+  let { lo, hi } = state[slot];
+  switch (op) {
+    case '<': if (bound.hi - 1n < hi) hi = bound.hi - 1n; break;
+    case '<=': if (bound.hi < hi) hi = bound.hi; break;
+    case '>': if (bound.lo + 1n > lo) lo = bound.lo + 1n; break;
+    case '>=': if (bound.lo > lo) lo = bound.lo; break;
+    case '==':
+      if (bound.lo > lo) lo = bound.lo;
+      if (bound.hi < hi) hi = bound.hi;
+      break;
+    case '!=':
+      if (bound.lo === bound.hi) {
+        if (lo === bound.lo) lo++;
+        if (hi === bound.lo) hi--;
+      }
+      break;
+  }
+  if (lo > hi) return null;
+  state[slot] = { lo, hi };
+  return state;
+}
+
+function joinState(a: State, b: State): State {
+  if (!a) return b ? b.slice() : null;
+  if (!b) return a.slice();
+  return a.map((value, i) => hull(value, b[i]));
+}
+
+function sameState(a: State, b: State): boolean {
+  if (!a || !b) return a === b;
+  return a.every((value, i) => value.lo === b[i].lo && value.hi === b[i].hi);
+}
+
+/**
+ * 加宽：比上次更松的界直接放到无穷
+ */
+function widen(previous: Interval[], next: Interval[]): Interval[] {
+  return previous.map((old, i) => ({
+    lo: next[i].lo < old.lo ? -INF : old.lo,
+    hi: next[i].hi > old.hi ? INF : old.hi
+  }));
+}
+
+/**
+ * 收窄：只收回加宽引入的无穷界
+ */
+function narrow(previous: Interval[], next: Interval[]): Interval[] {
+  return previous.map((old, i) => ({
+    lo: old.lo === -INF ? next[i].lo : old.lo,
+    hi: old.hi === INF ? next[i].hi : old.hi
+  }));
+}
@@ -0,0 +1,215 @@
+// 路径敏感的空指针检查：沿 CFG 枚举 (块, 指针空值状态) 对，分支边按 if (p) / p == NULL 等条件过滤不可行路径；
+// 相同的 (块, 状态) 只展开一次，展开总数受预算限制，超出时不给结论（由调用方退回路径不敏感的结果）
+
+import { ASTNode } from '../core/ast_parser';
+import { FunctionFlow, LocalVariable, FlowEvent } from './variable_flow';
+import { named, operatorOf, unparen } from './syntax';
+
+/** 每个函数最多展开的 (块, 状态) 对数 */
+export const DEFAULT_NULL_PATH_BUDGET = 10000;
+
+// 指针取值的位集合
+const NULL = 1;
+const NONNULL = 2;
+const EITHER = NULL | NONNULL;
+
+const NULL_TEXT = new Set(['NULL', 'nullptr', '0', '0L', '((void *)0)', '((void*)0)']);
+
+export interface NullPathFinding {
+  variable: LocalVariable;
+  node: ASTNode;
+}
+
+export class NullPathAnalysis {
+  /** 在预算内走完全部 (块, 状态) 对 */
+  readonly complete: boolean;
+  /** 展开过的不同 (块, 状态) 对数 */
+  readonly states: number;
+  readonly findings: NullPathFinding[] = [];
+  private readonly slotOf: Int32Array;
+  private readonly pointers: LocalVariable[] = [];
+  // 每个解引用事件在各条路径上见到的取值
+  private readonly observed: Uint8Array[];
+
+  constructor(readonly flow: FunctionFlow, readonly budget: number = DEFAULT_NULL_PATH_BUDGET) {
+    const cfg = flow.cfg;
+    this.slotOf = new Int32Array(flow.variables.length).fill(-1);
+    for (const variable of flow.variables) {
+      if (!variable.tracked || !variable.isPointer) continue;
+      this.slotOf[variable.id] = this.pointers.length;
+      this.pointers.push(variable);
+    }
+    this.observed = cfg.items.map((_, block) => new Uint8Array(flow.eventsOf(block).length));
+    if (!cfg.complete || this.pointers.length === 0) {
+      this.complete = cfg.complete;
+      this.states = 0;
+      return;
+    }
+    const visited = new Set<string>();
+    const work: Array<[number, Uint8Array]> = [[cfg.entry, new Uint8Array(this.pointers.length).fill(EITHER)]];
+    let complete = true;
+    while (work.length > 0) {
+      const [block, input] = work.pop()!;
+      const key = `${block}:${String.fromCharCode(...input)}`;
+      if (visited.has(key)) continue;
+      if (visited.size >= budget) {
+        complete = false;
+        break;
+      }
+      visited.add(key);
+      const state = this.transfer(block, input);
+      const branch = cfg.branches.get(block);
+      for (const succ of cfg.successors(block)) {
+        let next: Uint8Array | null = state;
+        if (branch && branch.whenTrue !== branch.whenFalse) {
+          if (succ === branch.whenTrue) next = this.refine(state, branch.condition, true);
+          else if (succ === branch.whenFalse) next = this.refine(state, branch.condition, false);
+        }
+        if (next) work.push([succ, next]);
+      }
+    }
+    this.complete = complete;
+    this.states = visited.size;
+    if (complete) this.collectFindings();
+  }
+
+  /**
+   * 解引用时指针在每条可行路径上都是 NULL
+   */
+  private collectFindings(): void {
+    const reported = new Set<string>();
+    this.flow.cfg.items.forEach((_, block) => {
+      this.flow.eventsOf(block).forEach((event, i) => {
+        if (this.observed[block][i] !== NULL) return;
+        const key = `${event.variable}:${event.node.startPosition.row}`;
+        if (reported.has(key)) return;
+        reported.add(key);
+        this.findings.push({ variable: this.flow.variables[event.variable], node: event.node });
+      });
+    });
+  }
+
+  private transfer(block: number, input: Uint8Array): Uint8Array {
+    const state = input.slice();
+    this.flow.eventsOf(block).forEach((event, i) => {
+      const slot = this.slotOf[event.variable];
+      if (slot < 0) return;
+      let value: number;
+      switch (event.kind) {
+        case 'deref': {
+          // 条件求值的解引用先按所在 && / || / ?: 的前置条件过滤
+          const guarded = event.conditional ? this.guard(state, event.node) : state;
+          if (guarded) this.observed[block][i] |= guarded[slot];
+          return;
+        }
+        case 'declare':
+        case 'address':
+          value = EITHER;
+          break;
+        case 'define':
+          value = this.definedValue(event, state);
+          break;
+        default:
+          return;
+      }
+      state[slot] = event.conditional ? state[slot] | value : value;
+    });
+    return state;
+  }
+
+  private definedValue(event: FlowEvent, state: Uint8Array): number {
+    if (event.value === 'null') return NULL;
+    if (event.value === 'copy' && event.source !== undefined) {
+      const source = this.slotOf[event.source];
+      return source >= 0 ? state[source] : EITHER;
+    }
+    return NONNULL;
+  }
+
+  /**
+   * 从解引用节点向外找 && / || / ?:，按其前置条件细化；前置条件在当前状态下不可能成立时返回 null
+   */
+  private guard(state: Uint8Array, node: ASTNode): Uint8Array | null {
+    let result: Uint8Array | null = state;
+    for (let inner = node, outer = node.parent; result && outer; inner = outer, outer = outer.parent) {
+      if (outer.type.endsWith('_statement') || outer.type === 'declaration') break;
+      const parts = named(outer);
+      if (outer.type === 'binary_expression' && parts.length === 2 && contains(parts[1], inner)) {
+        const op = operatorOf(outer);
+        if (op === '&&') result = this.refine(result, parts[0], true);
+        else if (op === '||') result = this.refine(result, parts[0], false);
+      } else if (outer.type === 'conditional_expression' && parts.length === 3) {
+        if (contains(parts[1], inner)) result = this.refine(result, parts[0], true);
+        else if (contains(parts[2], inner)) result = this.refine(result, parts[0], false);
+      }
+    }
+    return result;
+  }
+
+  /**
+   * 假定条件取值为 expected 时的状态（不修改输入）；该取值不可能时返回 null
+   */
+  private refine(state: Uint8Array, condition: ASTNode, expected: boolean): Uint8Array | null {
+    const expr = unparen(condition);
+    if (expr.type === 'unary_expression' && operatorOf(expr) === '!') {
+      const operand = named(expr)[0];
+      return operand ? this.refine(state, operand, !expected) : state;
+    }
+    if (expr.type === 'binary_expression') {
+      const [left, right] = named(expr);
+      const op = operatorOf(expr);
+      if (left && right && (op === '&&' || op === '||')) {
+        if ((op === '&&') === expected) {
+          const first = this.refine(state, left, expected);
+          return first && this.refine(first, right, expected);
+        }
+        const whenLeft = this.refine(state, left, expected);
+        const afterLeft = this.refine(state, left, !expected);
+        return join(whenLeft, afterLeft && this.refine(afterLeft, right, expected));
+      }
+      if (left && right && (op === '==' || op === '!=')) {
+        const slot = isNullConstant(right) ? this.slotOfOperand(left) : isNullConstant(left) ? this.slotOfOperand(right) : -1;
+        if (slot >= 0) return restrict(state, slot, (op === '==') === expected ? NULL : NONNULL);
+      }
+      return state;
+    }
+    const slot = this.slotOfOperand(expr);
+    return slot >= 0 ? restrict(state, slot, expected ? NONNULL : NULL) : state;
+  }
+
+  /**
+   * 条件中被判空的指针：p 本身，或 (p = expr) 的赋值目标
+   */
+  private slotOfOperand(node: ASTNode): number {
+    let expr = unparen(node);
+    if (expr.type === 'assignment_expression' && operatorOf(expr) === '=') expr = unparen(named(expr)[0]);
+    const variable = expr.type === 'identifier' ? this.flow.resolve(expr) : undefined;
+    return variable ? this.slotOf[variable.id] : -1;
+  }
+}
+
+function isNullConstant(node: ASTNode): boolean {
+  const expr = unparen(node);
+  return expr.type === 'null' || NULL_TEXT.has(expr.text.replace(/\s+/g, ''));
+}
+
+function contains(outer: ASTNode, inner: ASTNode): boolean {
+  const { startPosition: a, endPosition: b } = outer;
+  const { startPosition: c, endPosition: d } = inner;
+  return (a.row < c.row || (a.row === c.row && a.column <= c.column)) && (d.row < b.row || (d.row === b.row && d.column <= b.column));
+}
+
+function restrict(state: Uint8Array, slot: number, mask: number): Uint8Array | null {
+  const value = state[slot] & mask;
+  if (value === 0) return null;
+  if (value === state[slot]) return state;
+  const next = state.slice();
+  next[slot] = value;
+  return next;
+}
+
+function join(a: Uint8Array | null, b: Uint8Array | null): Uint8Array | null {
+  if (!a) return b;
+  if (!b) return a;
+  return a.map((value, i) => value | b[i]);
+}
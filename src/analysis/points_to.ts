@@ -0,0 +1,451 @@
+// Steensgaard 式指向分析：把指针赋值看作等价约束，用并查集把可能指向同一位置的指针合并为一个别名类，
+// 近线性时间、流不敏感、域不敏感；可只分析单个函数，也可跨函数（实参/形参、返回值按调用绑定）
+
+import { ASTNode } from '../core/ast_parser';
+import { FunctionFlow, LocalVariable } from './variable_flow';
+import { functionName } from './cfg';
+import { named, operatorOf, hasToken, unwrapDeclarator } from './syntax';
+
+const ALLOCATION_FUNCTIONS = new Set(['malloc', 'calloc', 'realloc', 'strdup', 'strndup']);
+const FREE_FUNCTIONS = new Set(['free', 'cfree']);
+const NULL_TEXT = new Set(['NULL', 'nullptr']);
+// 只读写实参所指内容、不保存指针本身的库函数，实参不算逃逸
+const NON_CAPTURING_FUNCTIONS = new Set([
+  'printf', 'fprintf', 'sprintf', 'snprintf', 'scanf', 'fscanf', 'sscanf', 'puts', 'fputs', 'fgets', 'fread', 'fwrite',
+  'strcpy', 'strncpy', 'strcat', 'strncat', 'strcmp', 'strncmp', 'strlen', 'memcpy', 'memmove', 'memset', 'memcmp',
+  'atoi', 'atol', 'atof', 'strtol', 'strtoul', 'strtod'
+]);
+
+/**
+ * 参与分析的一个函数
+ */
+export interface PointsToUnit {
+  file: string;
+  flow: FunctionFlow;
+}
+
+/**
+ * 在某文件中按名字解析被调函数；返回 undefined 表示外部函数（实参视为逃逸）
+ */
+export type UnitResolver = (name: string, file: string) => PointsToUnit | undefined;
+
+/**
+ * 分配点：分配函数的一次调用，以及接收其结果的局部变量（若有）
+ */
+export interface AllocationSite {
+  unit: PointsToUnit;
+  call: ASTNode;
+  variable?: LocalVariable;
+  node: number;
+}
+
+export class PointsTo {
+  private readonly parent: number[] = [];
+  private readonly rank: number[] = [];
+  // 类代表元 -> 该类中指针所指向的位置类（-1 表示尚未指向任何位置）
+  private readonly pointee: number[] = [];
+  // 按节点（非类代表元）记录：作为左值被写入的次数、是否被取过地址
+  private readonly definitions: number[] = [];
+  private readonly addressTaken: boolean[] = [];
+  private readonly variableBase = new Map<FunctionFlow, number>();
+  private readonly returns = new Map<FunctionFlow, number>();
+  private readonly globals = new Map<string, number>();
+  private readonly called = new Set<FunctionFlow>();
+  private readonly freed: number[] = [];
+  private readonly escaped: number[] = [];
+  readonly allocations: AllocationSite[] = [];
+
+  constructor(private readonly units: PointsToUnit[], private readonly resolveUnit?: UnitResolver) {
+    for (const unit of units) {
+      this.variableBase.set(unit.flow, this.parent.length);
+      for (const variable of unit.flow.variables) {
+        const node = this.fresh();
+        if (variable.isParameter) this.definitions[node] = 1;
+      }
+      this.returns.set(unit.flow, this.fresh());
+    }
+    for (const unit of units) this.walk(unit.flow.functionNode, unit);
+  }
+
+  /**
+   * 与 variable 指向同一别名类的同函数变量（不含自身）
+   */
+  aliases(flow: FunctionFlow, variable: LocalVariable): LocalVariable[] {
+    const target = this.targetOf(flow, variable);
+    if (target < 0) return [];
+    return flow.variables.filter(other => other !== variable && this.targetOf(flow, other) === target);
+  }
+
+  /**
+   * aliases 中只被定义一次且从未被取地址的变量：与 variable 的别名关系在定义后一直成立，
+   * 可以按程序点直接套用（流不敏感的合并对被重新赋值的变量不成立，如链表遍历中的 p = p->next）
+   */
+  stableAliases(flow: FunctionFlow, variable: LocalVariable): LocalVariable[] {
+    if (!this.isStable(flow, variable)) return [];
+    // 递归结构（链表、树）在域不敏感下各节点合并成同一类，类内指针并不指向同一对象
+    const target = this.targetOf(flow, variable);
+    if (target < 0 || this.isRecursive(target)) return [];
+    return this.aliases(flow, variable).filter(other => this.isStable(flow, other));
+  }
+
+  private isRecursive(root: number): boolean {
+    const seen = new Set<number>();
+    for (let next = this.pointee[root]; next >= 0; next = this.pointee[next]) {
+      next = this.find(next);
+      if (next === root) return true;
+      if (seen.has(next)) return false;
+      seen.add(next);
+    }
+    return false;
+  }
+
+  private isStable(flow: FunctionFlow, variable: LocalVariable): boolean {
+    const node = this.variableNode(flow, variable);
+    return this.definitions[node] === 1 && !this.addressTaken[node];
+  }
+
+  /**
+   * 既未被释放、也不能从逃逸位置（全局变量、外部调用的实参、对外的形参与返回值）到达的分配点；
+   * 同一函数中同一变量只给出第一个分配点
+   */
+  leakedAllocations(): AllocationSite[] {
+    const freed = new Set(this.freed.map(node => this.find(node)));
+    const reachable = new Set<number>();
+    const stack = this.escaped.slice();
+    for (const node of this.globals.values()) stack.push(node);
+    for (const unit of this.units) {
+      // 被分析范围内的调用者已绑定形参与返回值，只有入口函数的接口才视为逃逸
+      if (this.called.has(unit.flow)) continue;
+      stack.push(this.returns.get(unit.flow)!);
+      for (const variable of unit.flow.variables) {
+        if (variable.isParameter) stack.push(this.variableNode(unit.flow, variable));
+      }
+    }
+    while (stack.length > 0) {
+      const root = this.find(stack.pop()!);
+      if (reachable.has(root)) continue;
+      reachable.add(root);
+      if (this.pointee[root] >= 0) stack.push(this.pointee[root]);
+    }
+
+    const result: AllocationSite[] = [];
+    const reported = new Set<LocalVariable>();
+    for (const site of this.allocations) {
+      const root = this.find(site.node);
+      if (!site.variable || reported.has(site.variable) || freed.has(root) || reachable.has(root)) continue;
+      reported.add(site.variable);
+      result.push(site);
+    }
+    return result;
+  }
+
+  private targetOf(flow: FunctionFlow, variable: LocalVariable): number {
+    const target = this.pointee[this.find(this.variableNode(flow, variable))];
+    return target >= 0 ? this.find(target) : -1;
+  }
+
+  private fresh(): number {
+    const id = this.parent.length;
+    this.parent.push(id);
+    this.rank.push(0);
+    this.pointee.push(-1);
+    this.definitions.push(0);
+    this.addressTaken.push(false);
+    return id;
+  }
+
+  private find(node: number): number {
+    while (this.parent[node] !== node) {
+      this.parent[node] = this.parent[this.parent[node]];
+      node = this.parent[node];
+    }
+    return node;
+  }
+
+  /**
+   * 合并两个类；两者都有指向目标时递归合并目标（Steensgaard 的"联合"规则）
+   */
+  private union(a: number, b: number): void {
+    const pending: number[] = [a, b];
+    while (pending.length > 0) {
+      let x = this.find(pending.pop()!);
+      let y = this.find(pending.pop()!);
+      if (x === y) continue;
+      if (this.rank[x] < this.rank[y]) [x, y] = [y, x];
+      this.parent[y] = x;
+      if (this.rank[x] === this.rank[y]) this.rank[x]++;
+      const px = this.pointee[x];
+      const py = this.pointee[y];
+      if (px < 0) this.pointee[x] = py;
+      else if (py >= 0) pending.push(px, py);
+    }
+  }
+
+  /**
+   * 位置类所指向的类，没有时新建
+   */
+  private deref(node: number): number {
+    const root = this.find(node);
+    if (this.pointee[root] < 0) this.pointee[root] = this.fresh();
+    return this.pointee[root];
+  }
+
+  /**
+   * 把值 value 存入位置 location：location 的指向目标与 value 合并
+   */
+  private store(location: number, value: number): void {
+    if (location < 0) return;
+    this.definitions[location]++;
+    if (value >= 0) this.union(this.deref(location), value);
+  }
+
+  private variableNode(flow: FunctionFlow, variable: LocalVariable): number {
+    return this.variableBase.get(flow)! + variable.id;
+  }
+
+  private globalNode(name: string): number {
+    let node = this.globals.get(name);
+    if (node === undefined) {
+      node = this.fresh();
+      this.globals.set(name, node);
+    }
+    return node;
+  }
+
+  /**
+   * 语句级遍历：声明与 return 单独处理，表达式交给 value 求值
+   */
+  private walk(node: ASTNode, unit: PointsToUnit): void {
+    switch (node.type) {
+      case 'declaration':
+        for (const child of named(node)) {
+          if (child.type !== 'init_declarator') continue;
+          const parts = named(child);
+          const init = parts[parts.length - 1];
+          const info = unwrapDeclarator(child);
+          const variable = info ? unit.flow.resolve(info.name) : undefined;
+          if (!init || parts.length < 2) continue;
+          const location = variable ? this.variableNode(unit.flow, variable) : (info ? this.globalNode(info.name.text) : -1);
+          this.initialize(location, init, unit);
+        }
+        return;
+      case 'return_statement': {
+        const value = named(node)[0];
+        if (value) this.store(this.returns.get(unit.flow)!, this.value(value, unit));
+        return;
+      }
+    }
+    if (node.type.endsWith('_expression')) {
+      this.value(node, unit);
+      return;
+    }
+    for (const child of named(node)) this.walk(child, unit);
+  }
+
+  private initialize(location: number, init: ASTNode, unit: PointsToUnit): void {
+    if (init.type === 'initializer_list') {
+      // 域不敏感：聚合初始化的每个元素都存入同一位置
+      for (const element of named(init)) this.initialize(location, element, unit);
+    } else if (init.type === 'initializer_pair') {
+      const parts = named(init);
+      const value = parts[parts.length - 1];
+      if (value) this.initialize(location, value, unit);
+    } else {
+      this.store(location, this.value(init, unit));
+    }
+  }
+
+  /**
+   * 表达式的指针值所在的类（-1 表示不是已知的指针值），顺带处理子表达式中的赋值与调用
+   */
+  private value(node: ASTNode, unit: PointsToUnit): number {
+    switch (node.type) {
+      case 'identifier': {
+        const variable = unit.flow.resolve(node);
+        if (variable) {
+          const location = this.variableNode(unit.flow, variable);
+          // 数组名退化为指向自身存储的指针
+          return variable.isArray ? location : this.deref(location);
+        }
+        return NULL_TEXT.has(node.text) ? -1 : this.deref(this.globalNode(node.text));
+      }
+      case 'parenthesized_expression':
+      case 'cast_expression': {
+        const parts = named(node);
+        return parts.length > 0 ? this.value(parts[parts.length - 1], unit) : -1;
+      }
+      case 'pointer_expression': {
+        const operand = named(node)[0];
+        if (!operand) return -1;
+        if (operatorOf(node) === '&') {
+          const location = this.location(operand, unit);
+          if (location >= 0) this.addressTaken[location] = true;
+          return location;
+        }
+        const target = this.value(operand, unit);
+        return target < 0 ? -1 : this.deref(target);
+      }
+      case 'field_expression':
+      case 'subscript_expression': {
+        const location = this.location(node, unit);
+        return location < 0 ? -1 : this.deref(location);
+      }
+      case 'assignment_expression': {
+        const parts = named(node);
+        const left = parts[0];
+        const right = parts[parts.length - 1];
+        if (!left || !right) return -1;
+        const value = this.value(right, unit);
+        const location = this.location(left, unit);
+        if (operatorOf(node) === '=') {
+          this.store(location, value);
+          return value;
+        }
+        if (location < 0) return -1;
+        this.definitions[location]++;
+        return this.deref(location);
+      }
+      case 'call_expression':
+        return this.call(node, unit);
+      case 'conditional_expression': {
+        const [condition, ...branches] = named(node);
+        if (condition) this.value(condition, unit);
+        let result = -1;
+        for (const branch of branches) {
+          const value = this.value(branch, unit);
+          if (value < 0) continue;
+          if (result < 0) result = value;
+          else this.union(result, value);
+        }
+        return result;
+      }
+      case 'binary_expression': {
+        // 指针算术仍指向同一对象
+        const [left, right] = named(node);
+        const a = left ? this.value(left, unit) : -1;
+        const b = right ? this.value(right, unit) : -1;
+        const op = operatorOf(node);
+        if (op === '+') return a >= 0 ? a : b;
+        return op === '-' ? a : -1;
+      }
+      case 'update_expression': {
+        const operand = named(node)[0];
+        if (!operand) return -1;
+        const location = this.location(operand, unit);
+        if (location < 0) return -1;
+        this.definitions[location]++;
+        return this.deref(location);
+      }
+      case 'comma_expression': {
+        let result = -1;
+        for (const part of named(node)) result = this.value(part, unit);
+        return result;
+      }
+      case 'sizeof_expression':
+        return -1;
+    }
+    for (const child of named(node)) this.value(child, unit);
+    return -1;
+  }
+
+  /**
+   * 左值表达式所代表的存储位置类
+   */
+  private location(node: ASTNode, unit: PointsToUnit): number {
+    switch (node.type) {
+      case 'identifier': {
+        const variable = unit.flow.resolve(node);
+        return variable ? this.variableNode(unit.flow, variable) : this.globalNode(node.text);
+      }
+      case 'parenthesized_expression': {
+        const inner = named(node)[0];
+        return inner ? this.location(inner, unit) : -1;
+      }
+      case 'pointer_expression': {
+        const operand = named(node)[0];
+        return operand && operatorOf(node) === '*' ? this.value(operand, unit) : -1;
+      }
+      case 'field_expression': {
+        // 域不敏感：成员与所在对象是同一位置
+        const object = named(node)[0];
+        if (!object) return -1;
+        return hasToken(node, '->') ? this.value(object, unit) : this.location(object, unit);
+      }
+      case 'subscript_expression': {
+        const [array, index] = named(node);
+        if (index) this.value(index, unit);
+        return array ? this.value(array, unit) : -1;
+      }
+    }
+    this.value(node, unit);
+    return -1;
+  }
+
+  private call(node: ASTNode, unit: PointsToUnit): number {
+    const [callee, args] = named(node);
+    const values = (args ? named(args) : []).map(arg => this.value(arg, unit));
+    const name = callee && callee.type === 'identifier' ? callee.text : undefined;
+    if (!name) {
+      if (callee) this.value(callee, unit);
+      for (const value of values) if (value >= 0) this.escaped.push(value);
+      return -1;
+    }
+    if (FREE_FUNCTIONS.has(name)) {
+      if (values[0] >= 0) this.freed.push(values[0]);
+      return -1;
+    }
+    if (ALLOCATION_FUNCTIONS.has(name)) {
+      const site = this.fresh();
+      this.allocations.push({ unit, call: node, variable: this.receiver(node, unit), node: site });
+      return site;
+    }
+    const target = this.resolveUnit ? this.resolveUnit(name, unit.file) : undefined;
+    if (!target) {
+      if (!NON_CAPTURING_FUNCTIONS.has(name)) {
+        for (const value of values) if (value >= 0) this.escaped.push(value);
+      }
+      return -1;
+    }
+    this.called.add(target.flow);
+    const parameters = target.flow.variables.filter(variable => variable.isParameter);
+    values.forEach((value, i) => {
+      if (i < parameters.length) this.store(this.variableNode(target.flow, parameters[i]), value);
+      else if (value >= 0) this.escaped.push(value);
+    });
+    return this.deref(this.returns.get(target.flow)!);
+  }
+
+  /**
+   * 直接接收分配结果的局部变量：T *p = malloc(...) / p = malloc(...)
+   */
+  private receiver(call: ASTNode, unit: PointsToUnit): LocalVariable | undefined {
+    let current = call;
+    while (current.parent && (current.parent.type === 'parenthesized_expression' || current.parent.type === 'cast_expression')) {
+      current = current.parent;
+    }
+    const parent = current.parent;
+    if (!parent) return undefined;
+    if (parent.type === 'init_declarator') {
+      const info = unwrapDeclarator(parent);
+      return info ? unit.flow.resolve(info.name) : undefined;
+    }
+    if (parent.type === 'assignment_expression' && operatorOf(parent) === '=') {
+      const left = named(parent)[0];
+      return left && left.type === 'identifier' ? unit.flow.resolve(left) : undefined;
+    }
+    return undefined;
+  }
+}
+
+/**
+ * 文件内所有函数的指向分析：同文件内的调用按名字绑定实参与返回值
+ */
+export function buildFilePointsTo(file: string, flows: FunctionFlow[]): PointsTo {
+  const units = flows.map(flow => ({ file, flow }));
+  const byName = new Map<string, PointsToUnit>();
+  for (const unit of units) {
+    const name = functionName(unit.flow.functionNode);
+    if (name && !byName.has(name)) byName.set(name, unit);
+  }
+  return new PointsTo(units, name => byName.get(name));
+}
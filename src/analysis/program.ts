@@ -0,0 +1,171 @@
+// 全程序分析阶段：在所有被扫描文件的调用图上自底向上计算函数摘要，
+// 按强连通分量的逆拓扑序在主线程上逐个计算（摘要直接读写内存中的语法树，无法交给 worker 线程），
+// 分量内部迭代到摘要不再变化；
+// 提供摘要数据库时，只重算签名/函数体有变化的函数及其传递调用者
+
+import * as crypto from 'crypto';
+import { ASTNode } from '../core/ast_parser';
+import { AnalysisKey, AnalysisSession } from './session';
+import { CallGraph, ProgramUnit } from './call_graph';
+import { FunctionSummary, SummaryResult, summarizeFunction, sameFacts } from './summaries';
+import { SummaryDatabase } from './summary_db';
+import { PointsTo, PointsToUnit } from './points_to';
+import { named } from './syntax';
+import { tracing, traceStart, traceSpan } from '../utils/trace';
+
+// 递归分量的迭代上限；摘要各项单调增长，正常情况下远小于该值即收敛
+const MAX_SCC_ITERATIONS = 16;
+
+export class ProgramAnalysis {
+  readonly callGraph: CallGraph;
+  private readonly results: Array<SummaryResult | undefined>;
+  private readonly sessions = new Map<string, AnalysisSession>();
+  private signatures: string[] = [];
+  private hashes: string[] = [];
+  // 需要重新计算的函数（无数据库时全部需要）
+  private stale: Uint8Array;
+  private aliasing?: PointsTo;
+  private done = false;
+  /** 本次复用/重新计算的函数个数 */
+  reused = 0;
+  recomputed = 0;
+
+  constructor(units: ProgramUnit[], private readonly database?: SummaryDatabase) {
+    for (const unit of units) this.sessions.set(unit.file, AnalysisSession.for(unit.root, unit.lines));
+    this.callGraph = new CallGraph(units);
+    this.results = new Array(this.callGraph.nodes.length);
+    this.stale = new Uint8Array(this.callGraph.nodes.length).fill(1);
+    if (database) this.markStale(database);
+  }
+
+  /**
+   * 自底向上计算全部摘要：被调分量总在调用者之前
+   */
+  summarizeAll(): this {
+    if (this.done) return this;
+    for (const component of this.callGraph.sccs()) {
+      const start = traceStart();
+      const reused = this.reused;
+      this.summarizeComponent(component);
+      if (tracing.enabled) {
+        const names = component.map(id => this.callGraph.nodes[id].name);
+        traceSpan(names[0], 'summary', start, { functions: names, reused: this.reused > reused });
+      }
+    }
+    this.finish();
+    return this;
+  }
+
+  /**
+   * 某个函数定义的摘要结果（含直接返回点与调用点）
+   */
+  resultOf(fn: ASTNode): SummaryResult | undefined {
+    const node = this.callGraph.nodeOf(fn);
+    return node ? this.results[node.id] : undefined;
+  }
+
+  /**
+   * 在 file 中调用 name 时使用的摘要；库函数与未扫描到的函数返回 undefined
+   */
+  summaryOf(name: string, file: string): FunctionSummary | undefined {
+    const node = this.callGraph.resolve(name, file);
+    return node ? this.results[node.id]?.summary : undefined;
+  }
+
+  /**
+   * 全程序指向分析：跨文件调用按调用图绑定实参与返回值，首次请求时构建
+   */
+  pointsTo(): PointsTo {
+    if (!this.aliasing) {
+      const units: PointsToUnit[] = this.callGraph.nodes.map(node => ({ file: node.file, flow: this.sessions.get(node.file)!.flow(node.node) }));
+      this.aliasing = new PointsTo(units, (name, file) => {
+        const target = this.callGraph.resolve(name, file);
+        return target ? units[target.id] : undefined;
+      });
+    }
+    return this.aliasing;
+  }
+
+  /**
+   * 签名或函数体哈希与数据库不一致的函数，连同其全部传递调用者标记为待重算
+   */
+  private markStale(database: SummaryDatabase): void {
+    const nodes = this.callGraph.nodes;
+    this.stale.fill(0);
+    const queue: number[] = [];
+    for (const node of nodes) {
+      // 签名：函数体之外的部分（存储类、返回类型、声明器）
+      const header = named(node.node).filter(child => child.type !== 'compound_statement').map(child => child.text).join(' ');
+      this.signatures[node.id] = header.replace(/\s+/g, ' ').trim();
+      // 被调函数的解析结果也计入哈希：同名函数换了定义位置（如新增 static 版本）时需重算
+      const callees = Array.from(this.callGraph.callees(node.id), id => SummaryDatabase.keyOf(nodes[id].file, nodes[id].name));
+      this.hashes[node.id] = crypto.createHash('sha1').update(node.node.text).update('\0').update(callees.join('\n')).digest('hex');
+      if (!database.matches(SummaryDatabase.keyOf(node.file, node.name), this.signatures[node.id], this.hashes[node.id])) {
+        this.stale[node.id] = 1;
+        queue.push(node.id);
+      }
+    }
+    while (queue.length > 0) {
+      const id = queue.pop()!;
+      for (const caller of this.callGraph.callers(id)) {
+        if (!this.stale[caller]) {
+          this.stale[caller] = 1;
+          queue.push(caller);
+        }
+      }
+    }
+  }
+
+  /**
+   * 全部计算完成后把结果写回数据库（内存中），由调用方决定何时保存
+   */
+  private finish(): void {
+    this.done = true;
+    if (!this.database) return;
+    const liveKeys = new Set<string>();
+    for (const node of this.callGraph.nodes) {
+      const key = SummaryDatabase.keyOf(node.file, node.name);
+      liveKeys.add(key);
+      const result = this.results[node.id];
+      if (!result || !this.stale[node.id]) continue;
+      const symbol = { name: node.name, file: node.file, line: node.node.startPosition.row + 1, isStatic: node.isStatic };
+      this.database.store(key, this.signatures[node.id], this.hashes[node.id], symbol, result, node.node.startPosition.row);
+    }
+    this.database.retain(new Set(this.sessions.keys()), liveKeys);
+  }
+
+  private summarizeComponent(component: number[]): void {
+    const nodes = component.map(id => this.callGraph.nodes[id]);
+    if (this.database && nodes.every(node => !this.stale[node.id])) {
+      for (const node of nodes) {
+        this.results[node.id] = this.database.lookup(SummaryDatabase.keyOf(node.file, node.name),
+          this.signatures[node.id], this.hashes[node.id], node.node.startPosition.row);
+      }
+      this.reused += nodes.length;
+      return;
+    }
+    this.recomputed += nodes.length;
+    // 自递归或互递归时从"无副作用"的初值出发迭代
+    const recursive = nodes.length > 1 || nodes.some(node => this.callGraph.callees(node.id).includes(node.id));
+    for (let iteration = 0; iteration < MAX_SCC_ITERATIONS; iteration++) {
+      let changed = false;
+      for (const node of nodes) {
+        const session = this.sessions.get(node.file)!;
+        // 别名只取函数内的，保证摘要只依赖函数自身与被调函数摘要（摘要数据库据此判定是否需要重算）
+        const result = summarizeFunction(session.flow(node.node), callee => this.summaryOf(callee, node.file), session.pointsTo(node.node));
+        const previous = this.results[node.id];
+        if (!previous || !sameFacts(previous.summary, result.summary)) changed = true;
+        this.results[node.id] = result;
+      }
+      if (!recursive || !changed) return;
+    }
+  }
+}
+
+/**
+ * 单个文件自成一个程序时的摘要（上下文未提供全程序分析时使用）
+ */
+export const PROGRAM: AnalysisKey<ProgramAnalysis> = {
+  name: 'program',
+  compute: session => new ProgramAnalysis([{ file: '', root: session.root, lines: session.lines }]).summarizeAll()
+};
@@ -0,0 +1,228 @@
+// 文件级分析会话：以 AST 根节点为键，按需计算并缓存各检测器共用的派生事实
+// （符号、调用、include、声明类型、函数列表、各函数的 CFG、变量数据流、指向关系、整数区间与路径敏感空值），
+// 每项事实每个文件只计算一次，并随会话一起失效
+
+import { ASTNode, CASTParser, VariableDeclaration, FunctionCall, IncludeDirective } from '../core/ast_parser';
+import { ControlFlowGraph, buildCFG, positionKey } from './cfg';
+import { FunctionFlow } from './variable_flow';
+import { TypeTable } from './type_table';
+import { PointsTo, buildFilePointsTo } from './points_to';
+import { IntervalAnalysis } from './intervals';
+import { NullPathAnalysis, DEFAULT_NULL_PATH_BUDGET } from './null_paths';
+import { DataModel, DEFAULT_DATA_MODEL } from '../utils/c_types';
+import { tracing, traceStart, traceSpan } from '../utils/trace';
+
+/**
+ * 具名分析：首次 get 时以会话为输入计算，结果在会话内缓存
+ */
+export interface AnalysisKey<T> {
+  readonly name: string;
+  compute(session: AnalysisSession): T;
+}
+
+// extract* 系列方法只遍历传入的语法树，不需要真正的解析后端
+let extractor: CASTParser | null = null;
+function astExtractor(): CASTParser {
+  if (!extractor) {
+    extractor = new CASTParser({ parse() { throw new Error('分析会话不负责解析源码'); } });
+  }
+  return extractor;
+}
+
+export const SYMBOLS: AnalysisKey<VariableDeclaration[]> = {
+  name: 'symbols',
+  compute: session => astExtractor().extractVariableDeclarations(session.root, session.lines)
+};
+
+export const CALLS: AnalysisKey<FunctionCall[]> = {
+  name: 'calls',
+  compute: session => astExtractor().extractFunctionCalls(session.root)
+};
+
+export const INCLUDES: AnalysisKey<IncludeDirective[]> = {
+  name: 'includes',
+  compute: session => astExtractor().extractIncludeDirectives(session.root)
+};
+
+export const TYPES: AnalysisKey<TypeTable> = {
+  name: 'types',
+  compute: session => new TypeTable(session.root)
+};
+
+/**
+ * 文件内全部函数的指向分析（同文件内调用按名字绑定）
+ */
+export const POINTS_TO: AnalysisKey<PointsTo> = {
+  name: 'points-to',
+  compute: session => buildFilePointsTo('', session.functions().map(fn => session.flow(fn)))
+};
+
+export class AnalysisSession {
+  private static readonly sessions = new WeakMap<object, AnalysisSession>();
+
+  private readonly results = new Map<AnalysisKey<unknown>, unknown>();
+  private functionNodes: ASTNode[] | null = null;
+  private functionsByPosition: Map<string, ASTNode> | null = null;
+  private readonly cfgs = new Map<ASTNode, ControlFlowGraph>();
+  private readonly flows = new Map<ASTNode, FunctionFlow>();
+  private readonly aliasing = new Map<ASTNode, PointsTo>();
+  private readonly ranges = new Map<string, Map<ASTNode, IntervalAnalysis>>();
+  private readonly nullness = new Map<ASTNode, NullPathAnalysis>();
+  private sourceLines: string[] | undefined;
+
+  private constructor(readonly root: ASTNode) {}
+
+  /**
+   * 获取（或创建）某棵语法树的分析会话；lines 为对应源码行，供需要原文的分析使用
+   */
+  static for(root: ASTNode, lines?: string[]): AnalysisSession {
+    let session = AnalysisSession.sessions.get(root);
+    if (!session) {
+      session = new AnalysisSession(root);
+      AnalysisSession.sessions.set(root, session);
+    }
+    if (lines && !session.sourceLines) session.sourceLines = lines;
+    return session;
+  }
+
+  /**
+   * 节点所在语法树的会话（沿 parent 链找到根）
+   */
+  static forNode(node: ASTNode): AnalysisSession {
+    let root = node;
+    while (root.parent) root = root.parent;
+    return AnalysisSession.for(root);
+  }
+
+  /**
+   * 源码行；未提供时由根节点文本切分
+   */
+  get lines(): string[] {
+    if (!this.sourceLines) this.sourceLines = this.root.text.split(/\r?\n/);
+    return this.sourceLines;
+  }
+
+  /**
+   * 取具名分析的结果，首次请求时计算
+   */
+  get<T>(key: AnalysisKey<T>): T {
+    if (this.results.has(key)) return this.results.get(key) as T;
+    const start = traceStart();
+    const value = key.compute(this);
+    if (tracing.enabled) traceSpan(key.name, 'cache', start, { miss: true });
+    this.results.set(key, value);
+    return value;
+  }
+
+  /**
+   * 丢弃全部缓存结果（语法树被原地修改后调用），下次请求时重新计算
+   */
+  invalidate(): void {
+    this.results.clear();
+    this.functionNodes = null;
+    this.functionsByPosition = null;
+    this.cfgs.clear();
+    this.flows.clear();
+    this.aliasing.clear();
+    this.ranges.clear();
+    this.nullness.clear();
+  }
+
+  /**
+   * 文件中的全部函数定义（按源码顺序）
+   */
+  functions(): ASTNode[] {
+    if (this.functionNodes) return this.functionNodes;
+    const result: ASTNode[] = [];
+    const stack: ASTNode[] = [this.root];
+    while (stack.length > 0) {
+      const node = stack.pop()!;
+      if (node.type === 'function_definition') {
+        result.push(node);
+        continue;
+      }
+      for (let i = node.children.length - 1; i >= 0; i--) stack.push(node.children[i]);
+    }
+    this.functionNodes = result;
+    return result;
+  }
+
+  /**
+   * 包含该节点的函数定义（按源码位置匹配，兼容同一棵树的不同节点副本）
+   */
+  enclosingFunction(node: ASTNode): ASTNode | undefined {
+    if (!this.functionsByPosition) {
+      this.functionsByPosition = new Map();
+      for (const fn of this.functions()) this.functionsByPosition.set(positionKey(fn), fn);
+    }
+    for (let current: ASTNode | undefined = node; current; current = current.parent) {
+      if (current.type === 'function_definition') return this.functionsByPosition.get(positionKey(current));
+    }
+    return undefined;
+  }
+
+  /**
+   * 函数的控制流图，首次请求时构建
+   */
+  cfg(fn: ASTNode): ControlFlowGraph {
+    let graph = this.cfgs.get(fn);
+    if (!graph) {
+      graph = buildCFG(fn);
+      this.cfgs.set(fn, graph);
+    }
+    return graph;
+  }
+
+  /**
+   * 函数的变量数据流分析，复用会话中的 CFG
+   */
+  flow(fn: ASTNode): FunctionFlow {
+    let result = this.flows.get(fn);
+    if (!result) {
+      result = new FunctionFlow(fn, this.cfg(fn));
+      this.flows.set(fn, result);
+    }
+    return result;
+  }
+
+  /**
+   * 只含单个函数的指向分析（不跨调用传播，结果只取决于函数自身）
+   */
+  pointsTo(fn: ASTNode): PointsTo {
+    let result = this.aliasing.get(fn);
+    if (!result) {
+      result = new PointsTo([{ file: '', flow: this.flow(fn) }]);
+      this.aliasing.set(fn, result);
+    }
+    return result;
+  }
+
+  /**
+   * 函数的整数区间分析（按数据模型分别缓存）
+   */
+  intervals(fn: ASTNode, model: DataModel = DEFAULT_DATA_MODEL): IntervalAnalysis {
+    let byFunction = this.ranges.get(model);
+    if (!byFunction) {
+      byFunction = new Map();
+      this.ranges.set(model, byFunction);
+    }
+    let result = byFunction.get(fn);
+    if (!result) {
+      result = new IntervalAnalysis(this.flow(fn), this.get(TYPES), model);
+      byFunction.set(fn, result);
+    }
+    return result;
+  }
+
+  /**
+   * 函数的路径敏感空指针检查；预算与缓存结果不同时重新计算
+   */
+  nullPaths(fn: ASTNode, budget: number = DEFAULT_NULL_PATH_BUDGET): NullPathAnalysis {
+    let result = this.nullness.get(fn);
+    if (!result || result.budget !== budget) {
+      result = new NullPathAnalysis(this.flow(fn), budget);
+      this.nullness.set(fn, result);
+    }
+    return result;
+  }
+}
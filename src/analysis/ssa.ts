@@ -0,0 +1,272 @@
+// 稀疏 SSA 形式：在函数 CFG 上用 Cooper–Harvey–Kennedy 迭代算法求直接支配者与支配边界，
+// 在定义块的迭代支配边界放置 φ，沿支配树重命名；值的定义信息与 def-use 链都保存在压缩数组中
+
+import { ControlFlowGraph } from './cfg';
+
+/**
+ * 支配树与支配边界（只含从入口可达的块）
+ */
+export class DominatorTree {
+  /** 直接支配者；入口为自身，不可达块为 -1 */
+  readonly idom: Int32Array;
+  private readonly childStart: Int32Array;
+  private readonly childList: Int32Array;
+  private readonly frontierStart: Int32Array;
+  private readonly frontierList: Int32Array;
+
+  constructor(readonly cfg: ControlFlowGraph) {
+    const count = cfg.blockCount;
+    const rpo = cfg.reversePostorder();
+    const position = new Int32Array(count).fill(-1);
+    rpo.forEach((block, i) => { position[block] = i; });
+
+    const idom = new Int32Array(count).fill(-1);
+    idom[cfg.entry] = cfg.entry;
+    const intersect = (a: number, b: number): number => {
+      while (a !== b) {
+        while (position[a] > position[b]) a = idom[a];
+        while (position[b] > position[a]) b = idom[b];
+      }
+      return a;
+    };
+    for (let changed = true; changed;) {
+      changed = false;
+      for (const block of rpo) {
+        if (block === cfg.entry) continue;
+        let next = -1;
+        for (const pred of cfg.predecessors(block)) {
+          if (idom[pred] < 0) continue;
+          next = next < 0 ? pred : intersect(pred, next);
+        }
+        if (next >= 0 && idom[block] !== next) {
+          idom[block] = next;
+          changed = true;
+        }
+      }
+    }
+    this.idom = idom;
+
+    // 支配树子节点（按逆后序，重命名时父块先于子块）
+    const children: number[][] = Array.from({ length: count }, () => []);
+    for (const block of rpo) {
+      if (block !== cfg.entry) children[idom[block]].push(block);
+    }
+    [this.childStart, this.childList] = compress(children);
+
+    // 支配边界：汇合块沿每个前驱向上走到其直接支配者为止
+    const frontiers: number[][] = Array.from({ length: count }, () => []);
+    for (const block of rpo) {
+      const preds = cfg.predecessors(block).filter(pred => idom[pred] >= 0);
+      if (preds.length < 2) continue;
+      for (const pred of preds) {
+        for (let runner = pred; runner !== idom[block]; runner = idom[runner]) {
+          const list = frontiers[runner];
+          if (list[list.length - 1] === block) break;
+          list.push(block);
+        }
+      }
+    }
+    [this.frontierStart, this.frontierList] = compress(frontiers);
+  }
+
+  children(block: number): Int32Array {
+    return this.childList.subarray(this.childStart[block], this.childStart[block + 1]);
+  }
+
+  frontier(block: number): Int32Array {
+    return this.frontierList.subarray(this.frontierStart[block], this.frontierStart[block + 1]);
+  }
+
+  /**
+   * a 是否支配 b
+   */
+  dominates(a: number, b: number): boolean {
+    if (this.idom[b] < 0) return false;
+    for (let block = b; ; block = this.idom[block]) {
+      if (block === a) return true;
+      if (block === this.cfg.entry) return false;
+    }
+  }
+}
+
+/**
+ * 构建 SSA 的输入事件：def 为 true 时产生变量的新版本；operand 为定义时一并读取的另一变量（如复制的来源）
+ */
+export interface SSAEvent {
+  variable: number;
+  def: boolean;
+  operand?: number;
+}
+
+// 值的种类
+export const SSA_ENTRY = 0;
+export const SSA_DEF = 1;
+export const SSA_PHI = 2;
+
+/**
+ * 函数的 SSA 形式：值 0..variableCount-1 是各变量在入口处的值，其后依次为 φ 与块内定义
+ */
+export class SSAForm {
+  constructor(
+    readonly dominators: DominatorTree,
+    readonly valueCount: number,
+    /** SSA_ENTRY / SSA_DEF / SSA_PHI */
+    readonly kind: Uint8Array,
+    readonly variableOf: Int32Array,
+    readonly blockOf: Int32Array,
+    /** 定义值在所在块事件中的下标，其余为 -1 */
+    readonly eventOf: Int32Array,
+    /** 每块每个事件：使用事件读到的值，定义事件产生的值；不可达块为 -1 */
+    readonly eventValue: Int32Array[],
+    /** 定义事件之前变量的值 */
+    readonly eventPrevious: Int32Array[],
+    /** 事件 operand 变量此时的值，没有 operand 时为 -1 */
+    readonly eventOperand: Int32Array[],
+    private readonly operandStart: Int32Array,
+    private readonly operandList: Int32Array,
+    private readonly userStart: Int32Array,
+    private readonly userList: Int32Array
+  ) {}
+
+  /**
+   * 值的操作数：φ 为各前驱传入的值（不可达前驱为 -1，与 cfg.predecessors 顺序一致），
+   * 定义为 [之前的值, operand 的值]
+   */
+  operands(value: number): Int32Array {
+    return this.operandList.subarray(this.operandStart[value], this.operandStart[value + 1]);
+  }
+
+  /**
+   * 以该值为操作数的值（def-use 链）
+   */
+  users(value: number): Int32Array {
+    return this.userList.subarray(this.userStart[value], this.userStart[value + 1]);
+  }
+}
+
+/**
+ * 由块内事件构建最小 SSA
+ */
+export function buildSSA(cfg: ControlFlowGraph, variableCount: number, events: ReadonlyArray<ReadonlyArray<SSAEvent>>): SSAForm {
+  const dominators = new DominatorTree(cfg);
+  const count = cfg.blockCount;
+  const kind: number[] = [];
+  const variableOf: number[] = [];
+  const blockOf: number[] = [];
+  const eventOf: number[] = [];
+  const operands: number[][] = [];
+  const newValue = (type: number, variable: number, block: number, event: number, args: number[]): number => {
+    kind.push(type);
+    variableOf.push(variable);
+    blockOf.push(block);
+    eventOf.push(event);
+    operands.push(args);
+    return kind.length - 1;
+  };
+  for (let variable = 0; variable < variableCount; variable++) newValue(SSA_ENTRY, variable, cfg.entry, -1, []);
+
+  // φ 放置：每个变量的定义块集合的迭代支配边界
+  const defBlocks: number[][] = Array.from({ length: variableCount }, () => []);
+  for (let block = 0; block < count; block++) {
+    if (dominators.idom[block] < 0) continue;
+    for (const event of events[block]) {
+      const list = defBlocks[event.variable];
+      if (event.def && list[list.length - 1] !== block) list.push(block);
+    }
+  }
+  const phis: number[][] = Array.from({ length: count }, () => []);
+  const hasPhi = new Int32Array(count).fill(-1);
+  const queued = new Int32Array(count).fill(-1);
+  for (let variable = 0; variable < variableCount; variable++) {
+    const work = defBlocks[variable].slice();
+    for (const block of work) queued[block] = variable;
+    while (work.length > 0) {
+      const block = work.pop()!;
+      for (const join of dominators.frontier(block)) {
+        if (hasPhi[join] === variable) continue;
+        hasPhi[join] = variable;
+        const preds = cfg.predecessors(join);
+        phis[join].push(newValue(SSA_PHI, variable, join, -1, new Array(preds.length).fill(-1)));
+        if (queued[join] !== variable) {
+          queued[join] = variable;
+          work.push(join);
+        }
+      }
+    }
+  }
+
+  // 沿支配树重命名（显式栈，进入块时压入新版本，离开时按记录弹出）
+  const current = new Int32Array(variableCount);
+  for (let variable = 0; variable < variableCount; variable++) current[variable] = variable;
+  const eventValue: Int32Array[] = [];
+  const eventPrevious: Int32Array[] = [];
+  const eventOperand: Int32Array[] = [];
+  for (let block = 0; block < count; block++) {
+    const size = events[block].length;
+    eventValue.push(new Int32Array(size).fill(-1));
+    eventPrevious.push(new Int32Array(size).fill(-1));
+    eventOperand.push(new Int32Array(size).fill(-1));
+  }
+  const saved: Array<Array<[number, number]>> = [];
+  const blocks: number[] = [cfg.entry];
+  const entered = new Uint8Array(count);
+  while (blocks.length > 0) {
+    const block = blocks[blocks.length - 1];
+    if (entered[block]) {
+      // 离开块：恢复进入前的版本
+      for (const [variable, value] of saved.pop()!.reverse()) current[variable] = value;
+      blocks.pop();
+      continue;
+    }
+    entered[block] = 1;
+    const undo: Array<[number, number]> = [];
+    const define = (variable: number, value: number) => {
+      undo.push([variable, current[variable]]);
+      current[variable] = value;
+    };
+    for (const phi of phis[block]) define(variableOf[phi], phi);
+    events[block].forEach((event, i) => {
+      const operand = event.operand !== undefined ? current[event.operand] : -1;
+      eventOperand[block][i] = operand;
+      if (event.def) {
+        const previous = current[event.variable];
+        const value = newValue(SSA_DEF, event.variable, block, i, operand >= 0 ? [previous, operand] : [previous]);
+        eventPrevious[block][i] = previous;
+        eventValue[block][i] = value;
+        define(event.variable, value);
+      } else {
+        eventValue[block][i] = current[event.variable];
+      }
+    });
+    for (const succ of cfg.successors(block)) {
+      const preds = cfg.predecessors(succ);
+      for (const phi of phis[succ]) {
+        for (let j = 0; j < preds.length; j++) {
+          if (preds[j] === block) operands[phi][j] = current[variableOf[phi]];
+        }
+      }
+    }
+    saved.push(undo);
+    const children = dominators.children(block);
+    for (let i = children.length - 1; i >= 0; i--) blocks.push(children[i]);
+  }
+
+  const [operandStart, operandList] = compress(operands);
+  const users: number[][] = operands.map(() => []);
+  operands.forEach((args, value) => {
+    for (const arg of args) if (arg >= 0) users[arg].push(value);
+  });
+  const [userStart, userList] = compress(users);
+  return new SSAForm(
+    dominators, kind.length, Uint8Array.from(kind), Int32Array.from(variableOf), Int32Array.from(blockOf), Int32Array.from(eventOf),
+    eventValue, eventPrevious, eventOperand, operandStart, operandList, userStart, userList
+  );
+}
+
+function compress(lists: number[][]): [Int32Array, Int32Array] {
+  const start = new Int32Array(lists.length + 1);
+  lists.forEach((list, i) => { start[i + 1] = start[i] + list.length; });
+  const flat = new Int32Array(start[lists.length]);
+  lists.forEach((list, i) => flat.set(list, start[i]));
+  return [start, flat];
+}
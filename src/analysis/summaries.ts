@@ -0,0 +1,375 @@
+// 函数摘要：在函数 CFG 上做一次前向位向量分析，得出返回值与形参的过程间事实
+// （返回局部地址、返回已释放内存、释放形参、可能返回 NULL）；被调函数的效果取自其摘要
+
+import { ASTNode } from '../core/ast_parser';
+import { BitVector } from './bitvector';
+import { solve } from './dataflow';
+import { functionDeclarator } from './cfg';
+import { FunctionFlow, LocalVariable } from './variable_flow';
+import { PointsTo } from './points_to';
+import { named, childOfType, operatorOf, stripParens, unwrapDeclarator, hasToken } from './syntax';
+
+/**
+ * 函数摘要
+ */
+export interface FunctionSummary {
+  name: string;
+  returnType: string;
+  parameters: Array<{name: string, type: string, isPointer: boolean}>;
+  dangerousOperations: string[];
+  returnsLocalAddress: boolean;
+  returnsFreedMemory: boolean;
+  callsDangerousFunctions: string[];
+  // 可能被释放的形参下标
+  freesParameters: number[];
+  mayReturnNull: boolean;
+}
+
+/**
+ * 函数体内直接返回局部地址/已释放指针的位置
+ */
+export interface ReturnSite {
+  kind: 'local' | 'freed';
+  variable: string;
+  position: { row: number; column: number };
+}
+
+/**
+ * 把被调函数返回值赋给变量的调用点（p = f(...) / T *p = f(...)）
+ */
+export interface CallSite {
+  callee: string;
+  variable: string;
+  position: { row: number; column: number };
+}
+
+export interface SummaryResult {
+  summary: FunctionSummary;
+  returnSites: ReturnSite[];
+  callSites: CallSite[];
+}
+
+export type SummaryLookup = (callee: string) => FunctionSummary | undefined;
+
+// 每个变量四位：指向本栈帧、已释放、可能为 NULL、仍持有形参传入的值（仅形参使用）
+const LOCAL = 0;
+const FREED = 1;
+const NULLABLE = 2;
+const PARAM = 3;
+const BITS = 4;
+
+const NULL_TEXT = new Set(['NULL', 'nullptr', '0', '((void *)0)', '((void*)0)']);
+const FREE_FUNCTIONS = new Set(['free', 'cfree']);
+const TYPE_NODE_TYPES = new Set([
+  'primitive_type', 'sized_type_specifier', 'type_identifier', 'struct_specifier', 'union_specifier', 'enum_specifier'
+]);
+
+/**
+ * 值的来源：按位组合 LOCAL/FREED/NULLABLE/PARAM
+ */
+type Origin = number;
+
+interface Recorder {
+  returnSites: ReturnSite[];
+  callSites: CallSite[];
+  freed: Set<number>;
+  returnsLocal: boolean;
+  returnsFreed: boolean;
+  mayReturnNull: boolean;
+}
+
+class SummaryBuilder {
+  private readonly params: LocalVariable[];
+
+  constructor(private readonly flow: FunctionFlow, private readonly lookup: SummaryLookup, private readonly pointsTo?: PointsTo) {
+    this.params = flow.variables.filter(variable => variable.isParameter);
+  }
+
+  run(): SummaryResult {
+    const cfg = this.flow.cfg;
+    const width = this.flow.variables.length * BITS;
+    const result = solve(cfg, {
+      direction: 'forward',
+      meet: 'union',
+      width,
+      boundary: value => {
+        for (const param of this.params) value.set(param.id * BITS + PARAM);
+      },
+      transfer: (block, input, output) => {
+        output.copyFrom(input);
+        for (const item of cfg.items[block]) this.evaluate(item, output, null);
+      }
+    });
+
+    // 不动点上逐块回放一次，记录返回点、调用点与被释放的形参
+    const recorder: Recorder = {
+      returnSites: [], callSites: [], freed: new Set(),
+      returnsLocal: false, returnsFreed: false, mayReturnNull: false
+    };
+    for (const block of cfg.reversePostorder()) {
+      const state = result.input[block].clone();
+      for (const item of cfg.items[block]) this.evaluate(item, state, recorder);
+    }
+
+    const signature = describeSignature(this.flow.functionNode);
+    return {
+      summary: {
+        ...signature,
+        dangerousOperations: [],
+        returnsLocalAddress: recorder.returnsLocal,
+        returnsFreedMemory: recorder.returnsFreed,
+        callsDangerousFunctions: [],
+        freesParameters: this.params.map((param, i) => recorder.freed.has(param.id) ? i : -1).filter(i => i >= 0),
+        // 返回整数 0 不算返回 NULL
+        mayReturnNull: recorder.mayReturnNull && signature.returnType.endsWith('*')
+      },
+      returnSites: recorder.returnSites,
+      callSites: recorder.callSites
+    };
+  }
+
+  /**
+   * 按求值顺序更新状态；块项若是 return 的返回值，再检查返回值来源
+   */
+  private evaluate(node: ASTNode, state: BitVector, recorder: Recorder | null): void {
+    this.visit(node, state, recorder);
+    if (recorder && node.parent && node.parent.type === 'return_statement') {
+      this.checkReturn(node, state, recorder);
+    }
+  }
+
+  private visit(node: ASTNode, state: BitVector, recorder: Recorder | null): void {
+    switch (node.type) {
+      case 'declaration':
+        for (const child of named(node)) {
+          if (child.type !== 'init_declarator') {
+            // 无初始化器的声明（如循环体内）重置变量状态
+            const info = child.type.endsWith('declarator') || child.type === 'identifier' ? unwrapDeclarator(child) : null;
+            const variable = info ? this.flow.resolve(info.name) : undefined;
+            if (variable) this.reset(variable, state);
+            continue;
+          }
+          const parts = named(child);
+          const value = parts[parts.length - 1];
+          if (!value || parts.length < 2) continue;
+          this.visit(value, state, recorder);
+          const info = unwrapDeclarator(child);
+          const variable = info ? this.flow.resolve(info.name) : undefined;
+          if (variable) this.assign(variable, value, state, recorder);
+        }
+        return;
+      case 'assignment_expression': {
+        const parts = named(node);
+        const left = parts[0];
+        const right = parts[parts.length - 1];
+        if (right) this.visit(right, state, recorder);
+        const target = this.flow.resolve(left && stripParens(left));
+        if (target && right && operatorOf(node) === '=') this.assign(target, right, state, recorder);
+        else if (left && !target) this.visit(left, state, recorder);
+        return;
+      }
+      case 'call_expression': {
+        const [callee, args] = named(node);
+        const argList = args ? named(args) : [];
+        for (const arg of argList) this.visit(arg, state, recorder);
+        if (!callee || callee.type !== 'identifier') {
+          if (callee) this.visit(callee, state, recorder);
+          return;
+        }
+        if (FREE_FUNCTIONS.has(callee.text)) {
+          this.release(argList[0], state, recorder);
+        } else {
+          const summary = this.lookup(callee.text);
+          for (const index of summary ? summary.freesParameters : []) this.release(argList[index], state, recorder);
+        }
+        return;
+      }
+      case 'sizeof_expression':
+        return;
+      default:
+        for (const child of named(node)) this.visit(child, state, recorder);
+    }
+  }
+
+  private assign(variable: LocalVariable, value: ASTNode, state: BitVector, recorder: Recorder | null): void {
+    // 重新赋值后不再持有形参传入的值
+    const origin = this.originOf(value, state) & ~(1 << PARAM);
+    const base = variable.id * BITS;
+    for (let bit = 0; bit < BITS; bit++) {
+      if (origin & (1 << bit)) state.set(base + bit);
+      else state.clear(base + bit);
+    }
+    const call = stripParens(value);
+    if (recorder && call.type === 'call_expression') {
+      const callee = named(call)[0];
+      if (callee && callee.type === 'identifier') {
+        recorder.callSites.push({ callee: callee.text, variable: variable.name, position: call.startPosition });
+      }
+    }
+  }
+
+  private reset(variable: LocalVariable, state: BitVector): void {
+    for (let bit = 0; bit < BITS; bit++) state.clear(variable.id * BITS + bit);
+  }
+
+  private release(arg: ASTNode | undefined, state: BitVector, recorder: Recorder | null): void {
+    const variable = this.flow.resolve(arg && stripParens(arg));
+    if (!variable) return;
+    const base = variable.id * BITS;
+    state.set(base + FREED);
+    // 形参在被重新赋值前释放，即释放了调用者传入的指针
+    const released = [variable];
+    // 稳定别名此刻指向同一块内存（q = p; free(q); 之后 p 也已释放）
+    if (this.pointsTo) {
+      for (const alias of this.pointsTo.stableAliases(this.flow, variable)) {
+        state.set(alias.id * BITS + FREED);
+        released.push(alias);
+      }
+    }
+    if (!recorder) return;
+    for (const target of released) {
+      if (target.isParameter && state.has(target.id * BITS + PARAM)) recorder.freed.add(target.id);
+    }
+  }
+
+  private checkReturn(value: ASTNode, state: BitVector, recorder: Recorder): void {
+    const origin = this.originOf(value, state);
+    const expr = stripParens(value);
+    const direct = expr.type === 'call_expression' ? undefined : this.returnedVariable(expr);
+    if (origin & (1 << LOCAL)) {
+      recorder.returnsLocal = true;
+      if (direct) recorder.returnSites.push({ kind: 'local', variable: direct.name, position: value.startPosition });
+    }
+    if (origin & (1 << FREED)) {
+      recorder.returnsFreed = true;
+      if (direct) recorder.returnSites.push({ kind: 'freed', variable: direct.name, position: value.startPosition });
+    }
+    if (origin & (1 << NULLABLE)) recorder.mayReturnNull = true;
+  }
+
+  /**
+   * 返回表达式中被返回的变量：p、&x、arr
+   */
+  private returnedVariable(expr: ASTNode): LocalVariable | undefined {
+    if (expr.type === 'pointer_expression' && operatorOf(expr) === '&') {
+      const operand = named(expr)[0];
+      return operand ? this.storageOf(operand) : undefined;
+    }
+    return this.flow.resolve(expr);
+  }
+
+  /**
+   * 值的来源集合：只关心指针值（地址、复制、调用结果、NULL）
+   */
+  private originOf(value: ASTNode, state: BitVector): Origin {
+    const expr = stripParens(value);
+    switch (expr.type) {
+      case 'null':
+        return 1 << NULLABLE;
+      case 'identifier': {
+        const variable = this.flow.resolve(expr);
+        if (!variable) return NULL_TEXT.has(expr.text) ? 1 << NULLABLE : 0;
+        // 局部数组名退化为指向本栈帧的指针
+        if (variable.isArray && !variable.isStatic) return 1 << LOCAL;
+        let origin = 0;
+        for (let bit = 0; bit < BITS; bit++) {
+          if (state.has(variable.id * BITS + bit)) origin |= 1 << bit;
+        }
+        return origin;
+      }
+      case 'number_literal':
+        return NULL_TEXT.has(expr.text) ? 1 << NULLABLE : 0;
+      case 'pointer_expression': {
+        if (operatorOf(expr) !== '&') return 0;
+        const operand = named(expr)[0];
+        const storage = operand ? this.storageOf(operand) : undefined;
+        return storage && !storage.isStatic ? 1 << LOCAL : 0;
+      }
+      case 'conditional_expression': {
+        const [, ...branches] = named(expr);
+        return branches.reduce((origin, branch) => origin | this.originOf(branch, state), 0);
+      }
+      case 'binary_expression': {
+        // 指针算术保持来源
+        const [left, right] = named(expr);
+        const op = operatorOf(expr);
+        if (op !== '+' && op !== '-') return 0;
+        const origin = (left ? this.originOf(left, state) : 0) | (right && op === '+' ? this.originOf(right, state) : 0);
+        return origin & ~(1 << NULLABLE);
+      }
+      case 'call_expression': {
+        const callee = named(expr)[0];
+        const summary = callee && callee.type === 'identifier' ? this.lookup(callee.text) : undefined;
+        if (!summary) return 0;
+        return (summary.returnsLocalAddress ? 1 << LOCAL : 0) |
+               (summary.returnsFreedMemory ? 1 << FREED : 0) |
+               (summary.mayReturnNull ? 1 << NULLABLE : 0);
+      }
+    }
+    return 0;
+  }
+
+  /**
+   * &x / &x.f / &x[i] 所取地址的栈上变量（经由指针的成员/下标不算）
+   */
+  private storageOf(node: ASTNode): LocalVariable | undefined {
+    let current = stripParens(node);
+    for (;;) {
+      if (current.type === 'identifier') return this.flow.resolve(current);
+      if (current.type === 'field_expression' && !hasToken(current, '->')) {
+        current = stripParens(named(current)[0]);
+      } else if (current.type === 'subscript_expression') {
+        const array = stripParens(named(current)[0]);
+        const variable = this.flow.resolve(array);
+        if (!variable || !variable.isArray) return undefined;
+        current = array;
+      } else {
+        return undefined;
+      }
+    }
+  }
+}
+
+/**
+ * 函数名、返回类型与形参列表
+ */
+function describeSignature(fn: ASTNode): Pick<FunctionSummary, 'name' | 'returnType' | 'parameters'> {
+  const declarator = functionDeclarator(fn);
+  const nameNode = declarator ? named(declarator)[0] : undefined;
+  const typeNode = named(fn).find(child => TYPE_NODE_TYPES.has(child.type));
+  const outer = named(fn).find(child => child.type.endsWith('declarator'));
+  const returnsPointer = !!outer && outer.type === 'pointer_declarator';
+  const parameters: FunctionSummary['parameters'] = [];
+  const list = declarator ? childOfType(declarator, 'parameter_list') : undefined;
+  for (const parameter of list ? named(list) : []) {
+    if (parameter.type !== 'parameter_declaration') continue;
+    const type = named(parameter).find(child => TYPE_NODE_TYPES.has(child.type));
+    const inner = named(parameter).find(child => child.type.endsWith('declarator') || child.type === 'identifier');
+    const info = inner ? unwrapDeclarator(inner) : null;
+    if (!info) continue;
+    parameters.push({ name: info.name.text, type: type ? type.text : '', isPointer: info.isPointer || info.isArray });
+  }
+  return {
+    name: nameNode ? nameNode.text : '',
+    returnType: (typeNode ? typeNode.text : 'int') + (returnsPointer ? '*' : ''),
+    parameters
+  };
+}
+
+/**
+ * 计算单个函数的摘要；lookup 提供被调函数（同一强连通分量内为当前近似值）的摘要，
+ * pointsTo 提供函数内的别名关系，释放一个指针时其稳定别名一并视为已释放
+ */
+export function summarizeFunction(flow: FunctionFlow, lookup: SummaryLookup, pointsTo?: PointsTo): SummaryResult {
+  return new SummaryBuilder(flow, lookup, pointsTo).run();
+}
+
+/**
+ * 两个摘要的过程间事实是否相同（强连通分量迭代的收敛判据）
+ */
+export function sameFacts(a: FunctionSummary, b: FunctionSummary): boolean {
+  return a.returnsLocalAddress === b.returnsLocalAddress &&
+         a.returnsFreedMemory === b.returnsFreedMemory &&
+         a.mayReturnNull === b.mayReturnNull &&
+         a.freesParameters.join(',') === b.freesParameters.join(',');
+}
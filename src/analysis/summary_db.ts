@@ -0,0 +1,134 @@
+// 跨文件函数摘要数据库：以"文件#函数名"为键持久化摘要，记录函数签名与函数体（含被调函数解析结果）的哈希，
+// 下次扫描时签名与哈希都未变、且没有被调函数需要重算的函数直接复用已存摘要
+
+import * as fs from 'fs';
+import * as path from 'path';
+import { FunctionSummary, SummaryResult } from './summaries';
+import { getLogger } from '../utils/logger';
+
+const log = getLogger('summary');
+
+// 摘要计算规则变化时递增，旧库整体作废
+const FORMAT_VERSION = 2;
+
+/**
+ * 函数的符号信息（跨文件符号表的一项）
+ */
+export interface StoredSymbol {
+  name: string;
+  file: string;
+  line: number;
+  isStatic: boolean;
+}
+
+/**
+ * 数据库中的一项；返回点/调用点的行号相对函数起始行保存，函数整体移动后仍可复用
+ */
+export interface StoredSummary {
+  signature: string;
+  hash: string;
+  symbol: StoredSymbol;
+  summary: FunctionSummary;
+  returnSites: SummaryResult['returnSites'];
+  callSites: SummaryResult['callSites'];
+}
+
+interface DatabaseFile {
+  version: number;
+  functions: Record<string, StoredSummary>;
+}
+
+export class SummaryDatabase {
+  private readonly entries = new Map<string, StoredSummary>();
+  private dirty = false;
+
+  private constructor(readonly filePath: string) {}
+
+  /**
+   * 打开数据库；文件不存在、版本不符或内容损坏时从空库开始
+   */
+  static open(filePath: string): SummaryDatabase {
+    const db = new SummaryDatabase(filePath);
+    if (!fs.existsSync(filePath)) return db;
+    try {
+      const data: DatabaseFile = JSON.parse(fs.readFileSync(filePath, 'utf8'));
+      if (data.version === FORMAT_VERSION && data.functions) {
+        for (const key of Object.keys(data.functions)) db.entries.set(key, data.functions[key]);
+      }
+    } catch (error) {
+      log.warn('摘要数据库读取失败，将重新计算全部摘要', { file: filePath, error: String(error) });
+    }
+    return db;
+  }
+
+  static keyOf(file: string, name: string): string {
+    return `${file}#${name}`;
+  }
+
+  get size(): number {
+    return this.entries.size;
+  }
+
+  /**
+   * 签名与哈希都匹配时返回已存摘要，行号按当前函数起始行还原
+   */
+  lookup(key: string, signature: string, hash: string, startRow: number): SummaryResult | undefined {
+    const entry = this.entries.get(key);
+    if (!entry || entry.signature !== signature || entry.hash !== hash) return undefined;
+    const rebase = <T extends { position: { row: number; column: number } }>(site: T): T =>
+      ({ ...site, position: { row: site.position.row + startRow, column: site.position.column } });
+    return {
+      summary: entry.summary,
+      returnSites: entry.returnSites.map(rebase),
+      callSites: entry.callSites.map(rebase)
+    };
+  }
+
+  /**
+   * 签名与哈希是否与已存项一致
+   */
+  matches(key: string, signature: string, hash: string): boolean {
+    const entry = this.entries.get(key);
+    return !!entry && entry.signature === signature && entry.hash === hash;
+  }
+
+  store(key: string, signature: string, hash: string, symbol: StoredSymbol, result: SummaryResult, startRow: number): void {
+    const relative = <T extends { position: { row: number; column: number } }>(site: T): T =>
+      ({ ...site, position: { row: site.position.row - startRow, column: site.position.column } });
+    this.entries.set(key, {
+      signature,
+      hash,
+      symbol,
+      summary: result.summary,
+      returnSites: result.returnSites.map(relative),
+      callSites: result.callSites.map(relative)
+    });
+    this.dirty = true;
+  }
+
+  /**
+   * 删除本次扫描到的文件中已不存在的函数；未扫描的文件保持原样
+   */
+  retain(scannedFiles: Set<string>, liveKeys: Set<string>): void {
+    for (const [key, entry] of this.entries) {
+      if (scannedFiles.has(entry.symbol.file) && !liveKeys.has(key)) {
+        this.entries.delete(key);
+        this.dirty = true;
+      }
+    }
+  }
+
+  /**
+   * 有变更时写回磁盘（先写临时文件再改名，避免中断留下半个文件）
+   */
+  save(): void {
+    if (!this.dirty) return;
+    const data: DatabaseFile = { version: FORMAT_VERSION, functions: {} };
+    for (const [key, entry] of this.entries) data.functions[key] = entry;
+    fs.mkdirSync(path.dirname(this.filePath), { recursive: true });
+    const temp = `${this.filePath}.${process.pid}.tmp`;
+    fs.writeFileSync(temp, JSON.stringify(data), 'utf8');
+    fs.renameSync(temp, this.filePath);
+    this.dirty = false;
+  }
+}
@@ -0,0 +1,142 @@
+// 分析阶段使用的语法树辅助函数：统一按 children 遍历（namedChildren 与 children 可能是不同的对象），
+// 并以"类型即文本的叶子"识别匿名记号
+
+import { ASTNode } from '../core/ast_parser';
+import { instrumentation } from '../utils/instrumentation';
+
+// 类型名与文本可能相同的命名叶子节点
+const NAMED_LEAVES = new Set(['identifier', 'true', 'false', 'null']);
+
+/**
+ * 是否为匿名记号（关键字、标点等）
+ */
+export function isToken(node: ASTNode): boolean {
+  if (node.children.length > 0 || NAMED_LEAVES.has(node.type)) return false;
+  return node.type === node.text || !/^[a-z_]+$/.test(node.type);
+}
+
+/**
+ * 命名子节点（取自 children，保证节点对象唯一）
+ */
+export function named(node: ASTNode): ASTNode[] {
+  if (instrumentation.enabled) instrumentation.nodes += node.children.length;
+  return node.children.filter(child => !isToken(child));
+}
+
+/**
+ * 第一个指定类型的子节点
+ */
+export function childOfType(node: ASTNode, type: string): ASTNode | undefined {
+  return node.children.find(child => child.type === type);
+}
+
+/**
+ * 是否含有指定文本的匿名记号（如 '->'、'else'）
+ */
+export function hasToken(node: ASTNode, text: string): boolean {
+  return node.children.some(child => isToken(child) && child.text === text);
+}
+
+/**
+ * 运算符记号文本（assignment/binary/unary/pointer/update 表达式）
+ */
+export function operatorOf(node: ASTNode): string {
+  const token = node.children.find(isToken);
+  return token ? token.text : '';
+}
+
+/**
+ * 只去掉外层括号（类型转换会改变取值，按值细化条件时不能越过）
+ */
+export function unparen(node: ASTNode): ASTNode {
+  let current = node;
+  while (current.type === 'parenthesized_expression') {
+    const inner = named(current);
+    if (inner.length === 0) break;
+    current = inner[inner.length - 1];
+  }
+  return current;
+}
+
+/**
+ * 去掉外层括号与类型转换
+ */
+export function stripParens(node: ASTNode): ASTNode {
+  let current = node;
+  while (current.type === 'parenthesized_expression' || current.type === 'cast_expression') {
+    const inner = named(current);
+    const next = inner[inner.length - 1];
+    if (!next) break;
+    current = next;
+  }
+  return current;
+}
+
+/**
+ * 声明器中的变量名节点，以及它是否为指针/数组/函数声明器
+ */
+export interface DeclaratorInfo {
+  name: ASTNode;
+  isPointer: boolean;
+  isArray: boolean;
+  isFunction: boolean;
+}
+
+export function unwrapDeclarator(node: ASTNode): DeclaratorInfo | null {
+  let current: ASTNode | undefined = node;
+  let isPointer = false;
+  let isArray = false;
+  let isFunction = false;
+  while (current) {
+    switch (current.type) {
+      case 'identifier':
+        return { name: current, isPointer, isArray, isFunction };
+      case 'init_declarator':
+        current = named(current)[0];
+        break;
+      case 'pointer_declarator':
+        // 函数指针 (*fp)(...) 中的 '*' 属于函数声明器内部，外层已记为函数
+        if (!isFunction) isPointer = true;
+        current = named(current).find(child => child.type !== 'type_qualifier');
+        break;
+      case 'array_declarator':
+        isArray = true;
+        current = named(current)[0];
+        break;
+      case 'function_declarator':
+        isFunction = true;
+        current = named(current)[0];
+        break;
+      case 'parenthesized_declarator':
+        current = named(current)[0];
+        break;
+      default:
+        return null;
+    }
+  }
+  return null;
+}
+
+/**
+ * 整型常量条件是否恒为真（用于 while(1) / for(;;) 等）
+ */
+export function isConstantTrue(node: ASTNode | undefined): boolean {
+  if (!node) return false;
+  const expr = stripParens(node);
+  if (expr.type === 'true') return true;
+  if (expr.type === 'number_literal') {
+    const value = Number(expr.text.replace(/[uUlL]+$/, ''));
+    return !Number.isNaN(value) && value !== 0;
+  }
+  return false;
+}
+
+/**
+ * 整型常量条件是否恒为假
+ */
+export function isConstantFalse(node: ASTNode | undefined): boolean {
+  if (!node) return false;
+  const expr = stripParens(node);
+  if (expr.type === 'false') return true;
+  return expr.type === 'number_literal' && Number(expr.text.replace(/[uUlL]+$/, '')) === 0;
+}
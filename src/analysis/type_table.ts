@@ -0,0 +1,109 @@
+// 文件级声明类型表：一次遍历收集全部变量/参数声明的类型及其作用域，按名字查找源码位置上可见的最近一次声明
+
+import { ASTNode } from '../core/ast_parser';
+import { named } from './syntax';
+
+// 可携带类型信息的声明类型节点
+const TYPE_NODE_TYPES = new Set([
+  'primitive_type', 'sized_type_specifier', 'type_identifier', 'struct_specifier', 'union_specifier', 'enum_specifier'
+]);
+
+// 为其中的声明开启作用域的节点；declaration 只在函数原型里包含参数声明，其参数不应泄漏到外层
+const SCOPE_NODE_TYPES = new Set(['function_definition', 'compound_statement', 'for_statement', 'declaration']);
+
+type Position = { row: number; column: number };
+
+export interface DeclaredType {
+  name: string;
+  /** 类型说明符文本，如 'unsigned int'、'struct node' */
+  base: string;
+  /** 指针/数组层数（数组在表达式中退化为指针） */
+  depth: number;
+  position: Position;
+  /** 声明所在作用域的源码范围；文件作用域为 undefined */
+  scope?: { start: Position; end: Position };
+}
+
+export class TypeTable {
+  private readonly byName = new Map<string, DeclaredType[]>();
+
+  constructor(root: ASTNode) {
+    const stack: Array<[ASTNode, ASTNode | undefined]> = [[root, undefined]];
+    while (stack.length > 0) {
+      const [node, scope] = stack.pop()!;
+      if (node.type === 'declaration' || node.type === 'parameter_declaration') {
+        this.record(node, scope);
+      }
+      const inner = SCOPE_NODE_TYPES.has(node.type) ? node : scope;
+      for (let i = node.children.length - 1; i >= 0; i--) stack.push([node.children[i], inner]);
+    }
+  }
+
+  /**
+   * 变量在某位置可见的声明：该位置之前、且作用域包含该位置的最近一次声明；不给位置时取第一次声明
+   */
+  lookup(name: string, at?: Position): DeclaredType | undefined {
+    const entries = this.byName.get(name);
+    if (!entries) return undefined;
+    if (!at) return entries[0];
+    let found: DeclaredType | undefined;
+    for (const entry of entries) {
+      if (before(at, entry.position)) break;
+      if (!entry.scope || (!before(at, entry.scope.start) && !before(entry.scope.end, at))) found = entry;
+    }
+    return found;
+  }
+
+  /**
+   * 带指针层数的类型文本，如 'char * *'；与 classifyCType 的输入格式一致
+   */
+  typeOf(name: string, at?: Position): string | null {
+    const entry = this.lookup(name, at);
+    return entry ? entry.base + ' *'.repeat(entry.depth) : null;
+  }
+
+  private record(node: ASTNode, scope: ASTNode | undefined): void {
+    const children = named(node);
+    const typeNode = children.find(child => TYPE_NODE_TYPES.has(child.type));
+    if (!typeNode) return;
+
+    for (const child of children) {
+      if (child === typeNode) continue;
+      const declarator = this.unwrap(child, 0);
+      if (!declarator) continue;
+      const entry: DeclaredType = {
+        name: declarator.name.text,
+        base: typeNode.text,
+        depth: declarator.depth,
+        position: declarator.name.startPosition,
+        scope: scope && { start: scope.startPosition, end: scope.endPosition }
+      };
+      const entries = this.byName.get(entry.name);
+      if (entries) entries.push(entry);
+      else this.byName.set(entry.name, [entry]);
+    }
+  }
+
+  private unwrap(node: ASTNode, depth: number): { name: ASTNode; depth: number } | null {
+    switch (node.type) {
+      case 'identifier':
+        return { name: node, depth };
+      case 'init_declarator':
+      case 'parenthesized_declarator': {
+        const inner = named(node)[0];
+        return inner ? this.unwrap(inner, depth) : null;
+      }
+      case 'pointer_declarator':
+      case 'array_declarator': {
+        const inner = named(node).find(child => child.type !== 'type_qualifier');
+        return inner ? this.unwrap(inner, depth + 1) : null;
+      }
+    }
+    // 函数声明器等不是变量
+    return null;
+  }
+}
+
+function before(a: Position, b: Position): boolean {
+  return a.row < b.row || (a.row === b.row && a.column < b.column);
+}
@@ -0,0 +1,452 @@
+// 局部变量数据流分析：把函数内的变量读写转成 SSA 形式，沿 def-use 链稀疏传播
+// 到达定义、确定赋值与空值性事实，用于未初始化变量、野指针与空指针解引用检测
+
+import { ASTNode } from '../core/ast_parser';
+import { ControlFlowGraph, buildCFG, functionDeclarator } from './cfg';
+import { SSAForm, SSAEvent, SSA_ENTRY, SSA_DEF, buildSSA } from './ssa';
+import { named, childOfType, operatorOf, stripParens, unwrapDeclarator, isToken } from './syntax';
+import { ScopedSymbolTable } from '../utils/scoped_symbols';
+
+export interface LocalVariable {
+  id: number;
+  name: string;
+  isPointer: boolean;
+  isArray: boolean;
+  isParameter: boolean;
+  // static/extern 局部变量：存储不在栈帧上
+  isStatic: boolean;
+  // 标量或指针、非 static/extern：参与未初始化与空值性追踪
+  tracked: boolean;
+  row: number;
+  column: number;
+}
+
+/**
+ * 块内事件：表达式求值顺序上的变量读写
+ * - declare: 无初始化器的声明，变量进入未定值状态
+ * - define:  赋值或初始化（value 描述右值的空值性）
+ * - address: 取地址，之后可能经由指针被写入
+ * - read:    普通读取
+ * - deref:   作为指针被解引用（*p、p->f、p[i]）
+ */
+export type FlowEventKind = 'declare' | 'define' | 'address' | 'read' | 'deref';
+
+export type NullValue = 'null' | 'nonnull' | 'copy';
+
+export interface FlowEvent {
+  kind: FlowEventKind;
+  variable: number;
+  node: ASTNode;
+  value?: NullValue;
+  source?: number;        // value === 'copy' 时的来源变量
+  conditional: boolean;   // 位于 && || ?: 的非首个操作数中，不一定被求值
+}
+
+export type FlowFindingKind = 'uninitialized' | 'wild' | 'null';
+
+export interface FlowFinding {
+  kind: FlowFindingKind;
+  variable: LocalVariable;
+  node: ASTNode;
+  // 仅在部分路径上未初始化（存在可到达的真实定义）
+  partial: boolean;
+}
+
+// SSA 值上的事实（均为"存在某条路径"意义下的可能事实）
+const DECLARED = 1;      // 最近的定义是无初始化器的声明
+const UNASSIGNED = 2;    // 尚未赋值（取地址也算赋值）
+const DEFINED = 4;       // 有真实定义（赋值、初始化或形参入口）到达
+const MAY_NULL = 8;
+const MAY_NONNULL = 16;
+const NULLNESS = MAY_NULL | MAY_NONNULL;
+
+const TRACKED_TYPES = new Set(['primitive_type', 'sized_type_specifier', 'enum_specifier']);
+const NULL_TEXT = new Set(['NULL', 'nullptr', '0', '0L', '((void *)0)', '((void*)0)']);
+
+/**
+ * 单个函数的变量数据流分析结果
+ */
+export class FunctionFlow {
+  readonly variables: LocalVariable[] = [];
+  readonly cfg: ControlFlowGraph;
+  private readonly resolved = new Map<ASTNode, number>();
+  private readonly events: FlowEvent[][] = [];
+  private ssaForm?: SSAForm;
+  private facts?: Uint8Array;
+
+  constructor(readonly functionNode: ASTNode, cfg?: ControlFlowGraph) {
+    this.cfg = cfg || buildCFG(functionNode);
+    this.collectVariables();
+    for (const blockItems of this.cfg.items) {
+      const blockEvents: FlowEvent[] = [];
+      for (const item of blockItems) this.collectEvents(item, blockEvents, false);
+      this.events.push(blockEvents);
+    }
+  }
+
+  /**
+   * 变量读写的 SSA 形式：declare/define/address 事件产生新版本，复制定义同时读取来源变量
+   */
+  ssa(): SSAForm {
+    if (!this.ssaForm) {
+      const events: SSAEvent[][] = this.events.map(blockEvents => blockEvents.map(event => ({
+        variable: event.variable,
+        def: event.kind === 'declare' || event.kind === 'define' || event.kind === 'address',
+        operand: event.kind === 'define' && event.value === 'copy' ? event.source : undefined
+      })));
+      this.ssaForm = buildSSA(this.cfg, this.variables.length, events);
+    }
+    return this.ssaForm;
+  }
+
+  /**
+   * 每个 SSA 值的事实位：入口值按变量种类给定，定义值由之前的值与复制来源经事件传递得到，
+   * φ 取各前驱的并；从初值出发沿 def-use 链传播到不动点
+   */
+  private valueFacts(): Uint8Array {
+    if (this.facts) return this.facts;
+    const ssa = this.ssa();
+    const facts = new Uint8Array(ssa.valueCount);
+    const queued = new Uint8Array(ssa.valueCount);
+    const work: number[] = [];
+    for (let value = ssa.valueCount - 1; value >= 0; value--) {
+      if (ssa.kind[value] === SSA_ENTRY) {
+        const variable = this.variables[ssa.variableOf[value]];
+        if (variable.isParameter) facts[value] = DEFINED | NULLNESS;
+        else facts[value] = variable.tracked ? UNASSIGNED : NULLNESS;
+      } else {
+        work.push(value);
+        queued[value] = 1;
+      }
+    }
+    while (work.length > 0) {
+      const value = work.pop()!;
+      queued[value] = 0;
+      const operands = ssa.operands(value);
+      let next = 0;
+      if (ssa.kind[value] === SSA_DEF) {
+        const event = this.events[ssa.blockOf[value]][ssa.eventOf[value]];
+        next = transfer(event, facts[operands[0]], operands.length > 1 ? facts[operands[1]] : 0);
+      } else {
+        for (const operand of operands) if (operand >= 0) next |= facts[operand];
+      }
+      if (next === facts[value]) continue;
+      facts[value] = next;
+      for (const user of ssa.users(value)) {
+        if (!queued[user]) {
+          queued[user] = 1;
+          work.push(user);
+        }
+      }
+    }
+    this.facts = facts;
+    return facts;
+  }
+
+  /**
+   * 按逆后序检查每个读取/解引用事件所读到的 SSA 值，给出缺陷
+   */
+  findings(): FlowFinding[] {
+    const results: FlowFinding[] = [];
+    if (!this.cfg.complete || this.variables.length === 0) return results;
+
+    const ssa = this.ssa();
+    const facts = this.valueFacts();
+    const reportedKeys = new Set<string>();
+    const report = (kind: FlowFindingKind, event: FlowEvent, fact: number) => {
+      const variable = this.variables[event.variable];
+      const key = `${kind}:${variable.id}:${event.node.startPosition.row}`;
+      if (reportedKeys.has(key)) return;
+      reportedKeys.add(key);
+      results.push({ kind, variable, node: event.node, partial: (fact & DEFINED) !== 0 });
+    };
+
+    for (const block of this.cfg.reversePostorder()) {
+      this.events[block].forEach((event, i) => {
+        const variable = this.variables[event.variable];
+        if (!variable.tracked || (event.kind !== 'read' && event.kind !== 'deref')) return;
+        const fact = facts[ssa.eventValue[block][i]];
+        if ((fact & UNASSIGNED) && (fact & DECLARED)) {
+          if (event.kind === 'deref' && variable.isPointer) report('wild', event, fact);
+          else if (event.kind === 'read' && !variable.isPointer) report('uninitialized', event, fact);
+        } else if (event.kind === 'deref' && variable.isPointer && (fact & NULLNESS) === MAY_NULL) {
+          report('null', event, fact);
+        }
+      });
+    }
+
+    return results;
+  }
+
+  /**
+   * 块内按求值顺序排列的变量事件
+   */
+  eventsOf(block: number): readonly FlowEvent[] {
+    return this.events[block];
+  }
+
+  /**
+   * 标识符节点解析到的形参/局部变量（全局变量与函数名返回 undefined）
+   */
+  resolve(node: ASTNode | undefined): LocalVariable | undefined {
+    const id = this.variableOf(node);
+    return id === undefined ? undefined : this.variables[id];
+  }
+
+  private declare(name: ASTNode, info: { isPointer: boolean; isArray: boolean; isParameter: boolean; isStatic: boolean; tracked: boolean }, scopes: ScopedSymbolTable<number>): number {
+    const id = this.variables.length;
+    this.variables.push({ id, name: name.text, ...info, row: name.startPosition.row, column: name.startPosition.column });
+    this.resolved.set(name, id);
+    scopes.declare(name.text, id);
+    return id;
+  }
+
+  /**
+   * 按词法作用域为形参与局部变量分配 id，并把每个标识符节点解析到变量
+   */
+  private collectVariables(): void {
+    const scopes = new ScopedSymbolTable<number>();
+
+    const declarator = functionDeclarator(this.functionNode);
+    const parameters = declarator ? childOfType(declarator, 'parameter_list') : undefined;
+    for (const parameter of parameters ? named(parameters) : []) {
+      if (parameter.type !== 'parameter_declaration') continue;
+      const inner = named(parameter).find(child => child.type.endsWith('declarator') || child.type === 'identifier');
+      const info = inner ? unwrapDeclarator(inner) : null;
+      if (info) {
+        // 数组形参退化为指针
+        this.declare(info.name, { isPointer: info.isPointer || info.isArray, isArray: false, isParameter: true, isStatic: false, tracked: false }, scopes);
+      }
+    }
+
+    const visit = (node: ASTNode): void => {
+      switch (node.type) {
+        case 'compound_statement':
+        case 'for_statement': {
+          scopes.pushScope();
+          for (const child of named(node)) visit(child);
+          scopes.popScope();
+          return;
+        }
+        case 'declaration': {
+          const specifiers = named(node).filter(child => !child.type.endsWith('declarator') && child.type !== 'identifier');
+          const isStatic = specifiers.some(child => child.type === 'storage_class_specifier' && (child.text === 'static' || child.text === 'extern'));
+          const scalarType = specifiers.some(child => TRACKED_TYPES.has(child.type));
+          for (const child of named(node)) {
+            if (!child.type.endsWith('declarator') && child.type !== 'identifier') continue;
+            if (child.type === 'init_declarator') {
+              // 初始化器中的名字在声明生效前解析
+              for (const part of named(child).slice(1)) visit(part);
+            }
+            const info = unwrapDeclarator(child);
+            if (!info || info.isFunction) continue;
+            const tracked = !isStatic && !info.isArray && (info.isPointer || scalarType);
+            this.declare(info.name, { isPointer: info.isPointer, isArray: info.isArray, isParameter: false, isStatic, tracked }, scopes);
+          }
+          return;
+        }
+        case 'identifier': {
+          const id = scopes.lookup(node.text);
+          if (id !== undefined) this.resolved.set(node, id);
+          return;
+        }
+        case 'sizeof_expression':
+          return;
+        default:
+          for (const child of named(node)) visit(child);
+      }
+    };
+
+    const body = childOfType(this.functionNode, 'compound_statement');
+    if (body) visit(body);
+  }
+
+  private variableOf(node: ASTNode | undefined): number | undefined {
+    return node && node.type === 'identifier' ? this.resolved.get(node) : undefined;
+  }
+
+  private push(events: FlowEvent[], kind: FlowEventKind, variable: number, node: ASTNode, conditional: boolean, value?: NullValue, source?: number): void {
+    events.push({ kind, variable, node, conditional, value, source });
+  }
+
+  /**
+   * 按求值顺序提取表达式/声明中的变量事件
+   */
+  private collectEvents(node: ASTNode, events: FlowEvent[], conditional: boolean): void {
+    switch (node.type) {
+      case 'declaration': {
+        for (const child of named(node)) {
+          if (child.type === 'init_declarator') {
+            const parts = named(child);
+            const value = parts[parts.length - 1];
+            if (value && parts.length > 1) this.collectEvents(value, events, conditional);
+            const info = unwrapDeclarator(child);
+            const variable = info ? this.resolved.get(info.name) : undefined;
+            if (variable !== undefined && value) {
+              const [nullValue, source] = this.classifyValue(value);
+              this.push(events, 'define', variable, info!.name, conditional, nullValue, source);
+            }
+          } else if (child.type.endsWith('declarator') || child.type === 'identifier') {
+            const info = unwrapDeclarator(child);
+            const variable = info ? this.resolved.get(info.name) : undefined;
+            if (variable !== undefined) this.push(events, 'declare', variable, info!.name, conditional);
+          }
+        }
+        return;
+      }
+      case 'identifier': {
+        const variable = this.variableOf(node);
+        if (variable !== undefined) this.push(events, 'read', variable, node, conditional);
+        return;
+      }
+      case 'assignment_expression': {
+        const parts = named(node);
+        const left = parts[0];
+        const right = parts[parts.length - 1];
+        const op = operatorOf(node);
+        const target = this.variableOf(stripParens(left));
+        if (target !== undefined) {
+          if (op !== '=') this.push(events, 'read', target, left, conditional);
+          if (right) this.collectEvents(right, events, conditional);
+          const [value, source] = op === '=' && right ? this.classifyValue(right) : ['nonnull' as NullValue, undefined];
+          this.push(events, 'define', target, left, conditional, value, source);
+        } else {
+          this.collectLvalue(left, events, conditional);
+          if (right) this.collectEvents(right, events, conditional);
+        }
+        return;
+      }
+      case 'update_expression': {
+        const operand = named(node)[0];
+        const variable = this.variableOf(operand && stripParens(operand));
+        if (variable !== undefined) {
+          this.push(events, 'read', variable, operand, conditional);
+          this.push(events, 'define', variable, operand, conditional, 'nonnull');
+        } else if (operand) {
+          this.collectLvalue(operand, events, conditional);
+        }
+        return;
+      }
+      case 'pointer_expression': {
+        const operand = named(node)[0];
+        if (!operand) return;
+        if (operatorOf(node) === '&') {
+          const base = this.baseVariable(operand);
+          if (base !== undefined) this.push(events, 'address', base, operand, conditional);
+          else this.collectEvents(operand, events, conditional);
+        } else {
+          this.collectDeref(operand, events, conditional);
+        }
+        return;
+      }
+      case 'field_expression': {
+        const object = named(node)[0];
+        if (!object) return;
+        if (node.children.some(child => isToken(child) && child.text === '->')) this.collectDeref(object, events, conditional);
+        else this.collectEvents(object, events, conditional);
+        return;
+      }
+      case 'subscript_expression': {
+        const [array, index] = named(node);
+        if (array) this.collectDeref(array, events, conditional);
+        if (index) this.collectEvents(index, events, conditional);
+        return;
+      }
+      case 'binary_expression': {
+        const [left, right] = named(node);
+        const op = operatorOf(node);
+        if (left) this.collectEvents(left, events, conditional);
+        if (right) this.collectEvents(right, events, conditional || op === '&&' || op === '||');
+        return;
+      }
+      case 'conditional_expression': {
+        const [condition, ...branches] = named(node);
+        if (condition) this.collectEvents(condition, events, conditional);
+        for (const branch of branches) this.collectEvents(branch, events, true);
+        return;
+      }
+      case 'sizeof_expression':
+        return;
+      default:
+        for (const child of named(node)) this.collectEvents(child, events, conditional);
+    }
+  }
+
+  /**
+   * 解引用操作数：*p / p->f / p[i] 中的 p 记为 deref，其余按普通表达式
+   */
+  private collectDeref(operand: ASTNode, events: FlowEvent[], conditional: boolean): void {
+    const stripped = stripParens(operand);
+    const variable = this.variableOf(stripped);
+    if (variable !== undefined) {
+      this.push(events, this.variables[variable].isPointer ? 'deref' : 'read', variable, stripped, conditional);
+    } else {
+      this.collectEvents(operand, events, conditional);
+    }
+  }
+
+  /**
+   * 非简单变量的左值（*p = / p->f = / a[i] =）：写入目标本身不读取旧值
+   */
+  private collectLvalue(left: ASTNode, events: FlowEvent[], conditional: boolean): void {
+    const target = stripParens(left);
+    if (target.type === 'field_expression' && !target.children.some(child => isToken(child) && child.text === '->')) {
+      // s.f = ...：对结构体变量的部分写入，视为取地址式的修改
+      const base = this.baseVariable(target);
+      if (base !== undefined) {
+        this.push(events, 'address', base, target, conditional);
+        return;
+      }
+    }
+    this.collectEvents(left, events, conditional);
+  }
+
+  /**
+   * &x / &x.f / &x[i] / s.f 中的基础变量（不经过指针）
+   */
+  private baseVariable(node: ASTNode): number | undefined {
+    let current = stripParens(node);
+    for (;;) {
+      if (current.type === 'identifier') return this.resolved.get(current);
+      if (current.type === 'field_expression' && !current.children.some(child => isToken(child) && child.text === '->')) {
+        current = stripParens(named(current)[0]);
+      } else if (current.type === 'subscript_expression') {
+        const array = named(current)[0];
+        const variable = this.variableOf(stripParens(array));
+        if (variable !== undefined && this.variables[variable].isPointer) return undefined;
+        current = stripParens(array);
+      } else {
+        return undefined;
+      }
+    }
+  }
+
+  private classifyValue(value: ASTNode): [NullValue, number | undefined] {
+    const expr = stripParens(value);
+    if (expr.type === 'null' || NULL_TEXT.has(expr.text.replace(/\s+/g, ''))) return ['null', undefined];
+    const source = this.variableOf(expr);
+    if (source !== undefined) return ['copy', source];
+    return ['nonnull', undefined];
+  }
+}
+
+/**
+ * 事件对变量事实的作用：prev 为事件前的值，source 为复制来源的值；
+ * 条件求值的事件不一定发生，保留之前的事实
+ */
+function transfer(event: FlowEvent, prev: number, source: number): number {
+  const kept = event.conditional ? prev : 0;
+  switch (event.kind) {
+    case 'declare':
+      return DECLARED | UNASSIGNED | (kept & DEFINED);
+    case 'address':
+      // 取地址后可能经由指针写入：视为已赋值且可能非空，但不是新的到达定义
+      return (prev & (DECLARED | DEFINED | NULLNESS)) | (kept & UNASSIGNED) | MAY_NONNULL;
+    default: {
+      let nullness: number;
+      if (event.value === 'copy' && event.source !== undefined) nullness = source & NULLNESS;
+      else nullness = event.value === 'null' ? MAY_NULL : MAY_NONNULL;
+      return DEFINED | (kept & (DECLARED | UNASSIGNED | NULLNESS)) | nullness;
+    }
+  }
+}
@@ -3,6 +3,8 @@
  * 支持动态启用/禁用各种检测功能
  */
 
+import { DataModel } from '../utils/c_types';
+
 export interface DetectorConfig {
   // 变量相关检测
   uninitializedVariables: boolean;
@@ -33,6 +35,9 @@ export interface DetectorConfig {
     enableParallelDetection: boolean;
     maxFileSize: number; // MB
     timeout: number; // seconds
+    dataModel: DataModel; // 目标数据模型，决定 long/size_t 等类型的位宽
+    summaryDatabase: string; // 函数摘要数据库路径，为空时不持久化
+    nullPathBudget: number; // 路径敏感空指针检查每个函数最多展开的 (块, 状态) 数
   };
 }
 
@@ -50,7 +55,10 @@ export const DEFAULT_CONFIG: DetectorConfig = {
     enableASTCache: true,
     enableParallelDetection: false,
     maxFileSize: 50,
-    timeout: 30
+    timeout: 30,
+    dataModel: 'LP64',
+    summaryDatabase: '',
+    nullPathBudget: 10000
   }
 };
 
@@ -1,4 +1,12 @@
 // AST 解析器：优先使用原生 tree-sitter，失败则回退到 web-tree-sitter(WASM)
+import { AnalysisSession } from '../analysis/session';
+import { StringInterner } from '../utils/interner';
+import { tracing, traceStart, traceSpan } from '../utils/trace';
+import { getLogger } from '../utils/logger';
+import { now } from '../utils/instrumentation';
+
+const log = getLogger('parser');
+
 let NativeParser: any = null;
 let NativeC: any = null;
 try {
@@ -44,8 +52,23 @@ export interface IncludeDirective {
   position: { row: number; column: number };
 }
 
+/**
+ * 解析后端：原生 tree-sitter、web-tree-sitter(WASM) 或 clang AST 转换
+ */
+export type ParserBackend = 'native' | 'wasm' | 'clang';
+
+// 节点类型只有语法规定的几百种，全部解析器共用一张表
+const nodeTypes = new StringInterner();
+
+// 文本需要驻留的节点：标识符在同一次扫描中大量重复；字面量与复合节点的文本几乎各不相同，不驻留
+const IDENTIFIER_TYPES = new Set(['identifier', 'field_identifier', 'type_identifier', 'primitive_type', 'statement_identifier']);
+
 export class CASTParser {
   private parser: any;
+  /** 本解析器（即一次扫描）内的标识符驻留表，随解析器释放 */
+  private readonly names = new StringInterner();
+  /** 实际使用的解析后端（由 create 按回退顺序确定） */
+  backend: ParserBackend = 'native';
 
   constructor(parser?: any) {
     if (parser) {
@@ -61,32 +84,44 @@ export class CASTParser {
     throw new Error('Native tree-sitter 不可用，请使用 CASTParser.create() (WASM)');
   }
 
-  static async create(): Promise<CASTParser> {
+  /**
+   * 按原生、WASM、clang 的顺序选用第一个可用的后端；指定 backend 时只尝试该后端，不可用则抛出
+   */
+  static async create(backend?: ParserBackend): Promise<CASTParser> {
     // 原生可用
-    if (NativeParser && NativeC) {
-      const p = new NativeParser();
-      p.setLanguage(NativeC);
-      return new CASTParser(p);
+    if (!backend || backend === 'native') {
+      if (NativeParser && NativeC) {
+        const p = new NativeParser();
+        p.setLanguage(NativeC);
+        return new CASTParser(p);
+      }
+      if (backend) throw new Error('Native tree-sitter 不可用');
     }
     // 优先使用 WASM（web-tree-sitter）
-    try {
-      const WTS = require('web-tree-sitter');
-      await WTS.init();
-      const path = require('path');
-      const fs = require('fs');
-      const candidates = [
-        path.join(process.cwd(), 'assets', 'grammars', 'tree-sitter-c.wasm'),
-        path.join(__dirname, '..', '..', 'assets', 'grammars', 'tree-sitter-c.wasm')
-      ];
-      const wasmPath = candidates.find((p: string) => fs.existsSync(p));
-      if (wasmPath) {
-        const C_lang = await WTS.Language.load(wasmPath);
-        const parser = new WTS();
-        parser.setLanguage(C_lang);
-        return new CASTParser(parser);
-      }
-    } catch (_) {
-      // 忽略，转入 clang 回退
+    if (!backend || backend === 'wasm') {
+      try {
+        const WTS = require('web-tree-sitter');
+        await WTS.init();
+        const path = require('path');
+        const fs = require('fs');
+        const candidates = [
+          path.join(process.cwd(), 'assets', 'grammars', 'tree-sitter-c.wasm'),
+          path.join(__dirname, '..', '..', 'assets', 'grammars', 'tree-sitter-c.wasm')
+        ];
+        const wasmPath = candidates.find((p: string) => fs.existsSync(p));
+        if (wasmPath) {
+          const C_lang = await WTS.Language.load(wasmPath);
+          const parser = new WTS();
+          parser.setLanguage(C_lang);
+          const result = new CASTParser(parser);
+          result.backend = 'wasm';
+          return result;
+        }
+        if (backend) throw new Error('找不到 tree-sitter-c.wasm');
+      } catch (error) {
+        // 自动选择时忽略，转入 clang 回退
+        if (backend) throw error;
+      }
     }
 
     // 最终回退：使用 clang -Xclang -ast-dump=json 生成 AST 并转换
@@ -94,7 +129,13 @@ export class CASTParser {
     const fs = require('fs');
     const os = require('os');
     const path = require('path');
+    if (backend === 'clang') {
+      // 显式选择时先确认 clang 可执行，避免到解析时才逐个文件失败
+      cp.execSync('clang --version', { stdio: 'ignore' });
+    }
 
+    // 本解析器的标识符驻留表（clang 路径不经过 convertNode）
+    const names = new StringInterner();
     const clangParser = {
       // 智能修复截断的 JSON
       fixTruncatedJson(json: string): string | null {
@@ -175,7 +216,7 @@ export class CASTParser {
           // clang 可能因为头文件错误而失败，但仍可能生成部分 AST
           jsonRaw = (e.stdout ? e.stdout.toString() : '') + '\n' + (e.stderr ? e.stderr.toString() : '');
           if (!jsonRaw.includes('{')) {
-            console.log(`Clang AST 生成失败: ${e.message}`);
+            log.warn('Clang AST 生成失败', { error: e.message });
             return { type: 'translation_unit', text: '', startPosition: { row: 0, column: 0 }, endPosition: { row: 0, column: 0 }, children: [], namedChildren: [] } as any;
           }
         } finally {
@@ -186,7 +227,7 @@ export class CASTParser {
         const jsonStart = jsonRaw.indexOf('{');
         const jsonEnd = jsonRaw.lastIndexOf('}');
         if (jsonStart === -1 || jsonEnd === -1) {
-          console.log('无法找到有效的 JSON 结构');
+          log.warn('无法找到有效的 JSON 结构');
           return { type: 'translation_unit', text: '', startPosition: { row: 0, column: 0 }, endPosition: { row: 0, column: 0 }, children: [], namedChildren: [] } as any;
         }
         
@@ -196,24 +237,22 @@ export class CASTParser {
         let rootJson;
         try {
           rootJson = JSON.parse(cleanJson);
-          console.log(`Clang AST JSON 解析成功，长度: ${cleanJson.length}`);
-          console.log(`Clang AST 根节点类型: ${rootJson?.kind}`);
+          if (log.debugEnabled) log.debug('Clang AST JSON 解析成功', { length: cleanJson.length, root: rootJson?.kind });
         } catch (parseError: any) {
-          console.log(`JSON 解析失败，尝试智能修复: ${parseError.message}`);
+          log.debug('JSON 解析失败，尝试智能修复', { error: parseError.message });
           
           // 智能修复截断的 JSON
           const fixedJson = this.fixTruncatedJson(cleanJson);
           if (fixedJson) {
             try {
               rootJson = JSON.parse(fixedJson);
-              console.log(`修复后 JSON 解析成功，长度: ${fixedJson.length}`);
-              console.log(`Clang AST 根节点类型: ${rootJson?.kind}`);
+              if (log.debugEnabled) log.debug('修复后 JSON 解析成功', { length: fixedJson.length, root: rootJson?.kind });
             } catch (fixError) {
-              console.log(`修复后仍然解析失败: ${fixError}`);
+              log.warn('修复后仍然解析失败', { error: String(fixError) });
               return { type: 'translation_unit', text: '', startPosition: { row: 0, column: 0 }, endPosition: { row: 0, column: 0 }, children: [], namedChildren: [] } as any;
             }
           } else {
-            console.log('无法修复 JSON，使用启发式回退');
+            log.warn('无法修复 JSON，使用启发式回退');
             return { type: 'translation_unit', text: '', startPosition: { row: 0, column: 0 }, endPosition: { row: 0, column: 0 }, children: [], namedChildren: [] } as any;
           }
         }
@@ -355,8 +394,9 @@ export class CASTParser {
           }
           
           const ast: any = {
-            type: typeMap[node?.kind] || node?.kind || 'unknown',
-            text: text,
+            type: nodeTypes.intern(typeMap[node?.kind] || node?.kind || 'unknown'),
+            // 只有声明与引用的名字驻留，字面量值保持原样
+            text: node?.name ? names.intern(text) : text,
             startPosition: toPos(node),
             endPosition: toPos(node?.range?.end ?? node),
             children: [],
@@ -406,6 +446,7 @@ export class CASTParser {
     };
 
     const parser = new CASTParser(clangParser);
+    parser.backend = 'clang';
     // 为 clang 解析器添加必要的方法
     parser.parse = clangParser.parse;
     return parser;
@@ -416,16 +457,40 @@ export class CASTParser {
    */
   parse(sourceCode: string): ASTNode {
     const tree = this.parser.parse(sourceCode);
-    return this.convertNode(tree.rootNode);
+    const start = traceStart();
+    const root = this.convertNode(tree.rootNode);
+    if (tracing.enabled) traceSpan('convert', 'parse', start, { backend: this.backend });
+    // 转换后不再引用原始语法树；WASM 的树占用 WASM 线性内存，必须显式释放
+    tree.delete?.();
+    return root;
+  }
+
+  /**
+   * 解析并分别计时后端解析与节点转换（毫秒）；clang 后端在其 parse 内完成转换，全部计入 parseMs
+   */
+  parseTimed(sourceCode: string): { ast: ASTNode; parseMs: number; convertMs: number } {
+    let start = now();
+    if (this.backend === 'clang') {
+      const ast = this.parse(sourceCode);
+      return { ast, parseMs: now() - start, convertMs: 0 };
+    }
+    const tree = this.parser.parse(sourceCode);
+    const parseMs = now() - start;
+    start = now();
+    const ast = this.convertNode(tree.rootNode);
+    const convertMs = now() - start;
+    tree.delete?.();
+    return { ast, parseMs, convertMs };
   }
 
   /**
    * 转换 tree-sitter 节点为我们的 ASTNode 接口
    */
   private convertNode(node: any, parent?: ASTNode): ASTNode {
+    // 节点类型与标识符文本驻留，重复出现的只保存一份
     const astNode: ASTNode = {
-      type: node.type,
-      text: node.text,
+      type: nodeTypes.intern(node.type),
+      text: IDENTIFIER_TYPES.has(node.type) ? this.names.intern(node.text) : node.text,
       startPosition: node.startPosition,
       endPosition: node.endPosition,
       children: [],
@@ -463,10 +528,11 @@ export class CASTParser {
   extractVariableDeclarations(root: ASTNode, sourceLines: string[]): VariableDeclaration[] {
     const declarations: VariableDeclaration[] = [];
     const currentScope = this.getCurrentScope(root);
-    const nodeTypes = new Set<string>();
+    // 节点类型集合只用于调试输出
+    const nodeTypes = log.debugEnabled ? new Set<string>() : undefined;
 
     this.traverseNode(root, (node) => {
-      nodeTypes.add(node.type);
+      nodeTypes?.add(node.type);
       if (node.type === 'declaration' || node.type === 'VarDecl' || node.type === 'DeclStmt') {
         const vars = this.parseDeclaration(node, currentScope, sourceLines);
         declarations.push(...vars);
@@ -476,7 +542,7 @@ export class CASTParser {
       }
     });
 
-    console.log(`    Node types found in AST: ${Array.from(nodeTypes).join(', ')}`);
+    if (nodeTypes) log.debug('变量声明提取完成', { declarations: declarations.length, nodeTypes: Array.from(nodeTypes) });
     return declarations;
   }
 
@@ -526,22 +592,22 @@ export class CASTParser {
     this.traverseNode(root, (node) => {
       if (node.type === 'identifier' || node.type === 'DeclRefExpr') {
         identifierCount++;
-        console.log(`    Found identifier '${node.text}' at line ${node.startPosition.row + 1}, type: ${node.type}`);
+        if (log.traceEnabled) log.trace('标识符', { name: node.text, line: node.startPosition.row + 1, type: node.type });
       }
       
       // 检查多种可能的节点类型
       if ((node.type === 'identifier' || node.type === 'DeclRefExpr' || node.type === 'unknown') && 
           node.text === variableName) {
-        console.log(`    Found identifier '${variableName}' at line ${node.startPosition.row + 1}, type: ${node.type}, isDeclaration: ${this.isDeclaration(node)}`);
         // 确保这是一个变量引用而不是声明
-        if (!this.isDeclaration(node)) {
-          console.log(`    Found usage of '${variableName}' at line ${node.startPosition.row + 1}, type: ${node.type}`);
+        const declaration = this.isDeclaration(node);
+        if (log.traceEnabled) log.trace('变量出现', { name: variableName, line: node.startPosition.row + 1, type: node.type, declaration });
+        if (!declaration) {
           usages.push(node.startPosition);
         }
       }
     });
 
-    console.log(`    Total identifiers found: ${identifierCount}`);
+    if (log.debugEnabled) log.debug('变量使用查找完成', { name: variableName, identifiers: identifierCount, usages: usages.length });
     return usages;
   }
 
@@ -603,7 +669,15 @@ export class CASTParser {
    * 检查循环是否可能是死循环
    */
   isInfiniteLoop(loopNode: ASTNode): boolean {
-    // 检查 for(;;) 或 while(1) 等明显的死循环
+    // 优先使用所在函数的控制流图：从循环头无法离开循环（无 break/return/goto 出口/exit()，条件恒真）
+    const session = AnalysisSession.forNode(loopNode);
+    const fn = session.enclosingFunction(loopNode);
+    const loop = fn ? session.cfg(fn).loopAt(loopNode) : undefined;
+    if (fn && loop) {
+      return !session.cfg(fn).loopCanExit(loop);
+    }
+
+    // 不在函数体内（或无法定位）时退回到 for(;;) / while(1) 的子树检查
     if (loopNode.type === 'for_statement') {
       const condition = this.findChildByType(loopNode, 'binary_expression');
       if (!condition) {
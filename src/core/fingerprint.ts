@@ -0,0 +1,133 @@
+// 问题指纹与基线比对：指纹由文件相对路径、类别、所在函数、规范化后的代码行以及同键问题的序号哈希得到，
+// 不含行号，插入或删除无关代码后保持不变；基线文件只保存排好序的指纹，比对为一次哈希集合查询
+
+import * as fs from 'fs';
+import { Issue } from '../interfaces/types';
+import { BracketIndex } from '../utils/bracket_index';
+
+const BASELINE_MAGIC = 'CSFP';
+const BASELINE_VERSION = 1;
+// 魔数 + 版本 + 条数
+const HEADER_SIZE = 12;
+
+/**
+ * 为同一文件的问题填写 fingerprint；file 应为相对扫描根目录的路径，保证不同检出位置之间可比
+ */
+export function assignFingerprints(issues: Issue[], file: string, content: string): void {
+  if (issues.length === 0) return;
+  const functions = BracketIndex.build(content).enclosingFunctions();
+  const ordinals = new Map<string, number>();
+  const relative = file.split('\\').join('/');
+  for (const issue of issues) {
+    const code = issue.codeLine.trim().replace(/\s+/g, ' ');
+    const key = `${relative}\u0000${issue.category}\u0000${functions[issue.line - 1] ?? ''}\u0000${code}`;
+    const ordinal = ordinals.get(key) ?? 0;
+    ordinals.set(key, ordinal + 1);
+    issue.fingerprint = fingerprintText(hash53(`${key}\u0000${ordinal}`));
+  }
+}
+
+/**
+ * 基线指纹集合
+ */
+export class FingerprintBaseline {
+  private readonly values: Set<number>;
+  private readonly seen = new Set<number>();
+
+  private constructor(values: Iterable<number>) {
+    this.values = new Set(values);
+  }
+
+  get size(): number {
+    return this.values.size;
+  }
+
+  /**
+   * 读取基线文件：'CSFP'、版本号、条数（uint32 LE）后接升序的 float64 LE 指纹
+   */
+  static load(file: string): FingerprintBaseline {
+    const buffer = fs.readFileSync(file);
+    if (buffer.length < HEADER_SIZE || buffer.toString('latin1', 0, 4) !== BASELINE_MAGIC) {
+      throw new Error(`不是有效的基线文件: ${file}`);
+    }
+    const version = buffer.readUInt32LE(4);
+    if (version !== BASELINE_VERSION) {
+      throw new Error(`不支持的基线版本 ${version}: ${file}`);
+    }
+    const count = buffer.readUInt32LE(8);
+    if (buffer.length < HEADER_SIZE + count * 8) {
+      throw new Error(`基线文件已截断: ${file}`);
+    }
+    const values: number[] = new Array(count);
+    for (let i = 0; i < count; i++) values[i] = buffer.readDoubleLE(HEADER_SIZE + i * 8);
+    return new FingerprintBaseline(values);
+  }
+
+  /**
+   * 写出基线文件（排序后写出，内容只与指纹集合有关）；指纹以 fingerprintValue 的数值给出
+   */
+  static save(file: string, fingerprints: Set<number>): number {
+    const values = Float64Array.from(fingerprints).sort();
+    const buffer = Buffer.alloc(HEADER_SIZE + values.length * 8);
+    buffer.write(BASELINE_MAGIC, 0, 'latin1');
+    buffer.writeUInt32LE(BASELINE_VERSION, 4);
+    buffer.writeUInt32LE(values.length, 8);
+    values.forEach((value, i) => buffer.writeDoubleLE(value, HEADER_SIZE + i * 8));
+    fs.writeFileSync(file, buffer);
+    return values.length;
+  }
+
+  /**
+   * 基线中没有的问题；同时记下已出现的基线指纹，用于之后统计已修复的问题
+   */
+  newIssues(issues: Issue[]): Issue[] {
+    return issues.filter(issue => {
+      if (!issue.fingerprint) return true;
+      const value = fingerprintValue(issue.fingerprint);
+      if (!this.values.has(value)) return true;
+      this.seen.add(value);
+      return false;
+    });
+  }
+
+  /**
+   * 基线中有、本次扫描未再出现的指纹
+   */
+  fixed(): string[] {
+    const result: string[] = [];
+    for (const value of this.values) {
+      if (!this.seen.has(value)) result.push(fingerprintText(value));
+    }
+    return result;
+  }
+}
+
+// cyrb53：两路 32 位乘法哈希合成 53 位，可无损存为 double
+function hash53(text: string): number {
+  let h1 = 0xdeadbeef;
+  let h2 = 0x41c6ce57;
+  for (let i = 0; i < text.length; i++) {
+    const ch = text.charCodeAt(i);
+    h1 = Math.imul(h1 ^ ch, 2654435761);
+    h2 = Math.imul(h2 ^ ch, 1597334677);
+  }
+  h1 = Math.imul(h1 ^ (h1 >>> 16), 2246822507);
+  h1 ^= Math.imul(h2 ^ (h2 >>> 13), 3266489909);
+  h2 = Math.imul(h2 ^ (h2 >>> 16), 2246822507);
+  h2 ^= Math.imul(h1 ^ (h1 >>> 13), 3266489909);
+  return 4294967296 * (2097151 & h2) + (h1 >>> 0);
+}
+
+/**
+ * 53 位指纹值的文本形式（14 位十六进制）
+ */
+export function fingerprintText(value: number): string {
+  return value.toString(16).padStart(14, '0');
+}
+
+/**
+ * 指纹文本对应的 53 位数值
+ */
+export function fingerprintValue(text: string): number {
+  return parseInt(text, 16);
+}
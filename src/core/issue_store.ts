@@ -0,0 +1,270 @@
+// 列式问题存储：文件、类别、消息模板与参数以存储自有字典中的 id 保存在定长类型数组中，
+// 指纹以 53 位数值保存，每条问题只占若干个数字；分组、计数与去重直接在数值列上进行，需要时才还原为 Issue 对象。
+// 字典随存储（及由它派生的去重结果）一起释放，不进入任何进程级的表
+
+import { Issue } from '../interfaces/types';
+import { StringInterner } from '../utils/interner';
+import { fingerprintText, fingerprintValue } from './fingerprint';
+
+export type IssueKey = 'file' | 'category';
+
+// 消息中的可变部分：引号或尖括号中的内容与数字
+const SLOT_PATTERN = /'([^'\n]*)'|<([^>\n]*)>|(-?\b(?:0[xX][0-9a-fA-F]+|\d+)\b)/g;
+// 模板中的参数占位符
+const SLOT = '\u0000';
+
+/**
+ * 把消息拆成模板与参数：变量名、头文件名与数值换成占位符，同类消息共用一个模板
+ */
+export function splitMessage(message: string): { template: string; params: string[] } {
+  const params: string[] = [];
+  const template = message.replace(SLOT_PATTERN, (match: string, quoted?: string, angled?: string, number?: string) => {
+    if (quoted !== undefined) {
+      params.push(quoted);
+      return `'${SLOT}'`;
+    }
+    if (angled !== undefined) {
+      params.push(angled);
+      return `<${SLOT}>`;
+    }
+    params.push(number ?? match);
+    return SLOT;
+  });
+  return { template, params };
+}
+
+function joinMessage(template: string, params: readonly string[]): string {
+  let next = 0;
+  return template.replace(/\u0000/g, () => params[next++] ?? '');
+}
+
+export class IssueStore {
+  private count = 0;
+  private fileColumn: Int32Array;
+  private categoryColumn: Int32Array;
+  private lineColumn: Int32Array;
+  private templateColumn: Int32Array;
+  // 源码行各不相同，不进字典
+  private codeLines: string[] = [];
+  // 53 位稳定指纹，没有指纹时为 -1
+  private fingerprintColumn: Float64Array;
+  // 去重用的行哈希：有稳定指纹时只取指纹，否则取文件、类别、行号与消息
+  private hashColumn: Uint32Array;
+  // 第 i 条问题的参数是 params[paramStart[i] .. paramStart[i + 1])
+  private paramStart: Int32Array;
+  private params: Int32Array;
+  private paramCount = 0;
+
+  /**
+   * dictionary 只在派生存储（如 unique 的结果）与来源共用字典时传入
+   */
+  constructor(capacity: number = 1024, private readonly dictionary: StringInterner = new StringInterner()) {
+    capacity = Math.max(1, capacity);
+    this.fileColumn = new Int32Array(capacity);
+    this.categoryColumn = new Int32Array(capacity);
+    this.lineColumn = new Int32Array(capacity);
+    this.templateColumn = new Int32Array(capacity);
+    this.fingerprintColumn = new Float64Array(capacity);
+    this.hashColumn = new Uint32Array(capacity);
+    this.paramStart = new Int32Array(capacity + 1);
+    this.params = new Int32Array(capacity * 2);
+  }
+
+  static from(issues: Iterable<Issue>): IssueStore {
+    const store = new IssueStore();
+    store.addAll(issues);
+    return store;
+  }
+
+  get length(): number {
+    return this.count;
+  }
+
+  add(issue: Issue): number {
+    if (this.count === this.fileColumn.length) this.grow();
+    const { template, params } = splitMessage(issue.message);
+    while (this.paramCount + params.length > this.params.length) {
+      this.params = resize(this.params, this.params.length * 2);
+    }
+    const i = this.count++;
+    this.fileColumn[i] = this.dictionary.id(issue.file);
+    this.categoryColumn[i] = this.dictionary.id(issue.category);
+    this.lineColumn[i] = issue.line;
+    this.templateColumn[i] = this.dictionary.id(template);
+    this.codeLines[i] = issue.codeLine;
+    this.fingerprintColumn[i] = issue.fingerprint ? fingerprintValue(issue.fingerprint) : -1;
+    for (const param of params) this.params[this.paramCount++] = this.dictionary.id(param);
+    this.paramStart[i + 1] = this.paramCount;
+    this.hashColumn[i] = this.hashRow(i);
+    return i;
+  }
+
+  addAll(issues: Iterable<Issue>): void {
+    for (const issue of issues) this.add(issue);
+  }
+
+  file(i: number): string {
+    return this.dictionary.get(this.fileColumn[i]);
+  }
+
+  category(i: number): string {
+    return this.dictionary.get(this.categoryColumn[i]);
+  }
+
+  line(i: number): number {
+    return this.lineColumn[i];
+  }
+
+  fingerprint(i: number): string | undefined {
+    return this.fingerprintColumn[i] >= 0 ? fingerprintText(this.fingerprintColumn[i]) : undefined;
+  }
+
+  message(i: number): string {
+    const params: string[] = [];
+    for (let p = this.paramStart[i]; p < this.paramStart[i + 1]; p++) params.push(this.dictionary.get(this.params[p]));
+    return joinMessage(this.dictionary.get(this.templateColumn[i]), params);
+  }
+
+  /**
+   * 还原为 Issue 对象
+   */
+  get(i: number): Issue {
+    const issue: Issue = {
+      file: this.file(i),
+      line: this.lineColumn[i],
+      category: this.category(i),
+      message: this.message(i),
+      codeLine: this.codeLines[i]
+    };
+    const fingerprint = this.fingerprint(i);
+    if (fingerprint) issue.fingerprint = fingerprint;
+    return issue;
+  }
+
+  *[Symbol.iterator](): IterableIterator<Issue> {
+    for (let i = 0; i < this.count; i++) yield this.get(i);
+  }
+
+  /**
+   * 按文件或类别计数
+   */
+  countBy(key: IssueKey): Map<string, number> {
+    const column = this.column(key);
+    const counts = new Map<number, number>();
+    for (let i = 0; i < this.count; i++) counts.set(column[i], (counts.get(column[i]) || 0) + 1);
+    const result = new Map<string, number>();
+    for (const [id, n] of counts) result.set(this.dictionary.get(id), n);
+    return result;
+  }
+
+  /**
+   * 按文件或类别分组，值为问题下标（保持插入顺序）
+   */
+  groupBy(key: IssueKey): Map<string, Int32Array> {
+    const column = this.column(key);
+    const counts = new Map<number, number>();
+    for (let i = 0; i < this.count; i++) counts.set(column[i], (counts.get(column[i]) || 0) + 1);
+    const groups = new Map<number, { rows: Int32Array; size: number }>();
+    for (const [id, n] of counts) groups.set(id, { rows: new Int32Array(n), size: 0 });
+    for (let i = 0; i < this.count; i++) {
+      const group = groups.get(column[i])!;
+      group.rows[group.size++] = i;
+    }
+    const result = new Map<string, Int32Array>();
+    for (const [id, group] of groups) result.set(this.dictionary.get(id), group.rows);
+    return result;
+  }
+
+  /**
+   * 按指纹去重后的新存储（保留每组第一次出现的问题）；没有稳定指纹的问题按文件、类别、行号与消息比较
+   */
+  unique(): IssueStore {
+    const seen = new Map<number, number[]>();
+    const result = new IssueStore(this.count, this.dictionary);
+    for (let i = 0; i < this.count; i++) {
+      const hash = this.hashColumn[i];
+      const rows = seen.get(hash);
+      if (rows && rows.some(row => this.sameRow(row, i))) continue;
+      if (rows) rows.push(i);
+      else seen.set(hash, [i]);
+      result.copyRow(this, i);
+    }
+    return result;
+  }
+
+  private column(key: IssueKey): Int32Array {
+    return key === 'file' ? this.fileColumn : this.categoryColumn;
+  }
+
+  private copyRow(source: IssueStore, i: number): void {
+    if (this.count === this.fileColumn.length) this.grow();
+    const from = source.paramStart[i];
+    const to = source.paramStart[i + 1];
+    while (this.paramCount + (to - from) > this.params.length) {
+      this.params = resize(this.params, this.params.length * 2);
+    }
+    const j = this.count++;
+    this.fileColumn[j] = source.fileColumn[i];
+    this.categoryColumn[j] = source.categoryColumn[i];
+    this.lineColumn[j] = source.lineColumn[i];
+    this.templateColumn[j] = source.templateColumn[i];
+    this.codeLines[j] = source.codeLines[i];
+    this.fingerprintColumn[j] = source.fingerprintColumn[i];
+    this.hashColumn[j] = source.hashColumn[i];
+    this.params.set(source.params.subarray(from, to), this.paramCount);
+    this.paramCount += to - from;
+    this.paramStart[j + 1] = this.paramCount;
+  }
+
+  private sameRow(a: number, b: number): boolean {
+    if (this.fingerprintColumn[a] >= 0 || this.fingerprintColumn[b] >= 0) {
+      return this.fingerprintColumn[a] === this.fingerprintColumn[b];
+    }
+    if (this.fileColumn[a] !== this.fileColumn[b] || this.categoryColumn[a] !== this.categoryColumn[b] ||
+        this.lineColumn[a] !== this.lineColumn[b] || this.templateColumn[a] !== this.templateColumn[b]) return false;
+    const start = this.paramStart[a];
+    const size = this.paramStart[a + 1] - start;
+    if (size !== this.paramStart[b + 1] - this.paramStart[b]) return false;
+    for (let k = 0; k < size; k++) {
+      if (this.params[start + k] !== this.params[this.paramStart[b] + k]) return false;
+    }
+    return true;
+  }
+
+  // FNV-1a：稳定指纹的高低两半，或文件、类别、行号、模板与参数 id
+  private hashRow(i: number): number {
+    let hash = 0x811c9dc5;
+    const mix = (value: number) => {
+      hash = Math.imul(hash ^ value, 0x01000193) >>> 0;
+    };
+    const fingerprint = this.fingerprintColumn[i];
+    if (fingerprint >= 0) {
+      mix(fingerprint % 4294967296);
+      mix(Math.floor(fingerprint / 4294967296));
+      return hash;
+    }
+    mix(this.fileColumn[i]);
+    mix(this.categoryColumn[i]);
+    mix(this.lineColumn[i]);
+    mix(this.templateColumn[i]);
+    for (let p = this.paramStart[i]; p < this.paramStart[i + 1]; p++) mix(this.params[p]);
+    return hash;
+  }
+
+  private grow(): void {
+    const capacity = this.fileColumn.length * 2;
+    this.fileColumn = resize(this.fileColumn, capacity);
+    this.categoryColumn = resize(this.categoryColumn, capacity);
+    this.lineColumn = resize(this.lineColumn, capacity);
+    this.templateColumn = resize(this.templateColumn, capacity);
+    this.fingerprintColumn = resize(this.fingerprintColumn, capacity);
+    this.hashColumn = resize(this.hashColumn, capacity);
+    this.paramStart = resize(this.paramStart, capacity + 1);
+  }
+}
+
+function resize<T extends Int32Array | Uint32Array | Float64Array>(array: T, capacity: number): T {
+  const next = new (array.constructor as { new (length: number): T })(capacity);
+  next.set(array);
+  return next;
+}
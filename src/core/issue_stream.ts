@@ -0,0 +1,193 @@
+// 流式问题输出：每个文件分析完立即写出，不在内存中累积全部 Issue；
+// 写入遵循可写流的背压（write 返回 false 时等待 drain），结束时追加一条汇总记录
+
+import * as fs from 'fs';
+import * as path from 'path';
+import { once } from 'events';
+import { Issue } from '../interfaces/types';
+
+export type OutputFormat = 'text' | 'sarif' | 'jsonl';
+
+export const OUTPUT_FORMATS: readonly OutputFormat[] = ['text', 'sarif', 'jsonl'];
+
+/**
+ * 逐文件接收问题的回调（流式输出时代替返回值数组）
+ */
+export type IssueSink = (file: string, issues: Issue[]) => Promise<void>;
+
+/**
+ * 汇总记录：只保存计数，与问题总数无关
+ */
+export interface IssueSummary {
+  files: number;
+  issues: number;
+  categories: Record<string, number>;
+  /** 与基线比对时，基线中已不再出现的问题数 */
+  fixed?: number;
+}
+
+const SARIF_SCHEMA = 'https://json.schemastore.org/sarif-2.1.0.json';
+const SARIF_FINGERPRINT = 'cscan/v1';
+
+export abstract class IssueWriter {
+  protected readonly summary: IssueSummary = { files: 0, issues: 0, categories: {} };
+  private started = false;
+
+  constructor(
+    private readonly out: NodeJS.WritableStream,
+    private readonly ownsStream: boolean,
+    /** 输出的是相对基线新增的问题 */
+    protected readonly baseline: boolean = false
+  ) {}
+
+  /**
+   * 写到文件；未给出路径时写到标准输出
+   */
+  static open(format: Exclude<OutputFormat, 'text'>, file?: string, baseline: boolean = false): IssueWriter {
+    const out = file ? fs.createWriteStream(file, { encoding: 'utf8' }) : process.stdout;
+    return format === 'sarif' ? new SarifWriter(out, !!file, baseline) : new JsonLinesWriter(out, !!file, baseline);
+  }
+
+  /**
+   * 写出一个文件的全部问题
+   */
+  async writeFile(file: string, issues: Issue[]): Promise<void> {
+    await this.begin();
+    this.summary.files++;
+    for (const issue of issues) {
+      this.summary.issues++;
+      this.summary.categories[issue.category] = (this.summary.categories[issue.category] || 0) + 1;
+      await this.write(this.record(issue));
+    }
+  }
+
+  /**
+   * 写出基线中已修复（本次未再出现）的指纹
+   */
+  async writeFixed(fingerprints: string[]): Promise<void> {
+    await this.begin();
+    this.summary.fixed = (this.summary.fixed || 0) + fingerprints.length;
+    for (const fingerprint of fingerprints) {
+      await this.write(this.fixedRecord(fingerprint));
+    }
+  }
+
+  /**
+   * 写出汇总并关闭输出（标准输出只刷新不关闭）
+   */
+  async close(): Promise<IssueSummary> {
+    await this.begin();
+    await this.write(this.footer());
+    if (this.ownsStream) {
+      const finished = once(this.out, 'finish');
+      this.out.end();
+      await finished;
+    }
+    return this.summary;
+  }
+
+  protected abstract header(): string;
+  protected abstract record(issue: Issue): string;
+  protected abstract fixedRecord(fingerprint: string): string;
+  protected abstract footer(): string;
+
+  private async begin(): Promise<void> {
+    if (!this.started) {
+      this.started = true;
+      await this.write(this.header());
+    }
+  }
+
+  private async write(chunk: string): Promise<void> {
+    if (chunk && !this.out.write(chunk)) {
+      await once(this.out, 'drain');
+    }
+  }
+}
+
+/**
+ * 每行一个 JSON 对象：{"type":"issue",...}、与基线比对时的 {"type":"fixed",...}，最后一行为 {"type":"summary",...}
+ */
+export class JsonLinesWriter extends IssueWriter {
+  protected header(): string {
+    return '';
+  }
+
+  protected record(issue: Issue): string {
+    return JSON.stringify({ type: 'issue', ...issue }) + '\n';
+  }
+
+  protected fixedRecord(fingerprint: string): string {
+    return JSON.stringify({ type: 'fixed', fingerprint }) + '\n';
+  }
+
+  protected footer(): string {
+    return JSON.stringify({ type: 'summary', ...this.summary }) + '\n';
+  }
+}
+
+/**
+ * SARIF 2.1.0：results 数组逐条写出，规则列表与汇总在结果之后补齐
+ */
+export class SarifWriter extends IssueWriter {
+  private first = true;
+
+  protected header(): string {
+    return `{"version":"2.1.0","$schema":${JSON.stringify(SARIF_SCHEMA)},"runs":[{"results":[\n`;
+  }
+
+  protected record(issue: Issue): string {
+    return this.result({
+      ruleId: issue.category,
+      level: 'warning',
+      message: { text: issue.message },
+      locations: [{
+        physicalLocation: {
+          artifactLocation: { uri: toUri(issue.file) },
+          region: { startLine: issue.line, snippet: { text: issue.codeLine } }
+        }
+      }],
+      partialFingerprints: issue.fingerprint ? { [SARIF_FINGERPRINT]: issue.fingerprint } : undefined,
+      baselineState: this.baseline ? 'new' : undefined
+    });
+  }
+
+  protected fixedRecord(fingerprint: string): string {
+    return this.result({
+      message: { text: '基线中的问题已不再出现' },
+      partialFingerprints: { [SARIF_FINGERPRINT]: fingerprint },
+      baselineState: 'absent'
+    });
+  }
+
+  private result(value: object): string {
+    const prefix = this.first ? '' : ',\n';
+    this.first = false;
+    return prefix + JSON.stringify(value);
+  }
+
+  protected footer(): string {
+    const tool = {
+      driver: {
+        name: 'cscan',
+        rules: Object.keys(this.summary.categories).map(id => ({ id, name: id }))
+      }
+    };
+    return `\n],"tool":${JSON.stringify(tool)},"properties":{"summary":${JSON.stringify(this.summary)}}}]}\n`;
+  }
+}
+
+function toUri(file: string): string {
+  return path.relative(process.cwd(), file).split(path.sep).join('/');
+}
+
+/**
+ * 解析 --format= 参数，未给出时为 text；无法识别时抛出错误
+ */
+export function parseOutputFormat(arg: string | undefined): OutputFormat {
+  const value = arg ? arg.slice(arg.indexOf('=') + 1) : 'text';
+  if (!(OUTPUT_FORMATS as readonly string[]).includes(value)) {
+    throw new Error(`未知输出格式: ${value}（可选 ${OUTPUT_FORMATS.join('、')}）`);
+  }
+  return value as OutputFormat;
+}
@@ -1,5 +1,8 @@
 import * as vscode from 'vscode';
 import { CASTParser, ASTNode, FunctionCall } from '../core/ast_parser';
+import { AnalysisSession, CALLS, TYPES } from '../analysis/session';
+import { integerRange, foldConstant } from '../utils/c_types';
+import { FormatFlavor, parseFormat } from '../utils/format_spec';
 
 /**
  * 基于 AST 的其他检测器
@@ -79,20 +82,6 @@ export class ASTAdvancedDetector {
   checkNumericRange(ast: ASTNode, sourceLines: string[]): vscode.Diagnostic[] {
     const diagnostics: vscode.Diagnostic[] = [];
     
-    // 定义类型范围
-    const typeRanges: { [key: string]: { min: number; max: number } } = {
-      'char': { min: -128, max: 127 },
-      'unsigned char': { min: 0, max: 255 },
-      'short': { min: -32768, max: 32767 },
-      'unsigned short': { min: 0, max: 65535 },
-      'int': { min: -2147483648, max: 2147483647 },
-      'unsigned int': { min: 0, max: 4294967295 },
-      'long': { min: -2147483648, max: 2147483647 }, // 32位系统
-      'unsigned long': { min: 0, max: 4294967295 },
-      'long long': { min: -9223372036854775808, max: 9223372036854775807 },
-      'unsigned long long': { min: 0, max: 18446744073709551615 }
-    };
-    
     // 查找赋值表达式
     this.traverseAST(ast, (node) => {
       if (node.type === 'assignment_expression') {
@@ -101,11 +90,12 @@ export class ASTAdvancedDetector {
         
         if (left && right && left.type === 'identifier') {
           // 获取变量类型
-          const varType = this.getVariableType(ast, left.text);
-          if (varType && typeRanges[varType]) {
-            const value = this.parseNumericValue(right.text);
-            if (value !== null) {
-              const range = typeRanges[varType];
+          const varType = this.getVariableType(ast, left);
+          const range = varType ? integerRange(varType) : null;
+          if (range) {
+            const folded = foldConstant(right.text);
+            if (folded && folded.kind === 'int') {
+              const value = folded.value;
               if (value < range.min || value > range.max) {
                 const vscodeRange = new vscode.Range(
                   new vscode.Position(node.startPosition.row, node.startPosition.column),
@@ -197,7 +187,7 @@ export class ASTAdvancedDetector {
   checkPrintfScanfFormats(ast: ASTNode): vscode.Diagnostic[] {
     const diagnostics: vscode.Diagnostic[] = [];
     
-    const functionCalls = this.parser.extractFunctionCalls(ast);
+    const functionCalls = AnalysisSession.for(ast).get(CALLS);
     
     for (const call of functionCalls) {
       if (['printf', 'fprintf', 'sprintf', 'scanf', 'fscanf', 'sscanf'].includes(call.name)) {
@@ -232,7 +222,7 @@ export class ASTAdvancedDetector {
     }
     
     const formatString = call.arguments[formatArgIndex];
-    const formatSpecCount = this.countFormatSpecifiers(formatString);
+    const formatSpecCount = this.countFormatSpecifiers(formatString, isScanf ? 'scanf' : 'printf');
     const providedArgs = call.arguments.length - formatArgIndex - 1;
     
     const range = new vscode.Range(
@@ -272,45 +262,13 @@ export class ASTAdvancedDetector {
   }
 
   /**
-   * 计算格式说明符数量
+   * 计算格式说明符消耗的参数数量（相邻字面量拼接后交给共享的格式解析器）
    */
-  private countFormatSpecifiers(formatString: string): number {
-    let count = 0;
-    let inString = false;
-    let escaped = false;
-    
-    for (let i = 0; i < formatString.length; i++) {
-      const char = formatString[i];
-      
-      if (char === '"' && !escaped) {
-        inString = !inString;
-        continue;
-      }
-      
-      if (!inString) {
-        continue;
-      }
-      
-      if (escaped) {
-        escaped = false;
-        continue;
-      }
-      
-      if (char === '\\') {
-        escaped = true;
-        continue;
-      }
-      
-      if (char === '%') {
-        if (i + 1 < formatString.length && formatString[i + 1] === '%') {
-          i++; // 跳过 %%
-          continue;
-        }
-        count++;
-      }
-    }
-    
-    return count;
+  private countFormatSpecifiers(formatString: string, flavor: FormatFlavor): number {
+    const literals = formatString.match(/"(?:\\.|[^"\\])*"/g);
+    if (!literals) return 0;
+    const format = literals.map(lit => lit.slice(1, -1)).join('');
+    return parseFormat(format, flavor).argCount;
   }
 
   /**
@@ -322,60 +280,11 @@ export class ASTAdvancedDetector {
   }
 
   /**
-   * 获取变量类型
+   * 获取变量类型（赋值处可见的声明类型，指针返回 null）
    */
-  private getVariableType(ast: ASTNode, varName: string): string | null {
-    let foundType: string | null = null;
-    
-    this.traverseAST(ast, (node) => {
-      if (node.type === 'declaration') {
-        const typeSpec = this.findChildByType(node, 'primitive_type') ||
-                        this.findChildByType(node, 'type_identifier');
-        if (typeSpec) {
-          const declarators = this.findChildrenByType(node, 'init_declarator') ||
-                             this.findChildrenByType(node, 'declarator');
-          
-          for (const declarator of declarators) {
-            const identifier = this.findIdentifierInDeclarator(declarator);
-            if (identifier && identifier.text === varName) {
-              foundType = typeSpec.text;
-              // 检查是否有 unsigned 修饰符
-              const parent = node;
-              if (parent.text.includes('unsigned')) {
-                foundType = 'unsigned ' + foundType;
-              }
-              return;
-            }
-          }
-        }
-      }
-    });
-    
-    return foundType;
-  }
-
-  /**
-   * 解析数值
-   */
-  private parseNumericValue(text: string): number | null {
-    // 去除空格
-    text = text.trim();
-    
-    // 十六进制
-    if (text.startsWith('0x') || text.startsWith('0X')) {
-      const num = parseInt(text, 16);
-      return isNaN(num) ? null : num;
-    }
-    
-    // 八进制
-    if (text.startsWith('0') && text.length > 1 && /^[0-7]+$/.test(text.slice(1))) {
-      const num = parseInt(text, 8);
-      return isNaN(num) ? null : num;
-    }
-    
-    // 十进制
-    const num = parseInt(text, 10);
-    return isNaN(num) ? null : num;
+  private getVariableType(ast: ASTNode, identifier: ASTNode): string | null {
+    const declared = AnalysisSession.for(ast).get(TYPES).lookup(identifier.text, identifier.startPosition);
+    return declared && declared.depth === 0 ? declared.base : null;
   }
 
   /**
@@ -387,47 +296,4 @@ export class ASTAdvancedDetector {
       this.traverseAST(child, callback);
     }
   }
-
-  /**
-   * 查找子节点
-   */
-  private findChildByType(node: ASTNode, type: string): ASTNode | null {
-    for (const child of node.namedChildren) {
-      if (child.type === type) {
-        return child;
-      }
-    }
-    return null;
-  }
-
-  /**
-   * 查找所有指定类型的子节点
-   */
-  private findChildrenByType(node: ASTNode, type: string): ASTNode[] {
-    const children: ASTNode[] = [];
-    for (const child of node.namedChildren) {
-      if (child.type === type) {
-        children.push(child);
-      }
-    }
-    return children;
-  }
-
-  /**
-   * 在声明器中查找标识符
-   */
-  private findIdentifierInDeclarator(node: ASTNode): ASTNode | null {
-    if (node.type === 'identifier') {
-      return node;
-    }
-    
-    for (const child of node.namedChildren) {
-      const identifier = this.findIdentifierInDeclarator(child);
-      if (identifier) {
-        return identifier;
-      }
-    }
-    
-    return null;
-  }
-}
\ No newline at end of file
+}
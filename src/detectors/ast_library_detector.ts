@@ -1,5 +1,6 @@
 import * as vscode from 'vscode';
 import { CASTParser, FunctionCall, IncludeDirective } from '../core/ast_parser';
+import { AnalysisSession, CALLS, INCLUDES } from '../analysis/session';
 
 /**
  * C 标准库函数到头文件的映射
@@ -175,13 +176,14 @@ export class ASTLibraryDetector {
     
     try {
       const ast = this.parser.parse(sourceCode);
+      const analyses = AnalysisSession.for(ast);
       
       // 提取所有 include 指令
-      const includes = this.parser.extractIncludeDirectives(ast);
+      const includes = analyses.get(INCLUDES);
       const includedHeaders = new Set(includes.map(inc => inc.headerName));
       
       // 提取所有函数调用
-      const functionCalls = this.parser.extractFunctionCalls(ast);
+      const functionCalls = analyses.get(CALLS);
       
       // 检查每个函数调用
       for (const call of functionCalls) {
@@ -226,13 +228,14 @@ export class ASTLibraryDetector {
     
     try {
       const ast = this.parser.parse(sourceCode);
+      const analyses = AnalysisSession.for(ast);
       
       // 提取所有 include 指令
-      const includes = this.parser.extractIncludeDirectives(ast);
+      const includes = analyses.get(INCLUDES);
       const includedHeaders = new Set(includes.map(inc => inc.headerName));
       
       // 提取所有函数调用
-      const functionCalls = this.parser.extractFunctionCalls(ast);
+      const functionCalls = analyses.get(CALLS);
       
       // 收集缺失的头文件
       for (const call of functionCalls) {
@@ -308,7 +311,7 @@ export class ASTLibraryDetector {
     
     try {
       const ast = this.parser.parse(sourceCode);
-      const includes = this.parser.extractIncludeDirectives(ast);
+      const includes = AnalysisSession.for(ast).get(INCLUDES);
       
       const standardHeaders = new Set([
         'stdio.h', 'stdlib.h', 'string.h', 'math.h', 'ctype.h',
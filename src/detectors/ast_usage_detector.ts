@@ -1,4 +1,5 @@
 import { Issue } from '../interfaces/types';
+import { AnalysisSession, CALLS, SYMBOLS } from '../analysis/session';
 
 export interface DetectionContext {
   filePath: string;
@@ -43,8 +44,9 @@ export class ASTUsageDetector {
 
     // Check if we can extract meaningful information from AST
     try {
-      const declarations = this.astParser.extractVariableDeclarations(context.ast, context.lines);
-      const functionCalls = this.astParser.extractFunctionCalls(context.ast);
+      const analyses = AnalysisSession.for(context.ast, context.lines);
+      const declarations = analyses.get(SYMBOLS);
+      const functionCalls = analyses.get(CALLS);
       
       if (declarations.length === 0 && functionCalls.length === 0) {
         issues.push({
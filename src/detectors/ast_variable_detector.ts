@@ -1,5 +1,7 @@
 import * as vscode from 'vscode';
 import { CASTParser, VariableDeclaration, ASTNode } from '../core/ast_parser';
+import { AnalysisSession, SYMBOLS } from '../analysis/session';
+import { DEFAULT_NULL_PATH_BUDGET } from '../analysis/null_paths';
 
 /**
  * 基于 AST 的变量检测器
@@ -32,7 +34,7 @@ export class ASTVariableDetector {
       const ast = this.parser.parse(sourceCode);
       
       // 提取所有变量声明
-      const declarations = this.parser.extractVariableDeclarations(ast, sourceLines);
+      const declarations = AnalysisSession.for(ast, sourceLines).get(SYMBOLS);
       
       // 创建变量映射，按作用域分组
       const variablesByScope = this.groupVariablesByScope(declarations);
@@ -156,44 +158,29 @@ export class ASTVariableDetector {
   }
 
   /**
-   * 检查空指针解引用
+   * 检查空指针解引用：路径敏感检查，只报告在每条可行路径上都为 NULL 的解引用
    */
-  checkNullPointerDereference(ast: ASTNode, sourceLines: string[]): vscode.Diagnostic[] {
+  checkNullPointerDereference(ast: ASTNode, sourceLines: string[], budget: number = DEFAULT_NULL_PATH_BUDGET): vscode.Diagnostic[] {
     const diagnostics: vscode.Diagnostic[] = [];
-    const declarations = this.parser.extractVariableDeclarations(ast, sourceLines);
+    const session = AnalysisSession.for(ast, sourceLines);
     
-    // 查找被赋值为 NULL 或 0 的指针
-    const nullPointers = declarations.filter(decl => 
-      decl.isPointer && this.isNullInitialized(sourceLines[decl.position.row])
-    );
-    
-    for (const pointer of nullPointers) {
-      const dereferences = this.parser.findPointerDereferences(ast, pointer.name);
-      
-      for (const deref of dereferences) {
-        // 检查解引用是否在 NULL 赋值之后
-        if (deref.row > pointer.position.row) {
-          const range = new vscode.Range(
-            new vscode.Position(deref.row, deref.column),
-            new vscode.Position(deref.row, deref.column + pointer.name.length + 2)
-          );
-          
-          diagnostics.push(new vscode.Diagnostic(
-            range,
-            `潜在空指针解引用：指针 '${pointer.name}' 可能为 NULL`,
-            vscode.DiagnosticSeverity.Error
-          ));
-        }
+    for (const fn of session.functions()) {
+      const paths = session.nullPaths(fn, budget);
+      for (const finding of paths.findings) {
+        const { row, column } = finding.node.startPosition;
+        const range = new vscode.Range(
+          new vscode.Position(row, column),
+          new vscode.Position(row, column + finding.variable.name.length)
+        );
+        
+        diagnostics.push(new vscode.Diagnostic(
+          range,
+          `潜在空指针解引用：指针 '${finding.variable.name}' 可能为 NULL`,
+          vscode.DiagnosticSeverity.Error
+        ));
       }
     }
     
     return diagnostics;
   }
-
-  /**
-   * 检查是否初始化为 NULL
-   */
-  private isNullInitialized(line: string): boolean {
-    return /=\s*(NULL|0)\b/.test(line);
-  }
-}
\ No newline at end of file
+}
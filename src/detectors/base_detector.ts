@@ -3,7 +3,12 @@
  * 定义所有检测器的通用接口和功能
  */
 
+import * as v8 from 'v8';
 import { Issue } from '../interfaces/types';
+import { AnalysisSession } from '../analysis/session';
+import { ProgramAnalysis } from '../analysis/program';
+import { instrumentation, now } from '../utils/instrumentation';
+import { tracing, traceStart, traceSpan } from '../utils/trace';
 
 export interface DetectionContext {
   filePath: string;
@@ -11,6 +16,49 @@ export interface DetectionContext {
   lines: string[];
   ast?: any;
   config: any;
+  /** 本文件共享的分析结果（符号、调用、CFG 等），有 AST 时由检测器管理器挂载 */
+  analyses?: AnalysisSession;
+  /** 全程序阶段（跨文件调用图与函数摘要），多文件扫描时提供 */
+  program?: ProgramAnalysis;
+}
+
+/**
+ * 检测器运行计数（开启 instrumentation 后由 run 记录；按检测器名称汇总，同名实例共用）
+ */
+export interface DetectorCounters {
+  wallTimeMs: number;
+  files: number;
+  lines: number;
+  /** 语法树节点访问次数（经 analysis/syntax 的 named 检查的子节点） */
+  astNodes: number;
+  /** 检测器正则调用点的执行次数 */
+  regexExecutions: number;
+  issues: number;
+  /** 运行前后 V8 堆用量（used_heap_size）增长之和（近似分配量，GC 会使其偏低） */
+  heapGrowthBytes: number;
+}
+
+export interface DetectorStats {
+  name: string;
+  enabled: boolean;
+  config: any;
+  counters?: DetectorCounters;
+}
+
+const counters = new Map<string, DetectorCounters>();
+
+/**
+ * 全部已记录的检测器计数（含未经检测器管理器创建的实例）
+ */
+export function detectorCounters(): Map<string, DetectorCounters> {
+  return new Map(Array.from(counters, ([name, record]) => [name, { ...record }]));
+}
+
+/**
+ * 清空全部检测器计数
+ */
+export function resetDetectorCounters(): void {
+  counters.clear();
 }
 
 export abstract class BaseDetector {
@@ -37,6 +85,58 @@ export abstract class BaseDetector {
    */
   abstract detect(context: DetectionContext): Promise<Issue[]>;
   
+  /**
+   * 执行检测；开启跟踪时记录一个跨度（lane 为并行检测时的通道号），开启计数时记录运行计数
+   */
+  async run(context: DetectionContext, lane: number = 0): Promise<Issue[]> {
+    if (!tracing.enabled) return this.measure(context);
+    const start = traceStart();
+    try {
+      return await this.measure(context);
+    } finally {
+      traceSpan(this.getName(), 'detector', start, { file: context.filePath }, lane);
+    }
+  }
+  
+  /**
+   * 执行检测并在开启计数时记录耗时、行数、节点访问、正则执行、问题数与堆增长
+   */
+  private async measure(context: DetectionContext): Promise<Issue[]> {
+    if (!instrumentation.enabled) return this.detect(context);
+    const name = this.getName();
+    let record = counters.get(name);
+    if (!record) {
+      record = { wallTimeMs: 0, files: 0, lines: 0, astNodes: 0, regexExecutions: 0, issues: 0, heapGrowthBytes: 0 };
+      counters.set(name, record);
+    }
+    const nodes = instrumentation.nodes;
+    const regex = instrumentation.regex;
+    const heap = v8.getHeapStatistics().used_heap_size;
+    const start = now();
+    try {
+      const issues = await this.detect(context);
+      record.issues += issues.length;
+      return issues;
+    } finally {
+      record.wallTimeMs += now() - start;
+      record.files++;
+      record.lines += context.lines.length;
+      record.astNodes += instrumentation.nodes - nodes;
+      record.regexExecutions += instrumentation.regex - regex;
+      record.heapGrowthBytes += Math.max(0, v8.getHeapStatistics().used_heap_size - heap);
+    }
+  }
+  
+  /**
+   * 本文件的分析会话；上下文尚未挂载时按 AST 创建，无 AST 时返回 undefined
+   */
+  protected analysesFor(context: DetectionContext): AnalysisSession | undefined {
+    if (!context.analyses && context.ast) {
+      context.analyses = AnalysisSession.for(context.ast, context.lines);
+    }
+    return context.analyses;
+  }
+  
   /**
    * 是否启用
    */
@@ -75,11 +175,14 @@ export abstract class BaseDetector {
   /**
    * 获取检测器统计信息
    */
-  getStats(): { name: string; enabled: boolean; config: any } {
-    return {
+  getStats(): DetectorStats {
+    const stats: DetectorStats = {
       name: this.getName(),
       enabled: this.enabled,
       config: this.config
     };
+    const record = counters.get(stats.name);
+    if (record) stats.counters = { ...record };
+    return stats;
   }
 }
@@ -5,6 +5,15 @@
 
 import { BaseDetector, DetectionContext } from './base_detector';
 import { Issue } from '../interfaces/types';
+import { countRegex } from '../utils/instrumentation';
+import { BracketIndex } from '../utils/bracket_index';
+import { DataModel, DEFAULT_DATA_MODEL } from '../utils/c_types';
+import { getLogger } from '../utils/logger';
+
+const log = getLogger('control_flow');
+
+// 循环体内视为退出条件的关键字
+const EXIT_WORDS = ['break', 'return', 'exit', 'goto', 'continue'];
 
 export class ControlFlowDetector extends BaseDetector {
   constructor(config: any, enabled: boolean = true) {
@@ -25,10 +34,54 @@ export class ControlFlowDetector extends BaseDetector {
     const issues: Issue[] = [];
     
     try {
-      // 使用启发式方法检测死循环
-      issues.push(...this.detectDeadLoops(context));
+      if (context.ast) {
+        issues.push(...this.detectDeadLoopsWithCFG(context));
+      } else {
+        // 无 AST 时使用启发式方法检测死循环
+        issues.push(...this.detectDeadLoops(context));
+      }
     } catch (error) {
-      console.error('ControlFlowDetector检测错误:', error);
+      log.error('ControlFlowDetector检测错误', { file: context.filePath, error: String(error) });
+    }
+    
+    return issues;
+  }
+  
+  /**
+   * 基于函数 CFG：从循环头出发无法到达循环外的任何块即为死循环；
+   * 结构上能退出的循环，再用区间分析排除条件恒不成立的出口边（如 unsigned i >= 0、计数方向反了）
+   */
+  private detectDeadLoopsWithCFG(context: DetectionContext): Issue[] {
+    const issues: Issue[] = [];
+    const session = this.analysesFor(context)!;
+    const model: DataModel = this.config.dataModel || DEFAULT_DATA_MODEL;
+    
+    for (const fn of session.functions()) {
+      const cfg = session.cfg(fn);
+      // 0 可以退出，1 结构上无出口，2 出口边按区间分析均不可行
+      const verdicts = cfg.loops.map(loop => {
+        if (!cfg.loopCanExit(loop)) return 1;
+        const ranges = session.intervals(fn, model);
+        return ranges.complete && !cfg.loopCanExitWithout(loop, (from, to) => ranges.isInfeasible(from, to)) ? 2 : 0;
+      });
+      // 内层已是死循环时，外层的条件边只是因为后续代码不可达才不可行，不重复报告
+      for (const loop of cfg.loops) {
+        for (let outer = loop.parent; verdicts[loop.id] !== 0 && outer >= 0; outer = cfg.loops[outer].parent) {
+          if (verdicts[outer] === 2) verdicts[outer] = 0;
+        }
+      }
+      for (const loop of cfg.loops) {
+        if (verdicts[loop.id] === 0) continue;
+        const message = verdicts[loop.id] === 1 ? '检测到可能的死循环' : '检测到可能的死循环：循环的退出条件始终不成立';
+        const row = loop.node.startPosition.row;
+        issues.push({
+          file: context.filePath,
+          line: row + 1,
+          category: 'Dead loop',
+          message,
+          codeLine: context.lines[row] || ''
+        });
+      }
     }
     
     return issues;
@@ -36,6 +89,7 @@ export class ControlFlowDetector extends BaseDetector {
   
   private detectDeadLoops(context: DetectionContext): Issue[] {
     const issues: Issue[] = [];
+    let index: BracketIndex | undefined;
     
     for (let i = 0; i < context.lines.length; i++) {
       const line = context.lines[i];
@@ -61,27 +115,13 @@ export class ControlFlowDetector extends BaseDetector {
         /do\s*$/,  // do (行尾)
       ];
       
-      let foundLoop = false;
-      let loopType = '';
-      
-      for (const pattern of loopPatterns) {
-        if (pattern.test(cleanLine)) {
-          foundLoop = true;
-          if (pattern.source.includes('for')) {
-            loopType = 'for';
-          } else if (pattern.source.includes('while')) {
-            loopType = 'while';
-          } else if (pattern.source.includes('do')) {
-            loopType = 'do-while';
-          }
-          break;
-        }
-      }
+      const foundLoop = loopPatterns.some(pattern => { countRegex(); return pattern.test(cleanLine); });
       
       if (!foundLoop) continue;
       
-      // 检查循环体中是否有退出条件
-      const hasExitCondition = this.loopBodyHasExitCondition(context.lines, i, loopType);
+      // 检查循环体中是否有退出条件（括号索引按需构建，每个文件只扫描一次）
+      index = index || BracketIndex.build(context.content);
+      const hasExitCondition = this.loopBodyHasExitCondition(index, i);
       if (hasExitCondition) continue;
       
       issues.push({
@@ -96,69 +136,10 @@ export class ControlFlowDetector extends BaseDetector {
     return issues;
   }
   
-  private loopBodyHasExitCondition(lines: string[], loopStartIndex: number, loopType: string): boolean {
-    let i = loopStartIndex;
-    let braceDepth = 0;
-    let started = false;
-    
-    // 扫描最多200行作为上限，避免极端文件
-    const LIMIT = Math.min(lines.length, loopStartIndex + 200);
-    
-    // 退出条件模式
-    const exitPatterns = [
-      /\bbreak\s*;/,  // break;
-      /\breturn\b/,   // return
-      /\bexit\s*\(/,  // exit(
-      /\bgoto\s+\w+/, // goto label
-      /\bcontinue\s*;/, // continue;
-    ];
-    
-    // 如果当前行或后续行出现 '{' 则进入块扫描模式；否则尝试一行语句模式
-    for (; i < LIMIT; i++) {
-      const line = this.stripLineComments(lines[i]);
-      
-      if (!started) {
-        if (line.includes('{')) {
-          started = true;
-          braceDepth += this.countChar(line, '{');
-          braceDepth -= this.countChar(line, '}');
-          
-          // 检查当前行是否有退出条件
-          for (const pattern of exitPatterns) {
-            if (pattern.test(line)) return true;
-          }
-          
-          if (braceDepth === 0) break; // 单行块
-        } else if (i === loopStartIndex) {
-          // 可能是无花括号的单语句循环体，检查下一行及之后连续非空行直至分号结束
-          const nextIdx = i + 1;
-          if (nextIdx < lines.length) {
-            const nextLine = this.stripLineComments(lines[nextIdx]);
-            for (const pattern of exitPatterns) {
-              if (pattern.test(nextLine)) return true;
-            }
-          }
-          return false;
-        }
-      } else {
-        // 已进入块
-        for (const pattern of exitPatterns) {
-          if (pattern.test(line)) return true;
-        }
-        
-        braceDepth += this.countChar(line, '{');
-        braceDepth -= this.countChar(line, '}');
-        if (braceDepth <= 0) break;
-      }
-    }
-    
-    return false;
-  }
-  
-  private countChar(s: string, ch: string): number {
-    let c = 0;
-    for (let i = 0; i < s.length; i++) if (s[i] === ch) c++;
-    return c;
+  private loopBodyHasExitCondition(index: BracketIndex, loopStartIndex: number): boolean {
+    const body = index.loopBody(loopStartIndex);
+    if (!body) return false;
+    return EXIT_WORDS.some(word => index.rangeContains(body, word));
   }
   
   private stripLineComments(s: string): string {
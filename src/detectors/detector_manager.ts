@@ -3,7 +3,7 @@
  * 协调所有检测器的执行和管理
  */
 
-import { BaseDetector, DetectionContext } from './base_detector';
+import { BaseDetector, DetectionContext, DetectorStats } from './base_detector';
 import { VariableDetector } from './variable_detector';
 import { ControlFlowDetector } from './control_flow_detector';
 import { MemoryDetector } from './memory_detector';
@@ -12,6 +12,11 @@ import { FormatDetector } from './format_detector';
 import { HeaderDetector } from './header_detector';
 import { Issue } from '../interfaces/types';
 import { DetectorConfig } from '../config/detector_config';
+import { AnalysisSession } from '../analysis/session';
+import { instrumentation } from '../utils/instrumentation';
+import { getLogger } from '../utils/logger';
+
+const log = getLogger('detectors');
 
 export class DetectorManager {
   private detectors: Map<string, BaseDetector>;
@@ -28,11 +33,13 @@ export class DetectorManager {
     this.detectors.set('variable', new VariableDetector({
       uninitializedVariables: this.config.uninitializedVariables,
       wildPointers: this.config.wildPointers,
-      nullPointers: this.config.nullPointers
+      nullPointers: this.config.nullPointers,
+      nullPathBudget: this.config.advanced.nullPathBudget
     }, this.config.uninitializedVariables || this.config.wildPointers || this.config.nullPointers));
     
     this.detectors.set('controlFlow', new ControlFlowDetector({
-      deadLoops: this.config.deadLoops
+      deadLoops: this.config.deadLoops,
+      dataModel: this.config.advanced.dataModel
     }, this.config.deadLoops));
     
     this.detectors.set('memory', new MemoryDetector({
@@ -40,7 +47,8 @@ export class DetectorManager {
     }, this.config.memoryLeaks));
     
     this.detectors.set('numeric', new NumericDetector({
-      numericRange: this.config.numericRange
+      numericRange: this.config.numericRange,
+      dataModel: this.config.advanced.dataModel
     }, this.config.numericRange));
     
     this.detectors.set('format', new FormatDetector({
@@ -75,14 +83,15 @@ export class DetectorManager {
         return {
           uninitializedVariables: this.config.uninitializedVariables,
           wildPointers: this.config.wildPointers,
-          nullPointers: this.config.nullPointers
+          nullPointers: this.config.nullPointers,
+          nullPathBudget: this.config.advanced.nullPathBudget
         };
       case 'controlFlow':
-        return { deadLoops: this.config.deadLoops };
+        return { deadLoops: this.config.deadLoops, dataModel: this.config.advanced.dataModel };
       case 'memory':
         return { memoryLeaks: this.config.memoryLeaks };
       case 'numeric':
-        return { numericRange: this.config.numericRange };
+        return { numericRange: this.config.numericRange, dataModel: this.config.advanced.dataModel };
       case 'format':
         return { formatStrings: this.config.formatStrings };
       case 'header':
@@ -122,21 +131,27 @@ export class DetectorManager {
     
     // 并行执行所有启用的检测器
     const enabledDetectors = Array.from(this.detectors.values()).filter(d => d.isEnabled());
-    console.log(`[DEBUG] 启用的检测器: ${enabledDetectors.map(d => d.getName()).join(', ')}`);
+    if (log.debugEnabled) log.debug('启用的检测器', { file: context.filePath, detectors: enabledDetectors.map(d => d.getName()) });
+    
+    // 所有检测器共用同一个分析会话，派生事实每个文件只计算一次
+    if (context.ast && !context.analyses) {
+      context.analyses = AnalysisSession.for(context.ast, context.lines);
+    }
     
-    if (this.config.advanced.enableParallelDetection) {
+    // 开启计数时串行执行，保证节点与正则计数归属到正确的检测器
+    if (this.config.advanced.enableParallelDetection && !instrumentation.enabled) {
       // 并行执行
-      const promises = enabledDetectors.map(detector => detector.detect(context));
+      const promises = enabledDetectors.map((detector, i) => detector.run(context, i + 1));
       const results = await Promise.all(promises);
       results.forEach(issues => allIssues.push(...issues));
     } else {
       // 串行执行
       for (const detector of enabledDetectors) {
         try {
-          const issues = await detector.detect(context);
+          const issues = await detector.run(context);
           allIssues.push(...issues);
         } catch (error) {
-          console.error(`检测器 ${detector.getName()} 执行失败:`, error);
+          log.error('检测器执行失败', { detector: detector.getName(), file: context.filePath, error: String(error) });
         }
       }
     }
@@ -178,7 +193,7 @@ export class DetectorManager {
   /**
    * 获取检测器统计信息
    */
-  getDetectorStats(): Array<{ name: string; enabled: boolean; config: any }> {
+  getDetectorStats(): DetectorStats[] {
     return Array.from(this.detectors.values()).map(detector => detector.getStats());
   }
   
@@ -192,7 +207,7 @@ export class DetectorManager {
       try {
         results[name] = await detector.validate();
       } catch (error) {
-        console.error(`检测器 ${name} 验证失败:`, error);
+        log.error('检测器验证失败', { detector: name, error: String(error) });
         results[name] = false;
       }
     }
@@ -5,6 +5,13 @@
 
 import { BaseDetector, DetectionContext } from './base_detector';
 import { Issue } from '../interfaces/types';
+import { countRegex } from '../utils/instrumentation';
+import { TYPES } from '../analysis/session';
+import { TypeTable } from '../analysis/type_table';
+import { FormatFlavor, FORMAT_FUNCTIONS, parseFormat, expectedArguments, classifyCType, isArgMismatch } from '../utils/format_spec';
+import { getLogger } from '../utils/logger';
+
+const log = getLogger('format');
 
 export class FormatDetector extends BaseDetector {
   constructor(config: any, enabled: boolean = true) {
@@ -26,8 +33,13 @@ export class FormatDetector extends BaseDetector {
     
     try {
       issues.push(...this.detectFormatStrings(context));
+      
+      // 有 AST 时进一步按参数类型检查格式说明符
+      if (context.ast) {
+        issues.push(...this.detectArgumentTypeMismatches(context));
+      }
     } catch (error) {
-      console.error('FormatDetector检测错误:', error);
+      log.error('FormatDetector检测错误', { file: context.filePath, error: String(error) });
     }
     
     return issues;
@@ -67,21 +79,21 @@ export class FormatDetector extends BaseDetector {
     ];
     
     for (const pattern of printfPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match) {
         const format = match[1];
         const args = match[2] || '';
         
-        // 更精确的格式说明符匹配
-        const formatSpecifiers = this.extractFormatSpecifiers(format);
+        const required = this.requiredArguments(format, 'printf');
         const argCount = this.countArguments(args);
         
-        if (formatSpecifiers.length !== argCount) {
+        if (required !== argCount) {
           issues.push({
             file: context.filePath,
             line: lineIndex + 1,
             category: 'Format',
-            message: `printf格式字符串参数不匹配：需要${formatSpecifiers.length}个参数，提供了${argCount}个`,
+            message: `printf格式字符串参数不匹配：需要${required}个参数，提供了${argCount}个`,
             codeLine: context.lines[lineIndex]
           });
         }
@@ -98,21 +110,22 @@ export class FormatDetector extends BaseDetector {
     ];
     
     for (const pattern of scanfPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match) {
         const format = match[1];
         const args = match[2];
         
         // 检查格式说明符
-        const formatSpecifiers = this.extractFormatSpecifiers(format);
+        const required = this.requiredArguments(format, 'scanf');
         const argCount = this.countArguments(args);
         
-        if (formatSpecifiers.length !== argCount) {
+        if (required !== argCount) {
           issues.push({
             file: context.filePath,
             line: lineIndex + 1,
             category: 'Format',
-            message: `scanf格式字符串参数不匹配：需要${formatSpecifiers.length}个参数，提供了${argCount}个`,
+            message: `scanf格式字符串参数不匹配：需要${required}个参数，提供了${argCount}个`,
             codeLine: context.lines[lineIndex]
           });
         }
@@ -133,21 +146,22 @@ export class FormatDetector extends BaseDetector {
     ];
     
     for (const pattern of sprintfPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match) {
         const format = match[1];
         const args = match[2] || '';
         
-        const formatSpecifiers = this.extractFormatSpecifiers(format);
+        const required = this.requiredArguments(format, 'printf');
         const argCount = this.countArguments(args);
         
-        if (formatSpecifiers.length !== argCount) {
+        if (required !== argCount) {
           const funcName = line.includes('snprintf') ? 'snprintf' : 'sprintf';
           issues.push({
             file: context.filePath,
             line: lineIndex + 1,
             category: 'Format',
-            message: `${funcName}格式字符串参数不匹配：需要${formatSpecifiers.length}个参数，提供了${argCount}个`,
+            message: `${funcName}格式字符串参数不匹配：需要${required}个参数，提供了${argCount}个`,
             codeLine: context.lines[lineIndex]
           });
         }
@@ -163,20 +177,21 @@ export class FormatDetector extends BaseDetector {
     ];
     
     for (const pattern of fprintfPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match) {
         const format = match[1];
         const args = match[2] || '';
         
-        const formatSpecifiers = this.extractFormatSpecifiers(format);
+        const required = this.requiredArguments(format, 'printf');
         const argCount = this.countArguments(args);
         
-        if (formatSpecifiers.length !== argCount) {
+        if (required !== argCount) {
           issues.push({
             file: context.filePath,
             line: lineIndex + 1,
             category: 'Format',
-            message: `fprintf格式字符串参数不匹配：需要${formatSpecifiers.length}个参数，提供了${argCount}个`,
+            message: `fprintf格式字符串参数不匹配：需要${required}个参数，提供了${argCount}个`,
             codeLine: context.lines[lineIndex]
           });
         }
@@ -185,29 +200,109 @@ export class FormatDetector extends BaseDetector {
     }
   }
   
-  private extractFormatSpecifiers(format: string): string[] {
-    // 更精确的格式说明符提取
-    const specifiers: string[] = [];
+  private requiredArguments(format: string, flavor: FormatFlavor): number {
+    // 解析结果按字面量缓存，同一格式串只解析一次
+    return parseFormat(format, flavor).argCount;
+  }
+  
+  /**
+   * 基于 AST 的参数类型检查：对 printf/scanf 系列调用，将格式说明符期望的类型与实参的声明类型比较
+   */
+  private detectArgumentTypeMismatches(context: DetectionContext): Issue[] {
+    const issues: Issue[] = [];
+    const types = this.analysesFor(context)!.get(TYPES);
     
-    // 匹配各种格式说明符
-    const patterns = [
-      /%[0-9]*\.[0-9]*[lh]?[sdioxXeEfFgGaAcpn%]/g,  // 带宽度和精度的
-      /%[0-9]*[lh]?[sdioxXeEfFgGaAcpn%]/g,  // 带宽度的
-      /%[lh]?[sdioxXeEfFgGaAcpn%]/g,  // 基本格式说明符
-    ];
+    const visit = (node: any): void => {
+      if (!node || typeof node.type !== 'string') return;
+      
+      if (node.type === 'call_expression') {
+        this.checkCallArgumentTypes(node, types, context, issues);
+      }
+      
+      const children = node.namedChildren && node.namedChildren.length > 0 ? node.namedChildren : node.children;
+      if (children) {
+        for (const child of children) visit(child);
+      }
+    };
+    visit(context.ast);
     
-    for (const pattern of patterns) {
-      const matches = format.match(pattern);
-      if (matches) {
-        for (const match of matches) {
-          if (match !== '%%') {  // 排除%%
-            specifiers.push(match);
-          }
-        }
+    return issues;
+  }
+  
+  private checkCallArgumentTypes(node: any, types: TypeTable, context: DetectionContext, issues: Issue[]): void {
+    const funcName = node.namedChildren?.[0]?.text;
+    const signature = FORMAT_FUNCTIONS[funcName];
+    if (!signature) return;
+    
+    const argList = (node.namedChildren || []).find((c: any) => c.type === 'argument_list');
+    const args: any[] = (argList?.namedChildren || []).filter((c: any) => c.type !== 'comment');
+    const formatNode = args[signature.formatIndex];
+    if (!formatNode || formatNode.type !== 'string_literal') return;
+    
+    const parsed = parseFormat(formatNode.text.slice(1, -1), signature.flavor);
+    const expected = expectedArguments(parsed, signature.flavor);
+    const variadic = args.slice(signature.formatIndex + 1);
+    
+    for (let k = 0; k < Math.min(expected.length, variadic.length); k++) {
+      const actualType = this.inferArgumentType(variadic[k], types);
+      if (!actualType) continue;
+      if (isArgMismatch(expected[k].expected, classifyCType(actualType), signature.flavor)) {
+        const row = variadic[k].startPosition?.row ?? node.startPosition.row;
+        issues.push({
+          file: context.filePath,
+          line: row + 1,
+          category: 'Format',
+          message: `${funcName}格式说明符 ${expected[k].spec.text} 与参数 '${variadic[k].text}' 的类型 ${actualType} 不匹配`,
+          codeLine: context.lines[row] || ''
+        });
       }
     }
-    
-    return specifiers;
+  }
+  
+  private inferArgumentType(node: any, types: TypeTable): string | null {
+    switch (node.type) {
+      case 'identifier':
+        return types.typeOf(node.text, node.startPosition);
+      case 'string_literal':
+      case 'concatenated_string':
+        return 'char *';
+      case 'char_literal':
+        return 'int';
+      case 'number_literal': {
+        const text: string = node.text;
+        countRegex();
+        if (!/^0[xX]/.test(text) && /[.eE]/.test(text)) return 'double';
+        countRegex();
+        return /[lL]{2}$|[uU][lL]{2}$/.test(text) ? 'long long' : /[lL]$/.test(text) ? 'long' : 'int';
+      }
+      case 'parenthesized_expression':
+        return node.namedChildren?.[0] ? this.inferArgumentType(node.namedChildren[0], types) : null;
+      case 'cast_expression': {
+        const typeDescriptor = (node.namedChildren || []).find((c: any) => c.type === 'type_descriptor');
+        return typeDescriptor ? typeDescriptor.text : null;
+      }
+      case 'pointer_expression':
+      case 'unary_expression': {
+        const operand = node.namedChildren?.[node.namedChildren.length - 1];
+        const operandType = operand ? this.inferArgumentType(operand, types) : null;
+        if (!operandType) return null;
+        const text: string = node.text.trim();
+        if (text.startsWith('&')) return operandType + ' *';
+        if (text.startsWith('*')) return this.dereferenceType(operandType);
+        return null;
+      }
+      case 'subscript_expression': {
+        const base = node.namedChildren?.[0];
+        const baseType = base ? this.inferArgumentType(base, types) : null;
+        return baseType ? this.dereferenceType(baseType) : null;
+      }
+    }
+    return null;
+  }
+  
+  private dereferenceType(type: string): string | null {
+    const idx = type.lastIndexOf('*');
+    return idx >= 0 ? type.slice(0, idx).trim() : null;
   }
   
   private countArguments(args: string): number {
@@ -248,6 +343,7 @@ export class FormatDetector extends BaseDetector {
     
     for (const arg of argList) {
       // 检查是否是变量名（不是&var, 不是数组名, 不是字符串字面量）
+      countRegex();
       if (/^\w+$/.test(arg) && 
           !arg.startsWith('&') && 
           !arg.includes('[') && 
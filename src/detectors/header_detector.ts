@@ -5,6 +5,11 @@
 
 import { BaseDetector, DetectionContext } from './base_detector';
 import { Issue } from '../interfaces/types';
+import { countRegex } from '../utils/instrumentation';
+import { CALLS, INCLUDES } from '../analysis/session';
+import { getLogger } from '../utils/logger';
+
+const log = getLogger('header');
 
 export class HeaderDetector extends BaseDetector {
   private functionHeaders: Record<string, string>;
@@ -106,7 +111,7 @@ export class HeaderDetector extends BaseDetector {
       // 强制使用启发式检测，因为AST检测完全失效
       issues.push(...this.detectWithHeuristic(context));
     } catch (error) {
-      console.error('HeaderDetector检测错误:', error);
+      log.error('HeaderDetector检测错误', { file: context.filePath, error: String(error) });
     }
     
     return issues;
@@ -115,12 +120,13 @@ export class HeaderDetector extends BaseDetector {
   private async detectWithAST(context: DetectionContext): Promise<Issue[]> {
     const issues: Issue[] = [];
     
-    if (!context.ast) return issues;
+    const analyses = this.analysesFor(context);
+    if (!analyses) return issues;
     
     try {
-      // 提取所有include指令
-      const includes = this.extractIncludeDirectives(context.ast);
-      const functionCalls = this.extractFunctionCalls(context.ast);
+      // include 指令与函数调用取自文件级分析会话
+      const includes = analyses.get(INCLUDES);
+      const functionCalls = analyses.get(CALLS);
       
       // 创建已包含的头文件集合
       const includedHeaders = new Set<string>();
@@ -157,73 +163,12 @@ export class HeaderDetector extends BaseDetector {
       }
       
     } catch (error) {
-      console.error('AST头文件检测错误:', error);
+      log.error('AST头文件检测错误', { file: context.filePath, error: String(error) });
     }
     
     return issues;
   }
   
-  private extractIncludeDirectives(ast: any): any[] {
-    const includes: any[] = [];
-    this.traverseAST(ast, (node) => {
-      if (node.type === 'preproc_include') {
-        const pathNode = this.findChildByType(node, 'string_literal') ||
-                        this.findChildByType(node, 'system_lib_string');
-        if (pathNode) {
-          const headerName = pathNode.text.replace(/[<>"]/g, '');
-          const isSystemHeader = pathNode.text.startsWith('<');
-          includes.push({
-            headerName,
-            isSystemHeader,
-            position: node.startPosition
-          });
-        }
-      }
-    });
-    return includes;
-  }
-  
-  private extractFunctionCalls(ast: any): any[] {
-    const calls: any[] = [];
-    this.traverseAST(ast, (node) => {
-      if (node.type === 'call_expression') {
-        const funcIdentifier = node.namedChildren?.[0];
-        if (funcIdentifier && funcIdentifier.type === 'identifier') {
-          calls.push({
-            name: funcIdentifier.text,
-            position: node.startPosition
-          });
-        }
-      }
-    });
-    return calls;
-  }
-  
-  private traverseAST(node: any, callback: (node: any) => void): void {
-    callback(node);
-    if (node.children) {
-      for (const child of node.children) {
-        this.traverseAST(child, callback);
-      }
-    }
-    if (node.namedChildren) {
-      for (const child of node.namedChildren) {
-        this.traverseAST(child, callback);
-      }
-    }
-  }
-  
-  private findChildByType(node: any, type: string): any {
-    if (node.namedChildren) {
-      for (const child of node.namedChildren) {
-        if (child.type === type) {
-          return child;
-        }
-      }
-    }
-    return null;
-  }
-  
   private getCorrectHeaderName(headerName: string): string | null {
     // C标准库头文件白名单
     const standardHeaders = new Set([
@@ -335,6 +280,7 @@ export class HeaderDetector extends BaseDetector {
       const line = lines[i];
       
       // 检测include指令
+      countRegex();
       const includeMatch = line.match(/#include\s*[<"]([^>"]+)[>"]/);
       if (includeMatch) {
         const headerName = includeMatch[1];
@@ -386,6 +332,7 @@ export class HeaderDetector extends BaseDetector {
         
         let foundFunction = false;
         for (const pattern of funcPatterns) {
+          countRegex();
           if (pattern.test(cleanLine)) {
             foundFunction = true;
             break;
@@ -5,6 +5,17 @@
 
 import { BaseDetector, DetectionContext } from './base_detector';
 import { Issue } from '../interfaces/types';
+import { IdentifierIndex, Occurrence, OccurrenceKind } from '../utils/identifier_index';
+import { POINTS_TO } from '../analysis/session';
+import { getLogger } from '../utils/logger';
+
+const log = getLogger('memory');
+
+// 内存分配函数
+const ALLOCATION_FUNCTIONS = new Set(['malloc', 'calloc', 'realloc', 'strdup', 'strndup']);
+
+// 视为释放或所有权转移的出现类别
+const RELEASE_KINDS = new Set<OccurrenceKind>(['freed', 'returned', 'stored', 'passed']);
 
 export class MemoryDetector extends BaseDetector {
   constructor(config: any, enabled: boolean = true) {
@@ -25,9 +36,34 @@ export class MemoryDetector extends BaseDetector {
     const issues: Issue[] = [];
     
     try {
-      issues.push(...this.detectMemoryLeaks(context));
+      issues.push(...(context.ast ? this.detectWithPointsTo(context) : this.detectMemoryLeaks(context)));
     } catch (error) {
-      console.error('MemoryDetector检测错误:', error);
+      log.error('MemoryDetector检测错误', { file: context.filePath, error: String(error) });
+    }
+    
+    return issues;
+  }
+  
+  /**
+   * 基于指向分析：分配出的对象所在别名类既未被释放、也未逃逸（返回、存入全局或输出参数、
+   * 传给外部函数）时报告泄漏；经由别名释放（q = p; free(q);）不再误报
+   */
+  private detectWithPointsTo(context: DetectionContext): Issue[] {
+    const issues: Issue[] = [];
+    const session = this.analysesFor(context)!;
+    const pointsTo = context.program ? context.program.pointsTo() : session.get(POINTS_TO);
+    const file = context.program ? context.filePath : '';
+    
+    for (const site of pointsTo.leakedAllocations()) {
+      if (site.unit.file !== file || !site.variable) continue;
+      const row = site.call.startPosition.row;
+      issues.push({
+        file: context.filePath,
+        line: row + 1,
+        category: 'Memory leak',
+        message: `内存泄漏：变量 '${site.variable.name}' 分配内存后未释放`,
+        codeLine: context.lines[row] || ''
+      });
     }
     
     return issues;
@@ -35,159 +71,38 @@ export class MemoryDetector extends BaseDetector {
   
   private detectMemoryLeaks(context: DetectionContext): Issue[] {
     const issues: Issue[] = [];
-    const content = context.content;
     const lines = context.lines;
     
-    // 更全面的内存分配函数检测
-    const allocationPatterns = [
-      /(\w+)\s*=\s*malloc\s*\(/g,
-      /(\w+)\s*=\s*calloc\s*\(/g,
-      /(\w+)\s*=\s*realloc\s*\(/g,
-      /(\w+)\s*=\s*strdup\s*\(/g,
-      /(\w+)\s*=\s*strndup\s*\(/g,
-    ];
+    // 单遍词法扫描建立标识符出现索引，每个变量只需线性遍历一次自身的出现列表
+    const index = IdentifierIndex.build(context.content);
     
-    const allocatedVars = new Map<string, {line: number, type: string}>();
-    
-    // 收集所有内存分配
-    for (const pattern of allocationPatterns) {
-      let match;
-      while ((match = pattern.exec(content)) !== null) {
-        const varName = match[1];
-        const allocationType = match[0].includes('malloc') ? 'malloc' :
-                             match[0].includes('calloc') ? 'calloc' :
-                             match[0].includes('realloc') ? 'realloc' :
-                             match[0].includes('strdup') ? 'strdup' : 'strndup';
-        
-        // 找到分配的行号
-        for (let i = 0; i < lines.length; i++) {
-          if (lines[i].includes(match[0])) {
-            allocatedVars.set(varName, {line: i, type: allocationType});
-            break;
+    for (const [varName, occurrences] of index.entries()) {
+      let allocation: Occurrence | undefined;
+      let released = false;
+      
+      for (const occ of occurrences) {
+        if (occ.kind === 'assigned') {
+          if (!allocation && occ.source && ALLOCATION_FUNCTIONS.has(occ.source)) {
+            allocation = occ;
           }
+        } else if (RELEASE_KINDS.has(occ.kind)) {
+          // 释放或合法的所有权转移（返回、存入其他位置、作为实参传递）
+          released = true;
+          break;
         }
       }
-    }
-    
-    // 检查每个分配的内存是否有对应的释放
-    for (const [varName, info] of allocatedVars) {
-      // 检查是否存在合法的所有权转移
-      if (this.hasValidOwnershipTransfer(content, varName)) {
-        continue; // 认为不构成当前函数内的泄漏
-      }
       
-      // 检查是否有对应的free调用
-      if (!this.hasMatchingFree(content, varName)) {
+      if (allocation && !released) {
         issues.push({
           file: context.filePath,
-          line: info.line + 1,
+          line: allocation.line + 1,
           category: 'Memory leak',
           message: `内存泄漏：变量 '${varName}' 分配内存后未释放`,
-          codeLine: lines[info.line]
+          codeLine: lines[allocation.line]
         });
       }
     }
     
     return issues;
   }
-  
-  private hasValidOwnershipTransfer(content: string, varName: string): boolean {
-    // 1. 函数返回值转移：return varName; 或 return (varName);
-    const returnPatterns = [
-      new RegExp(`\\breturn\\s+${varName}\\s*;`),
-      new RegExp(`\\breturn\\s*\\(\\s*${varName}\\s*\\)\\s*;`),
-      new RegExp(`\\breturn\\s+\\*?${varName}\\s*;`),
-      new RegExp(`\\breturn\\s*\\(\\s*\\*?${varName}\\s*\\)\\s*;`)
-    ];
-    
-    for (const pattern of returnPatterns) {
-      if (pattern.test(content)) {
-        return true;
-      }
-    }
-    
-    // 2. 输出参数转移：*out = varName; 或 out->ptr = varName;
-    const outputPatterns = [
-      new RegExp(`\\*\\w+\\s*=\\s*${varName}\\b`),
-      new RegExp(`\\w+->\\w+\\s*=\\s*${varName}\\b`),
-      new RegExp(`\\w+\\.\\w+\\s*=\\s*${varName}\\b`)
-    ];
-    
-    for (const pattern of outputPatterns) {
-      if (pattern.test(content)) {
-        return true;
-      }
-    }
-    
-    // 3. 结构体成员赋值：struct.member = varName;
-    const structPatterns = [
-      new RegExp(`\\w+\\.\\w+\\s*=\\s*${varName}\\b`),
-      new RegExp(`\\w+->\\w+\\s*=\\s*${varName}\\b`)
-    ];
-    
-    for (const pattern of structPatterns) {
-      if (pattern.test(content)) {
-        return true;
-      }
-    }
-    
-    // 4. 数组赋值：array[index] = varName;
-    const arrayPatterns = [
-      new RegExp(`\\w+\\[\\d+\\]\\s*=\\s*${varName}\\b`),
-      new RegExp(`\\w+\\[\\w+\\]\\s*=\\s*${varName}\\b`)
-    ];
-    
-    for (const pattern of arrayPatterns) {
-      if (pattern.test(content)) {
-        return true;
-      }
-    }
-    
-    // 5. 函数调用参数传递：func(varName) 或 func(..., varName, ...)
-    const functionCallPatterns = [
-      new RegExp(`\\w+\\s*\\([^)]*\\b${varName}\\b[^)]*\\)`),
-      new RegExp(`\\w+\\s*\\(\\s*${varName}\\s*\\)`)
-    ];
-    
-    for (const pattern of functionCallPatterns) {
-      if (pattern.test(content)) {
-        return true;
-      }
-    }
-    
-    // 6. 全局变量赋值：global_var = varName;
-    const globalPatterns = [
-      new RegExp(`\\w+\\s*=\\s*${varName}\\s*;`),
-      new RegExp(`\\w+\\s*=\\s*${varName}\\s*$`)
-    ];
-    
-    for (const pattern of globalPatterns) {
-      if (pattern.test(content)) {
-        return true;
-      }
-    }
-    
-    // 7. 条件赋值：if (condition) { varName = malloc(...); } else { return varName; }
-    // 这种情况比较复杂，暂时不处理
-    
-    return false;
-  }
-  
-  private hasMatchingFree(content: string, varName: string): boolean {
-    // 检查是否有对应的free调用
-    const freePatterns = [
-      new RegExp(`free\\s*\\(\\s*${varName}\\s*\\)`),
-      new RegExp(`free\\s*\\(\\s*&?${varName}\\s*\\)`),
-      new RegExp(`free\\s*\\(\\s*\\([^)]*\\)\\s*${varName}\\s*\\)`), // free((type)varName)
-      new RegExp(`free\\s*\\(\\s*${varName}\\s*\\([^)]*\\)\\s*\\)`), // free(varName(...))
-    ];
-    
-    for (const pattern of freePatterns) {
-      if (pattern.test(content)) {
-        return true;
-      }
-    }
-    
-    return false;
-  }
 }
@@ -5,7 +5,21 @@
 
 import { BaseDetector, DetectionContext } from './base_detector';
 import { Issue } from '../interfaces/types';
-import { CASTParser, VariableDeclaration } from '../core/ast_parser';
+import { countRegex } from '../utils/instrumentation';
+import { FlowFinding } from '../analysis/variable_flow';
+import { FunctionSummary } from '../analysis/summaries';
+import { PROGRAM } from '../analysis/program';
+import { DEFAULT_NULL_PATH_BUDGET } from '../analysis/null_paths';
+import { ScopedSymbolTable } from '../utils/scoped_symbols';
+import { getLogger } from '../utils/logger';
+
+const log = getLogger('variable');
+
+// 有 AST 时由数据流分析与函数摘要给出的问题类别，启发式结果中的同类问题被替换
+const FLOW_CATEGORIES = new Set([
+  'Uninitialized variable', 'Wild pointer', 'Null pointer',
+  'Stack pointer return', 'Dangling pointer return', 'Interprocedural analysis'
+]);
 
 /**
  * 变量信息接口
@@ -18,7 +32,7 @@ interface VariableInfo {
   line: number;
   // 新增：变量值追踪
   currentValue?: string;  // 当前值（如 "NULL", "malloc", "&var" 等）
-  valueHistory: ValueAssignment[];  // 值变更历史
+  valueLine?: number;  // 当前值被赋予的行
   // 新增：指针空间追踪
   spaceType?: PointerSpaceType;  // 指针指向的空间类型
   targetVariable?: string;  // 指向的目标变量名（用于栈空间追踪）
@@ -26,13 +40,9 @@ interface VariableInfo {
 }
 
 /**
- * 值赋值记录
+ * 赋值来源类型
  */
-interface ValueAssignment {
-  line: number;
-  value: string;
-  assignmentType: 'direct' | 'malloc' | 'calloc' | 'realloc' | 'address' | 'null' | 'zero' | 'scanf' | 'function_call';
-}
+type AssignmentType = 'direct' | 'malloc' | 'calloc' | 'realloc' | 'address' | 'null' | 'zero' | 'scanf' | 'function_call';
 
 /**
  * 栈空间信息
@@ -65,19 +75,6 @@ interface GlobalSymbol {
   isPointer?: boolean;
 }
 
-/**
- * 函数摘要
- */
-interface FunctionSummary {
-  name: string;
-  returnType: string;
-  parameters: Array<{name: string, type: string, isPointer: boolean}>;
-  dangerousOperations: string[];
-  returnsLocalAddress: boolean;
-  returnsFreedMemory: boolean;
-  callsDangerousFunctions: string[];
-}
-
 /**
  * 跨函数调用信息
  */
@@ -131,94 +128,7 @@ class GlobalSymbolTable {
   }
 }
 
-/**
- * 作用域管理器 - 基于哈希表的变量状态追踪
- */
-class ScopeManager {
-  private variables: Map<string, VariableInfo> = new Map();
-  private scopeName: string;
-
-  constructor(scopeName: string) {
-    this.scopeName = scopeName;
-  }
-
-  /**
-   * 声明变量
-   */
-  declareVariable(varName: string, info: VariableInfo): void {
-    // 初始化值历史记录
-    if (!info.valueHistory) {
-      info.valueHistory = [];
-    }
-    this.variables.set(varName, info);
-  }
-
-  /**
-   * 检查变量是否存在
-   */
-  hasVariable(varName: string): boolean {
-    return this.variables.has(varName);
-  }
-
-  /**
-   * 获取变量信息
-   */
-  getVariable(varName: string): VariableInfo | undefined {
-    return this.variables.get(varName);
-  }
-
-  /**
-   * 标记变量为已初始化
-   */
-  markAsInitialized(varName: string): void {
-    const varInfo = this.variables.get(varName);
-    if (varInfo) {
-      varInfo.isInitialized = true;
-    }
-  }
-
-  /**
-   * 更新变量值
-   */
-  updateVariableValue(varName: string, value: string, assignmentType: ValueAssignment['assignmentType'], line: number): void {
-    const varInfo = this.variables.get(varName);
-    if (varInfo) {
-      varInfo.currentValue = value;
-      varInfo.valueHistory.push({
-        line,
-        value,
-        assignmentType
-      });
-      varInfo.isInitialized = true;
-    }
-  }
-
-  /**
-   * 获取变量当前值
-   */
-  getVariableValue(varName: string): string | undefined {
-    const varInfo = this.variables.get(varName);
-    return varInfo?.currentValue;
-  }
-
-  /**
-   * 获取作用域名称
-   */
-  getScopeName(): string {
-    return this.scopeName;
-  }
-
-  /**
-   * 获取所有变量
-   */
-  getAllVariables(): Map<string, VariableInfo> {
-    return new Map(this.variables);
-  }
-}
-
 export class VariableDetector extends BaseDetector {
-  private astParser: CASTParser | null = null;
-  
   constructor(config: any, enabled: boolean = true) {
     super(config, enabled);
   }
@@ -237,304 +147,108 @@ export class VariableDetector extends BaseDetector {
     const issues: Issue[] = [];
     
     try {
-      // 强制使用启发式检测，跳过AST检测
-      issues.push(...this.detectWithScopeBasedTracking(context));
-    } catch (error) {
-      console.error('VariableDetector检测错误:', error);
-    }
-    
-    return issues;
-  }
-  
-  private async detectWithAST(context: DetectionContext): Promise<Issue[]> {
-    const issues: Issue[] = [];
-    
-    if (!this.astParser || !context.ast) return issues;
-    
-    try {
-      // 使用AST进行深度分析
-      const declarations = this.astParser.extractVariableDeclarations(context.ast, context.lines);
-      const functionCalls = this.astParser.extractFunctionCalls(context.ast);
-      
-      console.log(`    Found ${declarations.length} variable declarations`);
-      console.log(`    Found ${functionCalls.length} function calls`);
-      
-      // 创建变量状态跟踪器
-      const variableStates = new Map<string, {
-        declaration: VariableDeclaration;
-        isInitialized: boolean;
-        isNull: boolean;
-        lastAssignment: number;
-        assignments: number[];
-      }>();
-      
-      // 初始化变量状态
-      for (const decl of declarations) {
-        variableStates.set(decl.name, {
-          declaration: decl,
-          isInitialized: decl.isInitialized,
-          isNull: false,
-          lastAssignment: decl.position.row,
-          assignments: []
-        });
+      if (context.ast) {
+        issues.push(...this.detectWithDataflow(context));
+        issues.push(...this.detectWithScopeBasedTracking(context).filter(issue => !FLOW_CATEGORIES.has(issue.category)));
+      } else {
+        issues.push(...this.detectWithScopeBasedTracking(context));
       }
-      
-      // 遍历AST节点，分析变量使用和赋值
-      this.traverseAST(context.ast, (node) => {
-        this.analyzeNodeForVariableIssues(node, variableStates, functionCalls, context, issues);
-      });
-      
-      // 检查未初始化变量使用
-      this.checkUninitializedVariables(variableStates, context, issues);
-      
-      // 检查野指针解引用
-      this.checkWildPointerDereferences(variableStates, context, issues);
-      
-      // 检查空指针解引用
-      this.checkNullPointerDereferences(variableStates, context, issues);
-      
     } catch (error) {
-      console.error('AST变量检测错误:', error);
+      log.error('VariableDetector检测错误', { file: context.filePath, error: String(error) });
     }
     
     return issues;
   }
   
-  private traverseAST(node: any, callback: (node: any) => void): void {
-    callback(node);
-    if (node.children) {
-      for (const child of node.children) {
-        this.traverseAST(child, callback);
+  /**
+   * 基于函数 CFG 的数据流检测：到达定义 + 确定赋值判定未初始化/野指针；
+   * 空指针解引用优先用路径敏感检查，超出展开预算的函数退回空值性数据流的结论
+   */
+  private detectWithDataflow(context: DetectionContext): Issue[] {
+    const issues: Issue[] = [];
+    const session = this.analysesFor(context)!;
+    for (const fn of session.functions()) {
+      const paths = this.config.nullPointers ? session.nullPaths(fn, this.config.nullPathBudget || DEFAULT_NULL_PATH_BUDGET) : undefined;
+      const findings = session.flow(fn).findings().filter(finding => finding.kind !== 'null' || !paths || !paths.complete);
+      if (paths && paths.complete) {
+        findings.push(...paths.findings.map(finding => ({ kind: 'null' as const, variable: finding.variable, node: finding.node, partial: false })));
       }
-    }
-    if (node.namedChildren) {
-      for (const child of node.namedChildren) {
-        this.traverseAST(child, callback);
+      for (const finding of findings) {
+        const issue = this.flowFindingToIssue(finding, context);
+        if (issue) issues.push(issue);
       }
     }
-  }
-  
-  private analyzeNodeForVariableIssues(
-    node: any, 
-    variableStates: Map<string, any>, 
-    functionCalls: any[], 
-    context: DetectionContext, 
-    issues: Issue[]
-  ): void {
-    const line = node.startPosition?.row || 0;
-    
-    // 分析赋值操作
-    if (node.type === 'binary_expression' || node.type === 'compound_assignment') {
-      this.analyzeAssignment(node, variableStates, line, context, issues);
-    }
-    
-    // 分析函数调用
-    if (node.type === 'call_expression') {
-      this.analyzeFunctionCall(node, variableStates, line, context, issues);
-    }
-    
-    // 分析变量使用
-    if (node.type === 'identifier' || node.type === 'DeclRefExpr') {
-      this.analyzeVariableUsage(node, variableStates, line, context, issues);
-    }
-    
-    // 分析指针解引用
-    if (node.type === 'unary_expression' || node.type === 'field_expression' || node.type === 'subscript_expression') {
-      this.analyzePointerDereference(node, variableStates, line, context, issues);
-    }
+    issues.push(...this.detectWithSummaries(context));
+    return issues;
   }
 
-  private checkUninitializedVariables(variableStates: Map<string, any>, context: DetectionContext, issues: Issue[]): void {
-    for (const [varName, state] of variableStates) {
-      if (!state.isInitialized && !state.declaration.isParameter && !state.declaration.isGlobal) {
-        // 查找变量使用位置
-        const usages = this.astParser!.findVariableUsages(context.ast, varName);
-        console.log(`    Checking uninitialized variable '${varName}': found ${usages.length} usages`);
-        
-          for (const usage of usages) {
-          if (usage.row > state.declaration.position.row) {
-            // 检查是否在赋值之前使用
-            const hasAssignmentBefore = state.assignments.some((assignLine: number) => assignLine < usage.row);
-            if (!hasAssignmentBefore) {
-              console.log(`    Found uninitialized usage of '${varName}' at line ${usage.row + 1}`);
-              issues.push({
-                file: context.filePath,
-                line: usage.row + 1,
-                category: 'Uninitialized',
-                message: `变量 '${varName}' 在初始化前被使用`,
-                codeLine: context.lines[usage.row] || ''
-              });
-            }
-          }
-        }
-      }
-    }
-  }
+  /**
+   * 基于函数摘要：函数体内直接返回局部地址/已释放指针，以及调用点接收被调函数返回的此类指针。
+   * 多文件扫描时摘要来自全程序阶段，否则在本文件内自底向上计算
+   */
+  private detectWithSummaries(context: DetectionContext): Issue[] {
+    const issues: Issue[] = [];
+    const session = this.analysesFor(context)!;
+    const program = context.program || session.get(PROGRAM);
+    const file = context.program ? context.filePath : '';
+    const issueAt = (position: { row: number }, category: string, message: string): Issue => {
+      const row = position.row;
+      return { file: context.filePath, line: row + 1, category, message, codeLine: context.lines[row] || '' };
+    };
 
-  private checkWildPointerDereferences(variableStates: Map<string, any>, context: DetectionContext, issues: Issue[]): void {
-    for (const [varName, state] of variableStates) {
-      if (state.declaration.isPointer && !state.isInitialized && !state.declaration.isParameter) {
-        // 查找指针解引用位置
-        const dereferences = this.astParser!.findPointerDereferences(context.ast, varName);
-        console.log(`    Checking wild pointer '${varName}': found ${dereferences.length} dereferences`);
-        
-          for (const deref of dereferences) {
-          if (deref.row > state.declaration.position.row) {
-            // 检查是否在赋值之前解引用
-            const hasAssignmentBefore = state.assignments.some((assignLine: number) => assignLine < deref.row);
-            if (!hasAssignmentBefore) {
-              console.log(`    Found wild pointer dereference of '${varName}' at line ${deref.row + 1}`);
-              issues.push({
-                file: context.filePath,
-                line: deref.row + 1,
-                category: 'Wild pointer',
-                message: `野指针解引用：指针 '${varName}' 未初始化`,
-                codeLine: context.lines[deref.row] || ''
-              });
-            }
-          }
-        }
+    for (const fn of session.functions()) {
+      const result = program.resultOf(fn);
+      if (!result) continue;
+      for (const site of result.returnSites) {
+        issues.push(site.kind === 'local'
+          ? issueAt(site.position, 'Stack pointer return', `禁止返回局部变量：函数返回了局部变量 '${site.variable}'`)
+          : issueAt(site.position, 'Dangling pointer return', `禁止返回已释放内存：函数返回了已释放的指针 '${site.variable}'`));
       }
-    }
-  }
-
-  private checkNullPointerDereferences(variableStates: Map<string, any>, context: DetectionContext, issues: Issue[]): void {
-    for (const [varName, state] of variableStates) {
-      if (state.declaration.isPointer && state.isNull) {
-        // 查找指针解引用位置
-        const dereferences = this.astParser!.findPointerDereferences(context.ast, varName);
-        
-          for (const deref of dereferences) {
-          if (deref.row > state.lastAssignment) {
-              issues.push({
-                file: context.filePath,
-                line: deref.row + 1,
-                category: 'Null pointer',
-              message: `空指针解引用：指针 '${varName}' 为 NULL`,
-                codeLine: context.lines[deref.row] || ''
-              });
-            }
-          }
+      for (const call of result.callSites) {
+        const summary = program.summaryOf(call.callee, file);
+        if (!summary) continue;
+        if (summary.returnsLocalAddress) {
+          issues.push(issueAt(call.position, 'Interprocedural analysis',
+            `过程间分析：函数 '${call.callee}' 返回局部地址，变量 '${call.variable}' 可能成为野指针`));
         }
-      }
-  }
-  
-  private analyzeAssignment(node: any, variableStates: Map<string, any>, line: number, context: DetectionContext, issues: Issue[]): void {
-    // 检查赋值操作符
-    const operator = node.text;
-    if (operator === '=' || operator === '+=' || operator === '-=' || operator === '*=' || operator === '/=') {
-      const leftOperand = node.namedChildren?.[0];
-      if (leftOperand && (leftOperand.type === 'identifier' || leftOperand.type === 'DeclRefExpr')) {
-        const varName = leftOperand.text;
-        const state = variableStates.get(varName);
-        if (state) {
-          state.isInitialized = true;
-          state.isNull = false;
-          state.lastAssignment = line;
-          state.assignments.push(line);
-          
-          // 检查是否赋值为NULL
-          const rightOperand = node.namedChildren?.[1];
-          if (rightOperand && (rightOperand.text === 'NULL' || rightOperand.text === '0')) {
-            state.isNull = true;
-          }
+        if (summary.returnsFreedMemory) {
+          issues.push(issueAt(call.position, 'Interprocedural analysis',
+            `过程间分析：函数 '${call.callee}' 返回已释放内存，变量 '${call.variable}' 可能成为悬空指针`));
         }
       }
     }
+    return issues;
   }
-  
-  private analyzeFunctionCall(node: any, variableStates: Map<string, any>, line: number, context: DetectionContext, issues: Issue[]): void {
-    const funcName = node.namedChildren?.[0]?.text;
-    if (!funcName) return;
-    
-    // 检查内存分配函数
-    if (['malloc', 'calloc', 'realloc'].includes(funcName)) {
-      // 这些函数通常用于初始化指针
-      const args = node.namedChildren?.[1]?.namedChildren || [];
-      if (args.length > 0) {
-        // 检查返回值是否被赋值给指针
-        // 这里需要更复杂的分析来确定返回值被赋给了哪个变量
-      }
-    }
-    
-    // 检查NULL赋值
-    if (funcName === 'memset' || funcName === 'bzero') {
-      // 这些函数可能将指针设置为NULL
-    }
-  }
-  
-  private analyzeVariableUsage(node: any, variableStates: Map<string, any>, line: number, context: DetectionContext, issues: Issue[]): void {
-    const varName = node.text;
-    const state = variableStates.get(varName);
-    if (!state) return;
-    
-    // 检查未初始化变量使用
-    if (this.config.uninitializedVariables && !state.isInitialized && !state.declaration.isParameter && !state.declaration.isGlobal) {
-      if (line > state.declaration.position.row) {
-        issues.push({
-          file: context.filePath,
-          line: line + 1,
-          category: 'Uninitialized',
-          message: `变量 '${varName}' 在初始化前被使用`,
-          codeLine: context.lines[line] || ''
-        });
-      }
-    }
-  }
-  
-  private analyzePointerDereference(node: any, variableStates: Map<string, any>, line: number, context: DetectionContext, issues: Issue[]): void {
-    let varName = '';
-    
-    // 提取被解引用的变量名
-    if (node.type === 'unary_expression') {
-      const operand = node.namedChildren?.[0];
-      if (operand && (operand.type === 'identifier' || operand.type === 'DeclRefExpr')) {
-        varName = operand.text;
-      }
-    } else if (node.type === 'field_expression') {
-      const object = node.namedChildren?.[0];
-      if (object && (object.type === 'identifier' || object.type === 'DeclRefExpr')) {
-        varName = object.text;
-      }
-    } else if (node.type === 'subscript_expression') {
-      const array = node.namedChildren?.[0];
-      if (array && (array.type === 'identifier' || array.type === 'DeclRefExpr')) {
-        varName = array.text;
-      }
-    }
-    
-    if (!varName) return;
-    
-    const state = variableStates.get(varName);
-    if (!state || !state.declaration.isPointer) return;
-    
-    // 检查野指针解引用
-    if (this.config.wildPointers && !state.isInitialized && !state.declaration.isParameter) {
-      if (line > state.declaration.position.row) {
-        issues.push({
-          file: context.filePath,
-          line: line + 1,
+
+  private flowFindingToIssue(finding: FlowFinding, context: DetectionContext): Issue | null {
+    const row = finding.node.startPosition.row;
+    const name = finding.variable.name;
+    const base = { file: context.filePath, line: row + 1, codeLine: context.lines[row] || '' };
+    switch (finding.kind) {
+      case 'uninitialized':
+        if (!this.config.uninitializedVariables) return null;
+        return {
+          ...base,
+          category: 'Uninitialized variable',
+          message: finding.partial
+            ? `未初始化变量使用：变量 '${name}' 在部分路径上未初始化即被使用`
+            : `未初始化变量使用：变量 '${name}' 在初始化前被使用`
+        };
+      case 'wild':
+        if (!this.config.wildPointers) return null;
+        return {
+          ...base,
           category: 'Wild pointer',
-          message: `野指针解引用：指针 '${varName}' 未初始化`,
-          codeLine: context.lines[line] || ''
-        });
-      }
-    }
-    
-    // 检查空指针解引用
-    if (this.config.nullPointers && state.isNull) {
-      if (line > state.lastAssignment) {
-        issues.push({
-          file: context.filePath,
-          line: line + 1,
-          category: 'Null pointer',
-          message: `空指针解引用：指针 '${varName}' 为 NULL`,
-          codeLine: context.lines[line] || ''
-        });
-      }
+          message: finding.partial
+            ? `野指针解引用：指针 '${name}' 在部分路径上未初始化`
+            : `野指针解引用：指针 '${name}' 未初始化`
+        };
+      case 'null':
+        if (!this.config.nullPointers) return null;
+        return { ...base, category: 'Null pointer', message: `空指针解引用：指针 '${name}' 当前值为 NULL` };
     }
   }
-  
+
   private detectWithHeuristic(context: DetectionContext): Issue[] {
     const issues: Issue[] = [];
     
@@ -553,12 +267,10 @@ export class VariableDetector extends BaseDetector {
     const issues: Issue[] = [];
     const lines = context.lines;
     
-    console.log(`[DEBUG] 开始启发式检测，文件: ${context.filePath}, 行数: ${lines.length}`);
+    if (log.debugEnabled) log.debug('开始启发式检测', { file: context.filePath, lines: lines.length });
     
-    // 作用域栈：每个作用域维护一个变量状态表
-    const scopeStack: ScopeManager[] = [];
-    const globalScope = new ScopeManager('global');
-    scopeStack.push(globalScope);
+    // 变量状态表：全部作用域共用一张扁平符号表，离开作用域时回滚
+    const symbols = new ScopedSymbolTable<VariableInfo>();
     
     // 函数参数追踪
     const functionParameters = new Map<string, Set<string>>();
@@ -575,50 +287,50 @@ export class VariableDetector extends BaseDetector {
         const cleanLine = this.stripLineComments(line);
       
       // 检测作用域变化
-      this.handleScopeChanges(cleanLine, i, scopeStack, functionParameters);
+      this.handleScopeChanges(cleanLine, i, symbols, functionParameters);
       
       // 检测栈帧变化
       currentStackFrame = this.handleStackFrameChanges(cleanLine, i, stackFrames, currentStackFrame);
       
       // 检测变量声明
-      this.detectVariableDeclarations(cleanLine, i, scopeStack, functionParameters);
+      this.detectVariableDeclarations(cleanLine, i, symbols, functionParameters);
       
       // 记录局部变量到栈帧
       this.recordLocalVariables(cleanLine, i, currentStackFrame);
       
       // 检测变量初始化和赋值
-      this.detectVariableInitialization(cleanLine, i, scopeStack);
+      this.detectVariableInitialization(cleanLine, i, symbols);
       
       // 检测函数返回值（禁止返回局部变量地址）
       this.detectFunctionReturns(cleanLine, i, stackFrames, issues, context);
       
       // 检测变量使用（可能导致未初始化错误）
-      this.detectVariableUsage(cleanLine, i, scopeStack, issues, context);
+      this.detectVariableUsage(cleanLine, i, symbols, issues, context);
       
       // 构建全局符号表
       this.buildGlobalSymbolTable(cleanLine, i, globalSymbolTable, context);
       
       // 检测跨函数调用
-      this.detectCrossFunctionCalls(cleanLine, i, scopeStack, issues, context, globalSymbolTable);
+      this.detectCrossFunctionCalls(cleanLine, i, symbols, issues, context, globalSymbolTable);
     }
     
-    console.log(`[DEBUG] 启发式检测完成，发现问题: ${issues.length}个`);
+    if (log.debugEnabled) log.debug('启发式检测完成', { file: context.filePath, issues: issues.length });
     return issues;
   }
 
   /**
    * 处理作用域变化（函数、代码块、循环等）
    */
-  private handleScopeChanges(line: string, lineIndex: number, scopeStack: ScopeManager[], functionParameters: Map<string, Set<string>>): void {
+  private handleScopeChanges(line: string, lineIndex: number, symbols: ScopedSymbolTable<VariableInfo>, functionParameters: Map<string, Set<string>>): void {
     // 函数定义开始
+    countRegex();
     const functionMatch = line.match(/(\w+)\s+(\w+)\s*\(([^)]*)\)\s*{/);
     if (functionMatch) {
       const functionName = functionMatch[2];
       const params = functionMatch[3];
       
-      // 创建函数作用域
-      const functionScope = new ScopeManager(`function:${functionName}`);
-      scopeStack.push(functionScope);
+      // 进入函数作用域
+      symbols.pushScope();
       
       // 解析函数参数
       if (params.trim()) {
@@ -627,18 +339,18 @@ export class VariableDetector extends BaseDetector {
         
         for (const param of paramList) {
           // 提取参数名（去掉类型）
+          countRegex();
           const paramMatch = param.match(/(\w+)\s+(\w+)/);
           if (paramMatch) {
             const paramName = paramMatch[2];
             paramSet.add(paramName);
             // 函数参数默认为已初始化
-            functionScope.declareVariable(paramName, {
+            symbols.declare(paramName, {
               type: paramMatch[1],
               isPointer: param.includes('*'),
               isInitialized: true,
               isParameter: true,
-              line: lineIndex,
-              valueHistory: []
+              line: lineIndex
             });
           }
         }
@@ -650,34 +362,30 @@ export class VariableDetector extends BaseDetector {
     
     // 代码块开始
     if (line.includes('{') && !line.includes('}')) {
-      const blockScope = new ScopeManager(`block:${lineIndex}`);
-      scopeStack.push(blockScope);
+      symbols.pushScope();
       return;
     }
     
     // 循环开始
+    countRegex();
     const loopMatch = line.match(/(for|while|do)\s*\(/);
     if (loopMatch) {
-      const loopScope = new ScopeManager(`loop:${lineIndex}`);
-      scopeStack.push(loopScope);
+      symbols.pushScope();
       return;
     }
     
     // 作用域结束
     if (line.includes('}')) {
-      if (scopeStack.length > 1) {
-        scopeStack.pop();
-      }
+      symbols.popScope();
     }
   }
 
   /**
    * 检测变量声明
    */
-  private detectVariableDeclarations(line: string, lineIndex: number, scopeStack: ScopeManager[], functionParameters: Map<string, Set<string>>): void {
-    const currentScope = scopeStack[scopeStack.length - 1];
-    
+  private detectVariableDeclarations(line: string, lineIndex: number, symbols: ScopedSymbolTable<VariableInfo>, functionParameters: Map<string, Set<string>>): void {    
     // 跳过函数定义行
+    countRegex();
     if (line.match(/\w+\s+\w+\s*\([^)]*\)\s*{/)) {
       return;
     }
@@ -702,6 +410,7 @@ export class VariableDetector extends BaseDetector {
         ];
         
         for (const pattern of declarationPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match && !line.includes('extern') && !line.includes('static') && !line.includes('typedef')) {
             const type = match[1];
@@ -711,13 +420,12 @@ export class VariableDetector extends BaseDetector {
         // 检查是否在函数参数中（已初始化）
         const isParameter = this.isFunctionParameter(varName, functionParameters);
         
-        currentScope.declareVariable(varName, {
+        symbols.declare(varName, {
           type,
           isPointer,
           isInitialized: isParameter || line.includes('='),
           isParameter,
-          line: lineIndex,
-          valueHistory: []
+          line: lineIndex
         });
       }
     }
@@ -726,9 +434,9 @@ export class VariableDetector extends BaseDetector {
   /**
    * 检测变量初始化和赋值 - 增强版，支持值追踪
    */
-  private detectVariableInitialization(line: string, lineIndex: number, scopeStack: ScopeManager[]): void {
+  private detectVariableInitialization(line: string, lineIndex: number, symbols: ScopedSymbolTable<VariableInfo>): void {
     // 检测内存释放
-    this.detectMemoryFree(line, lineIndex, scopeStack);
+    this.detectMemoryFree(line, lineIndex, symbols);
     // malloc/calloc/realloc 赋值
     const memoryPatterns = [
       { pattern: /\b(\w+)\s*=\s*malloc\s*\(/, type: 'malloc' as const, value: 'malloc' },
@@ -737,13 +445,14 @@ export class VariableDetector extends BaseDetector {
     ];
     
     for (const { pattern, type, value } of memoryPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match) {
         const varName = match[1];
-        this.updateVariableInScopes(varName, value, type, lineIndex, scopeStack);
+        this.updateVariableInScopes(varName, value, type, lineIndex, symbols);
         
         // 标记指针空间类型为堆
-        this.updatePointerSpaceType(varName, 'heap', undefined, lineIndex, scopeStack);
+        this.updatePointerSpaceType(varName, 'heap', undefined, lineIndex, symbols);
       }
     }
     
@@ -760,25 +469,28 @@ export class VariableDetector extends BaseDetector {
     ];
     
     for (const { pattern, type, value } of nullPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match) {
         const varName = match[1];
-        this.updateVariableInScopes(varName, value, type, lineIndex, scopeStack);
+        this.updateVariableInScopes(varName, value, type, lineIndex, symbols);
       }
     }
     
     // 取地址赋值
+    countRegex();
     const addressMatch = line.match(/\b(\w+)\s*=\s*&(\w+)/);
     if (addressMatch) {
       const varName = addressMatch[1];
       const targetVar = addressMatch[2];
-      this.updateVariableInScopes(varName, `&${targetVar}`, 'address', lineIndex, scopeStack);
+      this.updateVariableInScopes(varName, `&${targetVar}`, 'address', lineIndex, symbols);
       
       // 标记指针空间类型
-      this.updatePointerSpaceType(varName, 'stack', targetVar, lineIndex, scopeStack);
+      this.updatePointerSpaceType(varName, 'stack', targetVar, lineIndex, symbols);
     }
     
     // 直接赋值（其他值）- 更全面的检测
+    countRegex();
     const directMatch = line.match(/\b(\w+)\s*=\s*([^;]+)/);
     if (directMatch && 
         !line.includes('malloc') && 
@@ -790,74 +502,69 @@ export class VariableDetector extends BaseDetector {
         !line.includes('sizeof')) {
       const varName = directMatch[1];
       const value = directMatch[2].trim();
-      this.updateVariableInScopes(varName, value, 'direct', lineIndex, scopeStack);
+      this.updateVariableInScopes(varName, value, 'direct', lineIndex, symbols);
     }
     
     // scanf初始化
+    countRegex();
     const scanfMatch = line.match(/scanf\s*\([^)]*,\s*&?(\w+)\b/);
     if (scanfMatch) {
       const varName = scanfMatch[1];
-      this.updateVariableInScopes(varName, 'scanf_input', 'scanf', lineIndex, scopeStack);
+      this.updateVariableInScopes(varName, 'scanf_input', 'scanf', lineIndex, symbols);
     }
     
     // 函数调用赋值
+    countRegex();
     const functionMatch = line.match(/\b(\w+)\s*=\s*(\w+)\s*\(/);
     if (functionMatch) {
       const varName = functionMatch[1];
       const funcName = functionMatch[2];
-      this.updateVariableInScopes(varName, `${funcName}()`, 'function_call', lineIndex, scopeStack);
+      this.updateVariableInScopes(varName, `${funcName}()`, 'function_call', lineIndex, symbols);
     }
   }
 
   /**
    * 检测内存释放
    */
-  private detectMemoryFree(line: string, lineIndex: number, scopeStack: ScopeManager[]): void {
+  private detectMemoryFree(line: string, lineIndex: number, symbols: ScopedSymbolTable<VariableInfo>): void {
     // 检测 free() 调用
+    countRegex();
     const freeMatch = line.match(/free\s*\(\s*(\w+)\s*\)/);
     if (freeMatch) {
       const varName = freeMatch[1];
-      this.updateVariableInScopes(varName, 'freed', 'direct', lineIndex, scopeStack);
+      this.updateVariableInScopes(varName, 'freed', 'direct', lineIndex, symbols);
     }
   }
 
   /**
    * 更新指针空间类型
    */
-  private updatePointerSpaceType(varName: string, spaceType: PointerSpaceType, targetVariable?: string, lineIndex?: number, scopeStack?: ScopeManager[]): void {
-    if (scopeStack) {
-      for (const scope of scopeStack) {
-        if (scope.hasVariable(varName)) {
-          const varInfo = scope.getVariable(varName);
-          if (varInfo) {
-            varInfo.spaceType = spaceType;
-            varInfo.targetVariable = targetVariable;
-            if (lineIndex) {
-              varInfo.stackFrameId = `frame_${lineIndex}`;
-            }
-          }
-                break;
-              }
-            }
-          }
+  private updatePointerSpaceType(varName: string, spaceType: PointerSpaceType, targetVariable: string | undefined, lineIndex: number, symbols: ScopedSymbolTable<VariableInfo>): void {
+    const varInfo = symbols.lookup(varName);
+    if (!varInfo) return;
+    varInfo.spaceType = spaceType;
+    varInfo.targetVariable = targetVariable;
+    if (lineIndex) {
+      varInfo.stackFrameId = `frame_${lineIndex}`;
+    }
   }
 
   /**
-   * 在作用域中更新变量值
+   * 更新可见变量的当前值（赋值即视为已初始化）
    */
-  private updateVariableInScopes(varName: string, value: string, assignmentType: ValueAssignment['assignmentType'], lineIndex: number, scopeStack: ScopeManager[]): void {
-    for (const scope of scopeStack) {
-      if (scope.hasVariable(varName)) {
-        scope.updateVariableValue(varName, value, assignmentType, lineIndex);
-        break;
-      }
+  private updateVariableInScopes(varName: string, value: string, assignmentType: AssignmentType, lineIndex: number, symbols: ScopedSymbolTable<VariableInfo>): void {
+    const varInfo = symbols.lookup(varName);
+    if (varInfo) {
+      varInfo.currentValue = value;
+      varInfo.valueLine = lineIndex;
+      varInfo.isInitialized = true;
     }
   }
 
   /**
    * 检测变量使用（可能导致未初始化错误和空指针错误）
    */
-  private detectVariableUsage(line: string, lineIndex: number, scopeStack: ScopeManager[], issues: Issue[], context: DetectionContext): void {
+  private detectVariableUsage(line: string, lineIndex: number, symbols: ScopedSymbolTable<VariableInfo>, issues: Issue[], context: DetectionContext): void {
     // 变量使用模式
     const usagePatterns = [
       /\b(\w+)\s*\+/,  // 加法运算
@@ -874,54 +581,49 @@ export class VariableDetector extends BaseDetector {
     ];
     
     for (const pattern of usagePatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match) {
         const varName = match[1];
         
-        // 在所有作用域中查找变量
-        for (let i = scopeStack.length - 1; i >= 0; i--) {
-          const scope = scopeStack[i];
-          if (scope.hasVariable(varName)) {
-            const varInfo = scope.getVariable(varName);
-            
-            if (varInfo && !varInfo.isInitialized) {
-              if (varInfo.isPointer && line.includes('*' + varName)) {
-                // 野指针解引用
-                issues.push({
-                  file: context.filePath,
-                  line: lineIndex + 1,
-                  category: 'Wild pointer',
-                  message: `野指针解引用：指针 '${varName}' 未初始化`,
-                  codeLine: line
-                });
-              } else if (!varInfo.isPointer) {
-                // 未初始化变量使用
-                issues.push({
-                  file: context.filePath,
-                  line: lineIndex + 1,
-                  category: 'Uninitialized variable',
-                  message: `未初始化变量使用：变量 '${varName}' 在初始化前被使用`,
-                  codeLine: line
-                });
-              }
-            } else if (varInfo && varInfo.isInitialized && varInfo.isPointer) {
-              // 检查空指针解引用
-              this.checkNullPointerDereference(varName, varInfo, line, lineIndex, issues, context, scopeStack);
-              
-              // 检查危险状态
-              if (varInfo.currentValue === 'dangerous') {
-                issues.push({
-                  file: context.filePath,
-                  line: lineIndex + 1,
-                  category: 'Dangerous pointer usage',
-                  message: `危险指针使用：变量 '${varName}' 来自危险函数调用`,
-                  codeLine: line
-                });
-              }
-            }
-                  break;
-                }
-              }
+        // 当前可见的变量（最内层声明）
+        const varInfo = symbols.lookup(varName);
+        
+        if (varInfo && !varInfo.isInitialized) {
+          if (varInfo.isPointer && line.includes('*' + varName)) {
+            // 野指针解引用
+            issues.push({
+              file: context.filePath,
+              line: lineIndex + 1,
+              category: 'Wild pointer',
+              message: `野指针解引用：指针 '${varName}' 未初始化`,
+              codeLine: line
+            });
+          } else if (!varInfo.isPointer) {
+            // 未初始化变量使用
+            issues.push({
+              file: context.filePath,
+              line: lineIndex + 1,
+              category: 'Uninitialized variable',
+              message: `未初始化变量使用：变量 '${varName}' 在初始化前被使用`,
+              codeLine: line
+            });
+          }
+        } else if (varInfo && varInfo.isInitialized && varInfo.isPointer) {
+          // 检查空指针解引用
+          this.checkNullPointerDereference(varName, varInfo, line, lineIndex, issues, context, symbols);
+          
+          // 检查危险状态
+          if (varInfo.currentValue === 'dangerous') {
+            issues.push({
+              file: context.filePath,
+              line: lineIndex + 1,
+              category: 'Dangerous pointer usage',
+              message: `危险指针使用：变量 '${varName}' 来自危险函数调用`,
+              codeLine: line
+            });
+          }
+        }
       }
     }
   }
@@ -929,7 +631,7 @@ export class VariableDetector extends BaseDetector {
   /**
    * 检查空指针解引用
    */
-  private checkNullPointerDereference(varName: string, varInfo: VariableInfo, line: string, lineIndex: number, issues: Issue[], context: DetectionContext, scopeStack: ScopeManager[]): void {
+  private checkNullPointerDereference(varName: string, varInfo: VariableInfo, line: string, lineIndex: number, issues: Issue[], context: DetectionContext, symbols: ScopedSymbolTable<VariableInfo>): void {
     const currentValue = varInfo.currentValue;
     // 检查指针解引用模式
             const derefPatterns = [
@@ -941,13 +643,16 @@ export class VariableDetector extends BaseDetector {
     
     let isDereferencing = false;
             for (const pattern of derefPatterns) {
+      countRegex();
       if (pattern.test(line)) {
         isDereferencing = true;
         break;
       }
     }
     
-    if (isDereferencing && currentValue) {
+    // 行级追踪分不出同一行内的先后：与 free 同一行的使用按发生在释放之前处理
+    const freedOnThisLine = currentValue === 'freed' && varInfo.valueLine === lineIndex;
+    if (isDereferencing && currentValue && !freedOnThisLine) {
       // 检查是否为空值或已释放
       if (currentValue === 'NULL' || currentValue === '0' || currentValue === 'freed') {
                 issues.push({
@@ -964,7 +669,7 @@ export class VariableDetector extends BaseDetector {
       // 检查栈空间有效性
       if (varInfo.spaceType === 'stack' && varInfo.targetVariable) {
         // 检查指向的栈变量是否仍然有效
-        if (!this.isStackVariableValid(varInfo.targetVariable, varInfo.stackFrameId, scopeStack)) {
+        if (!this.isStackVariableValid(varInfo.targetVariable, varInfo.stackFrameId, symbols)) {
           issues.push({
             file: context.filePath,
             line: lineIndex + 1,
@@ -982,6 +687,7 @@ export class VariableDetector extends BaseDetector {
    */
   private handleStackFrameChanges(line: string, lineIndex: number, stackFrames: StackFrame[], currentStackFrame: StackFrame | null): StackFrame | null {
     // 函数定义开始 - 支持返回类型
+    countRegex();
     const functionMatch = line.match(/(\w+\*?)\s+(\w+)\s*\([^)]*\)\s*{/);
     if (functionMatch) {
       const functionName = functionMatch[2];
@@ -1045,6 +751,7 @@ export class VariableDetector extends BaseDetector {
     ];
     
     for (const pattern of returnPatterns) {
+      countRegex();
       const returnMatch = line.match(pattern);
       if (returnMatch) {
         const varName = returnMatch[1];
@@ -1081,6 +788,7 @@ export class VariableDetector extends BaseDetector {
    */
   private detectReturnFreedMemory(line: string, lineIndex: number, stackFrames: StackFrame[], issues: Issue[], context: DetectionContext): void {
     // 检测 return 语句中的变量
+    countRegex();
     const returnMatch = line.match(/return\s+(\w+)/);
     if (returnMatch) {
       const varName = returnMatch[1];
@@ -1123,7 +831,6 @@ export class VariableDetector extends BaseDetector {
         isInitialized: true,
         isParameter: false,
         line: lineIndex,
-        valueHistory: [],
         currentValue: 'true'
       });
     }
@@ -1136,7 +843,6 @@ export class VariableDetector extends BaseDetector {
         isInitialized: true,
         isParameter: false,
         line: lineIndex,
-        valueHistory: [],
         currentValue: 'true'
       });
     }
@@ -1184,6 +890,7 @@ export class VariableDetector extends BaseDetector {
     ];
     
     for (const pattern of declarationPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match && !line.includes('extern') && !line.includes('static') && !line.includes('typedef')) {
         const varName = match[match.length - 1];
@@ -1197,7 +904,6 @@ export class VariableDetector extends BaseDetector {
           isInitialized: line.includes('='),
           isParameter: false,
           line: lineIndex,
-          valueHistory: [],
           spaceType: 'stack'
         };
         
@@ -1211,6 +917,7 @@ export class VariableDetector extends BaseDetector {
    */
   private buildGlobalSymbolTable(line: string, lineIndex: number, globalSymbolTable: GlobalSymbolTable, context: DetectionContext): void {
     // 检测函数定义
+    countRegex();
     const functionMatch = line.match(/(\w+\*?)\s+(\w+)\s*\([^)]*\)\s*{/);
     if (functionMatch) {
       const returnType = functionMatch[1];
@@ -1240,13 +947,16 @@ export class VariableDetector extends BaseDetector {
         dangerousOperations: [],
         returnsLocalAddress: false,
         returnsFreedMemory: false,
-        callsDangerousFunctions: []
+        callsDangerousFunctions: [],
+        freesParameters: [],
+        mayReturnNull: false
       };
       
       globalSymbolTable.addFunctionSummary(summary);
     }
     
     // 检测全局变量定义
+    countRegex();
     const globalVarMatch = line.match(/^(\w+\*?)\s+(\w+)\s*[;=]/);
     if (globalVarMatch && !line.includes('static') && !line.includes('extern')) {
       const varType = globalVarMatch[1];
@@ -1266,6 +976,7 @@ export class VariableDetector extends BaseDetector {
     }
     
     // 检测结构体定义
+    countRegex();
     const structMatch = line.match(/typedef\s+struct[^}]*}\s+(\w+)\s*;/);
     if (structMatch) {
       const structName = structMatch[1];
@@ -1296,13 +1007,13 @@ export class VariableDetector extends BaseDetector {
       /return.*stack/,  // 返回栈变量
     ];
     
-    return dangerousPatterns.some(pattern => pattern.test(line.toLowerCase()));
+    return dangerousPatterns.some(pattern => { countRegex(); return pattern.test(line.toLowerCase()); });
   }
 
   /**
    * 检测跨函数调用
    */
-  private detectCrossFunctionCalls(line: string, lineIndex: number, scopeStack: ScopeManager[], issues: Issue[], context: DetectionContext, globalSymbolTable: GlobalSymbolTable): void {
+  private detectCrossFunctionCalls(line: string, lineIndex: number, symbols: ScopedSymbolTable<VariableInfo>, issues: Issue[], context: DetectionContext, globalSymbolTable: GlobalSymbolTable): void {
     // 检测函数调用模式 - 更全面的模式
     const functionCallPatterns = [
       /\b(\w+)\s*=\s*(\w+)\s*\(/,  // var = func(
@@ -1314,6 +1025,7 @@ export class VariableDetector extends BaseDetector {
     ];
     
     for (const pattern of functionCallPatterns) {
+      countRegex();
       const match = line.match(pattern);
       if (match) {
         // 根据不同的模式提取变量名和函数名
@@ -1343,22 +1055,18 @@ export class VariableDetector extends BaseDetector {
         
         if (isDangerous) {
           // 检查变量是否被赋值给危险函数的返回值
-          for (const scope of scopeStack) {
-            if (scope.hasVariable(varName)) {
-              const varInfo = scope.getVariable(varName);
-              if (varInfo && varInfo.isPointer) {
-                // 标记为危险状态
-                scope.updateVariableValue(varName, 'dangerous', 'function_call', lineIndex);
-                
-                issues.push({
-                  file: context.filePath,
-                  line: lineIndex + 1,
-                  category: 'Dangerous function call',
-                  message: `危险函数调用：变量 '${varName}' 被赋值为危险函数 '${funcName}' 的返回值`,
-                  codeLine: line
-                });
-              }
-            }
+          const varInfo = symbols.lookup(varName);
+          if (varInfo && varInfo.isPointer) {
+            // 标记为危险状态
+            this.updateVariableInScopes(varName, 'dangerous', 'function_call', lineIndex, symbols);
+            
+            issues.push({
+              file: context.filePath,
+              line: lineIndex + 1,
+              category: 'Dangerous function call',
+              message: `危险函数调用：变量 '${varName}' 被赋值为危险函数 '${funcName}' 的返回值`,
+              codeLine: line
+            });
           }
         }
         
@@ -1445,16 +1153,12 @@ export class VariableDetector extends BaseDetector {
   /**
    * 检查栈变量是否仍然有效
    */
-  private isStackVariableValid(targetVariable: string, stackFrameId: string | undefined, scopeStack: ScopeManager[]): boolean {
-    // 简化实现：检查变量是否在当前作用域中
-    for (const scope of scopeStack) {
-      if (scope.hasVariable(targetVariable)) {
-        return true;
-      }
-    }
-    return false;
+  private isStackVariableValid(targetVariable: string, stackFrameId: string | undefined, symbols: ScopedSymbolTable<VariableInfo>): boolean {
+    // 简化实现：检查变量是否仍在可见作用域中
+    return symbols.has(targetVariable);
   }
 
+
   /**
    * 检查变量是否为函数参数
    */
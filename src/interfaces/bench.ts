@@ -0,0 +1,291 @@
+/**
+ * 吞吐量基准测试
+ * 直接驱动 ModularCLI.analyzeDirectory 扫描语料，由流水线自身的跟踪跨度得到
+ * 发现、读取、解析、全程序摘要、各检测器与输出各阶段的耗时；每轮在独立子进程中预热后测量，输出可用于比较的 JSON
+ *
+ * 用法: node ./out/interfaces/bench.js <语料目录> [--engine=auto|ast|heuristic] [--warmup=1] [--runs=5] [--output=bench.json]
+ */
+
+import * as path from 'path';
+import * as fs from 'fs';
+import { Writable } from 'stream';
+import { spawnSync } from 'child_process';
+import { DEFAULT_CONFIG, DetectorConfig } from '../config/detector_config';
+import { ModularCLI } from './modular_cli';
+import { JsonLinesWriter } from '../core/issue_stream';
+import { setTraceListener, TraceEvent } from '../utils/trace';
+
+// 版本 2 起每轮在独立子进程中测量，peakRss 为单轮峰值
+export const BENCH_VERSION = 2;
+
+/**
+ * 各阶段耗时（毫秒）
+ */
+export interface StageTimes {
+  discovery: number;
+  read: number;
+  parse: number;
+  summarize: number;
+  detectors: Record<string, number>;
+  output: number;
+}
+
+/**
+ * 单轮测量结果
+ */
+export interface BenchRun {
+  totalMs: number;
+  filesPerSec: number;
+  linesPerSec: number;
+  /** 单文件延迟（读取 + 解析 + 检测 + 输出）的分位数，毫秒 */
+  latency: { p50: number; p95: number; p99: number; max: number };
+  /** 本轮子进程（含其预热）的峰值常驻内存（字节） */
+  peakRss: number;
+  issues: number;
+  stages: StageTimes;
+}
+
+export interface BenchReport {
+  version: number;
+  corpus: string;
+  engine: DetectorConfig['engine'];
+  node: string;
+  timestamp: string;
+  warmup: number;
+  files: number;
+  lines: number;
+  runs: BenchRun[];
+}
+
+export interface BenchOptions {
+  engine: DetectorConfig['engine'];
+  warmup: number;
+  runs: number;
+}
+
+function elapsed(start: bigint): number {
+  return Number(process.hrtime.bigint() - start) / 1e6;
+}
+
+function percentile(sorted: Float64Array, p: number): number {
+  if (sorted.length === 0) return 0;
+  const rank = Math.min(sorted.length - 1, Math.max(0, Math.ceil(p * sorted.length) - 1));
+  return sorted[rank];
+}
+
+type RunResult = BenchRun & { lineCount: number; fileCount: number; engine: DetectorConfig['engine'] };
+
+/**
+ * 用 ModularCLI 的流水线完整扫描一轮；各阶段耗时取自该流水线自身的跟踪跨度
+ */
+async function runOnce(dir: string, config: DetectorConfig): Promise<RunResult> {
+  const stages: StageTimes = { discovery: 0, read: 0, parse: 0, summarize: 0, detectors: {}, output: 0 };
+  const cli = new ModularCLI({ ...config, advanced: { ...config.advanced } });
+  for (const name of cli.getEnabledDetectorNames()) stages.detectors[name] = 0;
+  // 单文件延迟 = 读取 + 解析 + 检测与输出（analyze 跨度）
+  const latencies = new Map<string, number>();
+  const addLatency = (file: unknown, ms: number) => {
+    if (typeof file === 'string') latencies.set(file, (latencies.get(file) ?? 0) + ms);
+  };
+  let fileCount = 0;
+  let lineCount = 0;
+  // 只取各阶段的顶层跨度：parse 类中的 init/convert、summary 类中的各分量都已含在上层跨度里
+  setTraceListener((event: TraceEvent) => {
+    const ms = (event.dur ?? 0) / 1000;
+    const args = event.args ?? {};
+    switch (event.cat) {
+      case 'scan':
+        if (event.name === 'discovery') {
+          stages.discovery += ms;
+          fileCount = Number(args.files) || 0;
+        } else if (event.name === 'analyze') {
+          addLatency(args.file, ms);
+        }
+        break;
+      case 'io':
+        stages.read += ms;
+        lineCount += Number(args.lines) || 0;
+        addLatency(args.file, ms);
+        break;
+      case 'parse':
+        if (event.name.startsWith('parse.')) {
+          stages.parse += ms;
+          addLatency(args.file, ms);
+        }
+        break;
+      case 'summary':
+        if (event.name === 'summarize') stages.summarize += ms;
+        break;
+      case 'detector':
+        stages.detectors[event.name] = (stages.detectors[event.name] ?? 0) + ms;
+        break;
+      case 'output':
+        stages.output += ms;
+        break;
+    }
+  });
+
+  const writer = new JsonLinesWriter(new Writable({ write: (_chunk, _encoding, callback) => callback() }), true);
+  let issueCount = 0;
+  const runStart = process.hrtime.bigint();
+  try {
+    await cli.analyzeDirectory(dir, async (file, issues) => {
+      issueCount += issues.length;
+      await writer.writeFile(file, issues);
+    });
+  } finally {
+    setTraceListener(null);
+  }
+  const t = process.hrtime.bigint();
+  await writer.close();
+  stages.output += elapsed(t);
+
+  const totalMs = elapsed(runStart);
+  const sorted = Float64Array.from(latencies.values()).sort();
+  return {
+    totalMs,
+    filesPerSec: totalMs > 0 ? fileCount / (totalMs / 1000) : 0,
+    linesPerSec: totalMs > 0 ? lineCount / (totalMs / 1000) : 0,
+    latency: {
+      p50: percentile(sorted, 0.5),
+      p95: percentile(sorted, 0.95),
+      p99: percentile(sorted, 0.99),
+      max: sorted.length > 0 ? sorted[sorted.length - 1] : 0
+    },
+    peakRss: process.resourceUsage().maxRSS * 1024,
+    issues: issueCount,
+    stages,
+    lineCount,
+    fileCount,
+    engine: cli.getConfig().engine
+  };
+}
+
+/**
+ * 在当前进程中预热 warmup 轮（不计入结果）后测量一轮
+ */
+async function measureRun(dir: string, engine: DetectorConfig['engine'], warmup: number): Promise<RunResult> {
+  const config: DetectorConfig = { ...DEFAULT_CONFIG, engine, advanced: { ...DEFAULT_CONFIG.advanced } };
+  const gc = (global as { gc?: () => void }).gc;
+  for (let i = 0; i < warmup; i++) await runOnce(dir, config);
+  if (gc) gc();
+  return runOnce(dir, config);
+}
+
+/**
+ * 在子进程中测量一轮：峰值 RSS 是进程级的，同一进程中后面各轮只会继承前面的峰值
+ */
+function runInChild(dir: string, engine: DetectorConfig['engine'], warmup: number): RunResult {
+  const args = [...process.execArgv, __filename, dir, `--engine=${engine}`, `--warmup=${warmup}`, '--child'];
+  const child = spawnSync(process.execPath, args, { encoding: 'utf8', maxBuffer: 64 * 1024 * 1024 });
+  if (child.status === 0) {
+    try {
+      return JSON.parse(child.stdout) as RunResult;
+    } catch {
+      // 输出不完整，按失败处理
+    }
+  }
+  throw new Error((child.stderr || '').trim().split('\n').pop() || `子进程退出码 ${child.status}`);
+}
+
+/**
+ * 测量 runs 轮，每轮在独立子进程中预热 warmup 轮后测量
+ */
+export async function runBenchmark(dir: string, options: BenchOptions): Promise<BenchReport> {
+  let engine = options.engine;
+  const runs: BenchRun[] = [];
+  let files = 0;
+  let lines = 0;
+  for (let i = 0; i < options.runs; i++) {
+    const { lineCount, fileCount, engine: used, ...run } = runInChild(dir, options.engine, options.warmup);
+    // 解析器不可用时 CLI 会退回启发式模式；明确要求 AST 时这样的结果没有意义
+    if (options.engine === 'ast' && used !== 'ast') throw new Error('AST解析器不可用');
+    engine = used;
+    files = fileCount;
+    lines = lineCount;
+    runs.push(run);
+  }
+
+  return {
+    version: BENCH_VERSION,
+    corpus: dir,
+    engine,
+    node: process.version,
+    timestamp: new Date().toISOString(),
+    warmup: options.warmup,
+    files,
+    lines,
+    runs
+  };
+}
+
+function median(values: number[]): number {
+  const sorted = [...values].sort((a, b) => a - b);
+  const mid = sorted.length >> 1;
+  return sorted.length === 0 ? 0 : sorted.length % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+/**
+ * 打印各轮中位数
+ */
+export function printBenchReport(report: BenchReport): void {
+  const runs = report.runs;
+  const pick = (f: (run: BenchRun) => number) => median(runs.map(f));
+  console.error(`\n=== 基准测试: ${report.corpus} (${report.engine}) ===`);
+  console.error(`文件: ${report.files}，行数: ${report.lines}，测量 ${runs.length} 轮（预热 ${report.warmup} 轮）`);
+  console.error(`总耗时: ${pick(r => r.totalMs).toFixed(1)} ms`);
+  console.error(`吞吐量: ${pick(r => r.filesPerSec).toFixed(1)} 文件/s，${pick(r => r.linesPerSec).toFixed(0)} 行/s`);
+  console.error(`单文件延迟: p50 ${pick(r => r.latency.p50).toFixed(2)} ms，p95 ${pick(r => r.latency.p95).toFixed(2)} ms，p99 ${pick(r => r.latency.p99).toFixed(2)} ms`);
+  console.error(`峰值 RSS: ${(pick(r => r.peakRss) / 1048576).toFixed(1)} MB（每轮子进程）`);
+  console.error('阶段耗时 (ms):');
+  for (const stage of ['discovery', 'read', 'parse', 'summarize', 'output'] as const) {
+    console.error(`  ${stage}: ${pick(r => r.stages[stage]).toFixed(2)}`);
+  }
+  for (const name of Object.keys(runs[0]?.stages.detectors ?? {})) {
+    console.error(`  ${name}: ${pick(r => r.stages.detectors[name]).toFixed(2)}`);
+  }
+}
+
+export function parseBenchArgs(args: string[]): { dir: string; options: BenchOptions; output?: string } {
+  const value = (name: string) => {
+    const arg = args.find(a => a.startsWith(`--${name}=`));
+    return arg ? arg.slice(name.length + 3) : undefined;
+  };
+  const positional = args.filter(a => !a.startsWith('--'));
+  const engine = value('engine');
+  const output = value('output');
+  return {
+    dir: path.resolve(positional[0] ?? 'tests/corpus'),
+    options: {
+      engine: engine === 'ast' || engine === 'heuristic' ? engine : 'auto',
+      warmup: Math.max(0, Number(value('warmup') ?? 1) || 0),
+      runs: Math.max(1, Number(value('runs') ?? 5) || 1)
+    },
+    output: output ? path.resolve(output) : undefined
+  };
+}
+
+async function main() {
+  const { dir, options, output } = parseBenchArgs(process.argv.slice(2));
+  if (process.argv.includes('--child')) {
+    process.stdout.write(JSON.stringify(await measureRun(dir, options.engine, options.warmup)) + '\n');
+    return;
+  }
+  const report = await runBenchmark(dir, options);
+  printBenchReport(report);
+  const json = JSON.stringify(report, null, 2);
+  if (output) {
+    fs.writeFileSync(output, json + '\n', 'utf8');
+    console.error(`结果已写入: ${output}`);
+  } else {
+    process.stdout.write(json + '\n');
+  }
+}
+
+// 如果直接运行此文件
+if (require.main === module) {
+  main().catch(err => {
+    console.error('基准测试失败:', err);
+    process.exit(1);
+  });
+}
@@ -0,0 +1,230 @@
+/**
+ * 性能回归检查
+ * 读取已保存的基准结果（按语料与引擎区分），以当前构建重新测量，
+ * 对总耗时、各阶段、各检测器与峰值内存做 Welch t 置信区间比较，超过阈值的显著变慢时以非零状态退出
+ *
+ * 用法: node ./out/interfaces/bench_compare.js <语料目录> --baseline=<文件或目录> [--engine=auto|ast|heuristic]
+ *         [--runs=5] [--warmup=1] [--threshold=0.1] [--memory-threshold=0.1] [--confidence=0.95]
+ *         [--min-ms=1] [--update] [--output=current.json]
+ *
+ *   --baseline 为目录时使用其中的 <语料目录名>.<引擎>.json
+ *   --update   比较后把本次结果写为新的基线
+ */
+
+import * as path from 'path';
+import * as fs from 'fs';
+import { BenchReport, BenchRun, parseBenchArgs, printBenchReport, runBenchmark } from './bench';
+
+/**
+ * 一个指标的比较结果；变化量都是相对基线均值的比例
+ */
+export interface MetricComparison {
+  metric: string;
+  baseline: number;
+  current: number;
+  change: number;
+  /** 相对变化的置信区间 */
+  low: number;
+  high: number;
+  regression: boolean;
+}
+
+export interface CompareOptions {
+  /** 允许的耗时增长比例 */
+  threshold: number;
+  /** 允许的峰值内存增长比例 */
+  memoryThreshold: number;
+  confidence: number;
+  /** 基线与当前均值都低于该值（毫秒）的阶段不参与判定，避免噪声 */
+  minMs: number;
+}
+
+/**
+ * 基线文件路径：给出目录时按语料与引擎命名
+ */
+export function baselinePath(baseline: string, corpus: string, engine: string): string {
+  if (fs.existsSync(baseline) && fs.statSync(baseline).isDirectory()) {
+    return path.join(baseline, `${path.basename(corpus)}.${engine}.json`);
+  }
+  return baseline;
+}
+
+/**
+ * 逐指标比较两份报告
+ */
+export function compareReports(baseline: BenchReport, current: BenchReport, options: CompareOptions): MetricComparison[] {
+  const metrics: Array<[string, (run: BenchRun) => number | undefined, boolean]> = [
+    ['total', run => run.totalMs, false],
+    ['latency.p95', run => run.latency.p95, false]
+  ];
+  for (const stage of ['discovery', 'read', 'parse', 'summarize', 'output'] as const) {
+    metrics.push([`stage.${stage}`, run => run.stages[stage], false]);
+  }
+  const detectors = new Set([...Object.keys(baseline.runs[0]?.stages.detectors ?? {}), ...Object.keys(current.runs[0]?.stages.detectors ?? {})]);
+  for (const name of detectors) {
+    metrics.push([`detector.${name}`, run => run.stages.detectors[name], false]);
+  }
+  // 版本 1 的 peakRss 是同一进程多轮累计的峰值，与单轮峰值不可比
+  if (baseline.version === current.version) metrics.push(['peakRss', run => run.peakRss, true]);
+
+  const results: MetricComparison[] = [];
+  for (const [metric, select, memory] of metrics) {
+    const a = samples(baseline.runs, select);
+    const b = samples(current.runs, select);
+    if (a.length === 0 || b.length === 0) continue;
+    const meanA = mean(a);
+    const meanB = mean(b);
+    if (meanA <= 0) continue;
+    const { low, high } = welchInterval(a, b, options.confidence);
+    const comparison: MetricComparison = {
+      metric,
+      baseline: meanA,
+      current: meanB,
+      change: (meanB - meanA) / meanA,
+      low: low / meanA,
+      high: high / meanA,
+      regression: false
+    };
+    const limit = memory ? options.memoryThreshold : options.threshold;
+    const measurable = memory || Math.max(meanA, meanB) >= options.minMs;
+    // 只有置信区间下界也超过阈值时才算显著变慢
+    comparison.regression = measurable && comparison.low > limit;
+    results.push(comparison);
+  }
+  return results;
+}
+
+function samples(runs: BenchRun[], select: (run: BenchRun) => number | undefined): number[] {
+  const values: number[] = [];
+  for (const run of runs) {
+    const value = select(run);
+    if (typeof value === 'number' && Number.isFinite(value)) values.push(value);
+  }
+  return values;
+}
+
+function mean(values: number[]): number {
+  return values.reduce((sum, v) => sum + v, 0) / values.length;
+}
+
+function variance(values: number[], m: number): number {
+  if (values.length < 2) return 0;
+  return values.reduce((sum, v) => sum + (v - m) * (v - m), 0) / (values.length - 1);
+}
+
+/**
+ * 均值差 mean(b) - mean(a) 的 Welch t 置信区间；任一侧不足两个样本时退化为点估计
+ */
+export function welchInterval(a: number[], b: number[], confidence: number): { low: number; high: number } {
+  const meanA = mean(a);
+  const meanB = mean(b);
+  const diff = meanB - meanA;
+  const va = variance(a, meanA) / a.length;
+  const vb = variance(b, meanB) / b.length;
+  const se = Math.sqrt(va + vb);
+  if (a.length < 2 || b.length < 2 || se === 0) return { low: diff, high: diff };
+  // Welch–Satterthwaite 自由度
+  const df = (va + vb) * (va + vb) / ((va * va) / (a.length - 1) + (vb * vb) / (b.length - 1));
+  const t = studentQuantile(1 - (1 - confidence) / 2, df);
+  return { low: diff - t * se, high: diff + t * se };
+}
+
+/**
+ * t 分布分位数：正态分位数加 Cornish–Fisher 展开
+ */
+function studentQuantile(p: number, df: number): number {
+  const z = normalQuantile(p);
+  const z2 = z * z;
+  return z
+    + z * (z2 + 1) / (4 * df)
+    + z * ((5 * z2 + 16) * z2 + 3) / (96 * df * df)
+    + z * (((3 * z2 + 19) * z2 + 17) * z2 - 15) / (384 * df * df * df);
+}
+
+/**
+ * 标准正态分位数（Acklam 有理逼近，相对误差约 1e-9）
+ */
+function normalQuantile(p: number): number {
+  const a = [-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00];
+  const b = [-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01];
+  const c = [-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00];
+  const d = [7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00];
+  const low = 0.02425;
+  if (p < low) {
+    const q = Math.sqrt(-2 * Math.log(p));
+    return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+  }
+  if (p > 1 - low) return -normalQuantile(1 - p);
+  const q = p - 0.5;
+  const r = q * q;
+  return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+function printComparison(results: MetricComparison[], options: CompareOptions): void {
+  const percent = (x: number) => `${x >= 0 ? '+' : ''}${(x * 100).toFixed(1)}%`;
+  console.error(`\n=== 与基线比较（${(options.confidence * 100).toFixed(0)}% 置信区间，耗时阈值 ${percent(options.threshold)}，内存阈值 ${percent(options.memoryThreshold)}） ===`);
+  for (const r of results) {
+    const unit = r.metric === 'peakRss' ? 'MB' : 'ms';
+    const scale = r.metric === 'peakRss' ? 1 / 1048576 : 1;
+    const mark = r.regression ? '✗ 回归' : '';
+    console.error(`  ${r.metric.padEnd(32)} ${(r.baseline * scale).toFixed(2).padStart(10)} → ${(r.current * scale).toFixed(2).padStart(10)} ${unit}  ${percent(r.change).padStart(8)} [${percent(r.low)}, ${percent(r.high)}] ${mark}`);
+  }
+}
+
+async function main() {
+  const args = process.argv.slice(2);
+  const value = (name: string) => {
+    const arg = args.find(a => a.startsWith(`--${name}=`));
+    return arg ? arg.slice(name.length + 3) : undefined;
+  };
+  const { dir, options, output } = parseBenchArgs(args);
+  const baselineArg = value('baseline');
+  if (!baselineArg) {
+    console.error('缺少 --baseline=<文件或目录>');
+    process.exit(2);
+  }
+  const compare: CompareOptions = {
+    threshold: Number(value('threshold') ?? 0.1),
+    memoryThreshold: Number(value('memory-threshold') ?? 0.1),
+    confidence: Math.min(0.999, Math.max(0.5, Number(value('confidence') ?? 0.95))),
+    minMs: Number(value('min-ms') ?? 1)
+  };
+
+  const current = await runBenchmark(dir, options);
+  printBenchReport(current);
+  if (output) fs.writeFileSync(output, JSON.stringify(current, null, 2) + '\n', 'utf8');
+
+  const file = baselinePath(path.resolve(baselineArg), dir, current.engine);
+  let regressions = 0;
+  if (fs.existsSync(file)) {
+    const baseline = JSON.parse(fs.readFileSync(file, 'utf8')) as BenchReport;
+    if (baseline.engine !== current.engine || baseline.files !== current.files || baseline.lines !== current.lines) {
+      console.error(`警告: 基线 ${file} 的语料或引擎与本次不同（${baseline.engine}, ${baseline.files} 个文件, ${baseline.lines} 行）`);
+    }
+    const results = compareReports(baseline, current, compare);
+    printComparison(results, compare);
+    regressions = results.filter(r => r.regression).length;
+  } else if (!args.includes('--update')) {
+    console.error(`基线不存在: ${file}（使用 --update 创建）`);
+    process.exit(2);
+  }
+
+  if (args.includes('--update')) {
+    fs.mkdirSync(path.dirname(file), { recursive: true });
+    fs.writeFileSync(file, JSON.stringify(current, null, 2) + '\n', 'utf8');
+    console.error(`基线已更新: ${file}`);
+  }
+
+  if (regressions > 0) {
+    console.error(`\n发现 ${regressions} 项显著性能回归`);
+    process.exit(1);
+  }
+}
+
+// 如果直接运行此文件
+if (require.main === module) {
+  main().catch(err => {
+    console.error('性能比较失败:', err);
+    process.exit(1);
+  });
+}
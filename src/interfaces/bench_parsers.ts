@@ -0,0 +1,294 @@
+/**
+ * 解析后端对比基准
+ * 同一语料分别交给原生 tree-sitter、web-tree-sitter(WASM) 与 clang 后端，每个后端在独立子进程中测量
+ * 初始化耗时、解析吞吐量、节点转换耗时、AST 常驻内存，并以第一个可用后端为参照比较检测结果的差异
+ *
+ * 用法: node --expose-gc ./out/interfaces/bench_parsers.js <语料目录> [--backends=native,wasm,clang]
+ *         [--warmup=1] [--runs=3] [--output=parsers.json]
+ *
+ *   --backend=<名称>  只在当前进程测量单个后端并向标准输出写 JSON（父进程内部使用）
+ */
+
+import * as path from 'path';
+import * as fs from 'fs';
+import { spawnSync } from 'child_process';
+import { CASTParser, ASTNode, ParserBackend } from '../core/ast_parser';
+import { DEFAULT_CONFIG, DetectorConfig } from '../config/detector_config';
+import { DetectorManager } from '../detectors/detector_manager';
+import { AnalysisSession } from '../analysis/session';
+import { discoverSources } from '../utils/sources';
+import { now } from '../utils/instrumentation';
+
+export const PARSER_BACKENDS: ParserBackend[] = ['native', 'wasm', 'clang'];
+
+/**
+ * 单个后端的测量结果；不可用时只有 error
+ */
+export interface ParserBenchResult {
+  backend: ParserBackend;
+  error?: string;
+  /** CASTParser.create 耗时（进程内首次，含模块与语法加载） */
+  initMs: number;
+  files: number;
+  lines: number;
+  bytes: number;
+  /** 解析失败的文件数 */
+  failures: number;
+  /** 各轮的后端解析与节点转换总耗时（毫秒） */
+  parseMs: number[];
+  convertMs: number[];
+  /** 各轮中位数对应的吞吐量 */
+  linesPerSec: number;
+  bytesPerSec: number;
+  nodes: number;
+  /** 保留全部 AST 时的堆增长（字节）；未以 --expose-gc 运行时受 GC 时机影响 */
+  astBytes: number;
+  /** 检测结果，"相对路径:行:类别:消息" */
+  issues: string[];
+}
+
+/**
+ * 与参照后端的检测结果差异
+ */
+export interface ParityResult {
+  backend: ParserBackend;
+  reference: ParserBackend;
+  issues: number;
+  /** 只在本后端出现的问题 */
+  extra: string[];
+  /** 只在参照后端出现的问题 */
+  missing: string[];
+}
+
+export interface ParserBenchOptions {
+  warmup: number;
+  runs: number;
+}
+
+function median(values: number[]): number {
+  const sorted = [...values].sort((a, b) => a - b);
+  const mid = sorted.length >> 1;
+  return sorted.length === 0 ? 0 : sorted.length % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+function countNodes(root: ASTNode): number {
+  let count = 0;
+  const stack: ASTNode[] = [root];
+  while (stack.length > 0) {
+    const node = stack.pop()!;
+    count++;
+    for (const child of node.children) stack.push(child);
+  }
+  return count;
+}
+
+/**
+ * 在当前进程中测量一个后端
+ */
+export async function benchParserBackend(dir: string, backend: ParserBackend, options: ParserBenchOptions): Promise<ParserBenchResult> {
+  const result: ParserBenchResult = {
+    backend, initMs: 0, files: 0, lines: 0, bytes: 0, failures: 0,
+    parseMs: [], convertMs: [], linesPerSec: 0, bytesPerSec: 0, nodes: 0, astBytes: 0, issues: []
+  };
+  const sources = discoverSources(dir).map(relative => {
+    const file = path.join(dir, relative);
+    const content = fs.readFileSync(file, 'utf8');
+    return { file, content, lines: content.split('\n') };
+  });
+  result.files = sources.length;
+  for (const source of sources) {
+    result.lines += source.lines.length;
+    result.bytes += Buffer.byteLength(source.content);
+  }
+
+  let parser: CASTParser;
+  const start = now();
+  try {
+    parser = await CASTParser.create(backend);
+  } catch (error: any) {
+    result.error = error?.message ?? String(error);
+    return result;
+  }
+  result.initMs = now() - start;
+
+  // 计时轮：只保留最后一轮的 AST，供内存与检测使用
+  let asts: Array<ASTNode | undefined> = [];
+  for (let round = 0; round < options.warmup + options.runs; round++) {
+    let parseMs = 0;
+    let convertMs = 0;
+    let failures = 0;
+    asts = [];
+    for (const source of sources) {
+      try {
+        const timed = parser.parseTimed(source.content);
+        parseMs += timed.parseMs;
+        convertMs += timed.convertMs;
+        asts.push(timed.ast);
+      } catch {
+        failures++;
+        asts.push(undefined);
+      }
+    }
+    result.failures = failures;
+    if (round >= options.warmup) {
+      result.parseMs.push(parseMs);
+      result.convertMs.push(convertMs);
+    }
+  }
+  const seconds = (median(result.parseMs) + median(result.convertMs)) / 1000;
+  result.linesPerSec = seconds > 0 ? result.lines / seconds : 0;
+  result.bytesPerSec = seconds > 0 ? result.bytes / seconds : 0;
+
+  // AST 内存：释放上一轮的树后重新解析一遍并整体保留
+  const gc = (global as { gc?: () => void }).gc;
+  asts = [];
+  if (gc) gc();
+  const heap = process.memoryUsage().heapUsed;
+  for (const source of sources) {
+    try {
+      asts.push(parser.parse(source.content));
+    } catch {
+      asts.push(undefined);
+    }
+  }
+  if (gc) gc();
+  result.astBytes = Math.max(0, process.memoryUsage().heapUsed - heap);
+  for (const ast of asts) if (ast) result.nodes += countNodes(ast);
+
+  // 检测一致性：全部检测器在各后端的 AST 上运行，解析失败的文件按启发式检测
+  const config: DetectorConfig = { ...DEFAULT_CONFIG, engine: 'ast', advanced: { ...DEFAULT_CONFIG.advanced } };
+  const manager = new DetectorManager(config);
+  for (let i = 0; i < sources.length; i++) {
+    const source = sources[i];
+    const ast = asts[i];
+    const issues = await manager.detect({
+      filePath: source.file,
+      content: source.content,
+      lines: source.lines,
+      ast,
+      config,
+      analyses: ast ? AnalysisSession.for(ast, source.lines) : undefined
+    });
+    const relative = path.relative(dir, source.file);
+    for (const issue of issues) result.issues.push(`${relative}:${issue.line}:${issue.category}:${issue.message}`);
+  }
+  result.issues.sort();
+  return result;
+}
+
+/**
+ * 以 reference 为参照比较检测结果（按多重集合比较，同一问题出现多次时逐次计数）
+ */
+export function compareParity(reference: ParserBenchResult, result: ParserBenchResult): ParityResult {
+  const counts = new Map<string, number>();
+  for (const issue of reference.issues) counts.set(issue, (counts.get(issue) || 0) + 1);
+  const extra: string[] = [];
+  for (const issue of result.issues) {
+    const n = counts.get(issue) || 0;
+    if (n > 0) counts.set(issue, n - 1);
+    else extra.push(issue);
+  }
+  const missing: string[] = [];
+  for (const [issue, n] of counts) for (let k = 0; k < n; k++) missing.push(issue);
+  return { backend: result.backend, reference: reference.backend, issues: result.issues.length, extra, missing };
+}
+
+/**
+ * 在子进程中测量一个后端，避免模块加载、WASM 堆与 GC 状态互相影响
+ */
+function benchInChild(dir: string, backend: ParserBackend, options: ParserBenchOptions): ParserBenchResult {
+  const args = [...process.execArgv, __filename, dir, `--backend=${backend}`, `--warmup=${options.warmup}`, `--runs=${options.runs}`];
+  const child = spawnSync(process.execPath, args, { encoding: 'utf8', maxBuffer: 256 * 1024 * 1024 });
+  if (child.status === 0) {
+    try {
+      return JSON.parse(child.stdout) as ParserBenchResult;
+    } catch {
+      // 输出不完整，按失败处理
+    }
+  }
+  const message = (child.stderr || '').trim().split('\n').pop() || `子进程退出码 ${child.status}`;
+  return {
+    backend, error: message, initMs: 0, files: 0, lines: 0, bytes: 0, failures: 0,
+    parseMs: [], convertMs: [], linesPerSec: 0, bytesPerSec: 0, nodes: 0, astBytes: 0, issues: []
+  };
+}
+
+function printParserReport(results: ParserBenchResult[], parity: ParityResult[]): void {
+  console.error('\n=== 解析后端对比 ===');
+  console.error(['后端'.padEnd(8), '初始化(ms)', '解析(ms)', '转换(ms)', '行/s', 'MB/s', '失败', '节点', 'AST(MB)', 'B/节点', '问题'].map((h, i) => i === 0 ? h : h.padStart(11)).join(''));
+  for (const r of results) {
+    if (r.error) {
+      console.error(`${r.backend.padEnd(8)} 不可用: ${r.error}`);
+      continue;
+    }
+    const cells = [
+      r.initMs.toFixed(1), median(r.parseMs).toFixed(1), median(r.convertMs).toFixed(1),
+      r.linesPerSec.toFixed(0), (r.bytesPerSec / 1048576).toFixed(2), r.failures, r.nodes,
+      (r.astBytes / 1048576).toFixed(1), r.nodes > 0 ? (r.astBytes / r.nodes).toFixed(0) : '-', r.issues.length
+    ];
+    console.error(r.backend.padEnd(8) + cells.map(cell => String(cell).padStart(11)).join(''));
+  }
+  for (const p of parity) {
+    console.error(`\n${p.backend} 相对 ${p.reference}: 多出 ${p.extra.length} 个问题，缺少 ${p.missing.length} 个问题`);
+    for (const issue of p.extra.slice(0, 10)) console.error(`  + ${issue}`);
+    for (const issue of p.missing.slice(0, 10)) console.error(`  - ${issue}`);
+  }
+}
+
+async function main() {
+  const args = process.argv.slice(2);
+  const value = (name: string) => {
+    const arg = args.find(a => a.startsWith(`--${name}=`));
+    return arg ? arg.slice(name.length + 3) : undefined;
+  };
+  const positional = args.filter(a => !a.startsWith('--'));
+  const dir = path.resolve(positional[0] ?? 'tests/corpus');
+  const options: ParserBenchOptions = {
+    warmup: Math.max(0, Number(value('warmup') ?? 1) || 0),
+    runs: Math.max(1, Number(value('runs') ?? 3) || 1)
+  };
+
+  const single = value('backend');
+  if (single) {
+    if (!PARSER_BACKENDS.includes(single as ParserBackend)) throw new Error(`未知解析后端: ${single}`);
+    const result = await benchParserBackend(dir, single as ParserBackend, options);
+    process.stdout.write(JSON.stringify(result) + '\n');
+    return;
+  }
+
+  const backends = (value('backends') ?? PARSER_BACKENDS.join(',')).split(',').filter(Boolean) as ParserBackend[];
+  for (const backend of backends) {
+    if (!PARSER_BACKENDS.includes(backend)) throw new Error(`未知解析后端: ${backend}`);
+  }
+  const results: ParserBenchResult[] = [];
+  for (const backend of backends) {
+    console.error(`正在测量 ${backend} ...`);
+    results.push(benchInChild(dir, backend, options));
+  }
+  const available = results.filter(r => !r.error);
+  const parity = available.slice(1).map(r => compareParity(available[0], r));
+  printParserReport(results, parity);
+
+  // 报告中只保留问题数，差异明细见 parity
+  const report = {
+    corpus: dir, node: process.version, timestamp: new Date().toISOString(), ...options,
+    results: results.map(({ issues, ...rest }) => ({ ...rest, issueCount: issues.length })),
+    parity
+  };
+  const json = JSON.stringify(report, null, 2);
+  const output = value('output');
+  if (output) {
+    fs.writeFileSync(path.resolve(output), json + '\n', 'utf8');
+    console.error(`结果已写入: ${path.resolve(output)}`);
+  } else {
+    process.stdout.write(json + '\n');
+  }
+}
+
+// 如果直接运行此文件
+if (require.main === module) {
+  main().catch(err => {
+    console.error('解析后端基准测试失败:', err);
+    process.exit(1);
+  });
+}
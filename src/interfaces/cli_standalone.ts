@@ -2,6 +2,7 @@ import * as path from 'path';
 import * as fs from 'fs';
 import { Issue } from './types';
 import { CASTParser } from '../core/ast_parser';
+import { AnalysisSession, SYMBOLS } from '../analysis/session';
 import { VariableDetector } from '../detectors/variable_detector';
 import { HeaderDetector } from '../detectors/header_detector';
 import { NumericDetector } from '../detectors/numeric_detector';
@@ -9,13 +10,27 @@ import { ControlFlowDetector } from '../detectors/control_flow_detector';
 import { MemoryDetector } from '../detectors/memory_detector';
 import { FormatDetector } from '../detectors/format_detector';
 import { ASTUsageDetector } from '../detectors/ast_usage_detector';
+import { BracketIndex } from '../utils/bracket_index';
+import { parseFormat } from '../utils/format_spec';
+import { IssueSink, IssueWriter, OutputFormat, parseOutputFormat } from '../core/issue_stream';
+import { IssueStore } from '../core/issue_store';
+import { assignFingerprints, fingerprintValue, FingerprintBaseline } from '../core/fingerprint';
+import { detectorCounters } from '../detectors/base_detector';
+import { setInstrumentation } from '../utils/instrumentation';
+import { tracing, startTracing, traceStart, traceSpan, writeTrace } from '../utils/trace';
+import { getLogger, configureLogging, parseLogArgs } from '../utils/logger';
+import { discoverSources } from '../utils/sources';
+
+const log = getLogger('cli');
 
 type EngineMode = 'auto' | 'ast' | 'heuristic';
 
-// 基于AST的CLI版本目录分析函数（支持引擎模式）
-async function analyzeDir(dir: string, engine: EngineMode): Promise<Issue[]> {
-  const files = fs.readdirSync(dir).filter(f => f.endsWith('.c'));
-  const issues: Issue[] = [];
+// 基于AST的CLI版本目录分析函数（支持引擎模式）；给出 sink 时逐文件交出问题而不累积
+async function analyzeDir(dir: string, engine: EngineMode, sink?: IssueSink): Promise<IssueStore> {
+  let start = traceStart();
+  const files = discoverSources(dir);
+  if (tracing.enabled) traceSpan('discovery', 'scan', start, { dir, files: files.length });
+  const allIssues = new IssueStore();
   
   // 检查AST解析器是否可用
   let astAvailable = false;
@@ -23,21 +38,26 @@ async function analyzeDir(dir: string, engine: EngineMode): Promise<Issue[]> {
   
   try {
     if (engine !== 'heuristic') {
+      start = traceStart();
       parser = await CASTParser.create();
+      if (tracing.enabled) traceSpan(`init.${parser.backend}`, 'parse', start);
       astAvailable = true;
-      console.log('AST parser initialized successfully');
+      log.info('AST parser initialized', { backend: parser.backend });
     }
   } catch (error) {
-    console.log('AST parser initialization failed, using text analysis mode');
+    log.warn('AST parser initialization failed, using text analysis mode', { error: String(error) });
     astAvailable = false;
   }
   
   for (const file of files) {
     const filePath = path.join(dir, file);
+    start = traceStart();
     const content = fs.readFileSync(filePath, 'utf8');
     const lines = content.split('\n');
+    if (tracing.enabled) traceSpan('read', 'io', start, { file: filePath, bytes: content.length });
+    const issues: Issue[] = [];
     
-    console.log(`正在分析文件: ${file}`);
+    if (log.debugEnabled) log.debug('正在分析文件', { file });
     
     if ((engine === 'ast' || engine === 'auto') && astAvailable && parser) {
       let ast: any = null;
@@ -45,11 +65,13 @@ async function analyzeDir(dir: string, engine: EngineMode): Promise<Issue[]> {
       
       try {
         // 尝试使用AST解析
+        start = traceStart();
         ast = parser.parse(content);
+        if (tracing.enabled) traceSpan(`parse.${parser.backend}`, 'parse', start, { file: filePath });
         astParseSuccess = true;
-        console.log(`  AST parsing successful, using hybrid detection mode`);
+        if (log.debugEnabled) log.debug('AST parsing successful, using hybrid detection mode', { file });
       } catch (error: any) {
-        console.error(`  AST parsing failed, using heuristic fallback: ${error}`);
+        log.warn('AST parsing failed, using heuristic fallback', { file, error: String(error) });
         astParseSuccess = false;
       }
       
@@ -62,7 +84,9 @@ async function analyzeDir(dir: string, engine: EngineMode): Promise<Issue[]> {
           content,
           lines,
           ast,
-          config: {}
+          config: {},
+          // 各检测器共享同一份分析结果（符号、调用、CFG 等只计算一次）
+          analyses: AnalysisSession.for(ast, lines)
         };
         
         // 创建所有检测器
@@ -96,70 +120,80 @@ async function analyzeDir(dir: string, engine: EngineMode): Promise<Issue[]> {
         
         // 使用检测器进行检测
         try {
-          console.log(`    Starting variable detection...`);
-          const variableIssues = await variableDetector.detect(context);
-          console.log(`    Variable detection completed, found ${variableIssues.length} issues`);
+          const variableIssues = await variableDetector.run(context);
           issues.push(...variableIssues);
         } catch (e) {
-          console.log(`    Variable detection error: ${e}`);
+          log.error('Variable detection error', { file, error: String(e) });
         }
         
         try {
-          const headerIssues = await headerDetector.detect(context);
+          const headerIssues = await headerDetector.run(context);
           issues.push(...headerIssues);
         } catch (e) {
-          console.log(`    Header detection error: ${e}`);
+          log.error('Header detection error', { file, error: String(e) });
         }
         
         try {
-          const numericIssues = await numericDetector.detect(context);
+          const numericIssues = await numericDetector.run(context);
           issues.push(...numericIssues);
         } catch (e) {
-          console.log(`    Numeric detection error: ${e}`);
+          log.error('Numeric detection error', { file, error: String(e) });
         }
         
         try {
-          const controlFlowIssues = await controlFlowDetector.detect(context);
+          const controlFlowIssues = await controlFlowDetector.run(context);
           issues.push(...controlFlowIssues);
         } catch (e) {
-          console.log(`    Control flow detection error: ${e}`);
+          log.error('Control flow detection error', { file, error: String(e) });
         }
         
         try {
-          const memoryIssues = await memoryDetector.detect(context);
+          const memoryIssues = await memoryDetector.run(context);
           issues.push(...memoryIssues);
         } catch (e) {
-          console.log(`    Memory detection error: ${e}`);
+          log.error('Memory detection error', { file, error: String(e) });
         }
         
         try {
-          const formatIssues = await formatDetector.detect(context);
+          const formatIssues = await formatDetector.run(context);
           issues.push(...formatIssues);
         } catch (e) {
-          console.log(`    Format detection error: ${e}`);
+          log.error('Format detection error', { file, error: String(e) });
         }
         
         try {
+          start = traceStart();
           const astUsageIssues = await astUsageDetector.detect(context);
+          if (tracing.enabled) traceSpan('ASTUsageDetector', 'detector', start, { file: filePath });
           issues.push(...astUsageIssues);
         } catch (e) {
-          console.log(`    AST usage detection error: ${e}`);
+          log.error('AST usage detection error', { file, error: String(e) });
         }
         
       } else {
         // AST 解析失败，完全回退到启发式
-        console.log(`  Falling back to heuristic detection`);
+        if (log.debugEnabled) log.debug('Falling back to heuristic detection', { file });
+        start = traceStart();
         const fallbackIssues = analyzeWithTextFallback(filePath, content, lines);
+        if (tracing.enabled) traceSpan('heuristic', 'detector', start, { file: filePath });
         issues.push(...fallbackIssues);
       }
     } else {
       // 直接使用文本分析
+      start = traceStart();
       const fallbackIssues = analyzeWithTextFallback(filePath, content, lines);
+      if (tracing.enabled) traceSpan('heuristic', 'detector', start, { file: filePath });
       issues.push(...fallbackIssues);
     }
+    
+    start = traceStart();
+    assignFingerprints(issues, file, content);
+    if (sink) await sink(filePath, issues);
+    else allIssues.addAll(issues);
+    if (tracing.enabled) traceSpan('output', 'output', start, { file: filePath, issues: issues.length });
   }
   
-  return issues;
+  return allIssues;
 }
 
 // 模拟 VSCode 的类型和接口用于 CLI
@@ -183,7 +217,7 @@ interface Uri {
   fsPath: string;
 }
 
-function printIssues(issues: any[]) {
+function printIssues(issues: IssueStore) {
   for (const issue of issues) {
     const relativePath = path.relative(process.cwd(), issue.file);
     console.log(`${relativePath}:${issue.line}: [${issue.category}] ${issue.message}`);
@@ -191,6 +225,16 @@ function printIssues(issues: any[]) {
   }
 }
 
+// 各检测器的运行计数（--stats）
+function printDetectorStats() {
+  console.log('\n=== 检测器运行统计 ===');
+  console.log('检测器'.padEnd(22) + ['耗时(ms)', '文件', '行', 'AST节点', '正则', '问题', '堆增长(KB)'].map(h => h.padStart(12)).join(''));
+  for (const [name, c] of detectorCounters()) {
+    const cells = [c.wallTimeMs.toFixed(1), c.files, c.lines, c.astNodes, c.regexExecutions, c.issues, (c.heapGrowthBytes / 1024).toFixed(0)];
+    console.log(name.padEnd(22) + cells.map(cell => String(cell).padStart(12)).join(''));
+  }
+}
+
 function printTables() {
   console.log('\n=== 基于AST的C代码安全扫描器 ===');
   console.log('支持的检测功能:');
@@ -212,7 +256,7 @@ async function checkUninitializedVariables(ast: any, lines: string[], filePath:
   
   try {
   const parser = await CASTParser.create();
-    const declarations = parser.extractVariableDeclarations(ast, lines);
+    const declarations = AnalysisSession.for(ast, lines).get(SYMBOLS);
     
     for (const decl of declarations) {
       if (!decl.isInitialized && !decl.isParameter && !decl.isGlobal) {
@@ -245,7 +289,7 @@ async function checkWildPointers(ast: any, lines: string[], filePath: string): P
   
   try {
     const parser = await CASTParser.create();
-    const declarations = parser.extractVariableDeclarations(ast, lines);
+    const declarations = AnalysisSession.for(ast, lines).get(SYMBOLS);
     
     for (const decl of declarations) {
       if (decl.isPointer && !decl.isInitialized && !decl.isParameter) {
@@ -276,7 +320,7 @@ async function checkNullPointers(ast: any, lines: string[], filePath: string): P
   
   try {
     const parser = await CASTParser.create();
-    const declarations = parser.extractVariableDeclarations(ast, lines);
+    const declarations = AnalysisSession.for(ast, lines).get(SYMBOLS);
     
     for (const decl of declarations) {
       if (decl.isPointer && lines[decl.position.row].includes('NULL')) {
@@ -306,6 +350,7 @@ function checkDeadLoops(ast: any, lines: string[], filePath: string): Issue[] {
   const issues: Issue[] = [];
   
   try {
+    const index = BracketIndex.build(lines.join('\n'));
     for (let i = 0; i < lines.length; i++) {
       const line = lines[i];
       
@@ -315,7 +360,7 @@ function checkDeadLoops(ast: any, lines: string[], filePath: string): Issue[] {
       if (!(isForInfinite || isWhileInfinite)) continue;
 
       // 如果循环体中存在 break; 则不报告
-      const hasBreak = loopBodyHasBreak(lines, i);
+      const hasBreak = loopBodyHasBreak(index, i);
       if (hasBreak) continue;
 
       issues.push({
@@ -333,54 +378,11 @@ function checkDeadLoops(ast: any, lines: string[], filePath: string): Issue[] {
   return issues;
 }
 
-// 辅助：判断从循环起始行开始的循环体是否包含break
-function loopBodyHasBreak(lines: string[], loopStartIndex: number): boolean {
-  // 向后查找循环体：
-  // 1) 如果同一行存在开花括号，则从该处起，匹配括号到闭合
-  // 2) 否则，如果下一行起一个语句且该行或紧随行包含break;，也视为包含
-  const startLine = lines[loopStartIndex];
-  // 尝试从当前行定位第一个 '{'
-  let i = loopStartIndex;
-  let braceDepth = 0;
-  let started = false;
-
-  // 扫描最多200行作为上限，避免极端文件
-  const LIMIT = Math.min(lines.length, loopStartIndex + 200);
-
-  // 如果当前行或后续行出现 '{' 则进入块扫描模式；否则尝试一行语句模式
-  for (; i < LIMIT; i++) {
-    const line = stripLineComments(lines[i]);
-    if (!started) {
-      if (line.includes('{')) {
-        started = true;
-        braceDepth += countChar(line, '{');
-        braceDepth -= countChar(line, '}');
-        if (/(\bbreak\s*;|\breturn\b|\bexit\s*\(|\bgoto\s+\w+)/.test(line)) return true;
-        if (braceDepth === 0) break; // 单行块
-      } else if (i === loopStartIndex) {
-        // 可能是无花括号的单语句循环体，检查下一行及之后连续非空行直至分号结束
-        const nextIdx = i + 1;
-        if (nextIdx < lines.length) {
-          const nextLine = stripLineComments(lines[nextIdx]);
-          if (/(\bbreak\s*;|\breturn\b|\bexit\s*\(|\bgoto\s+\w+)/.test(nextLine)) return true;
-        }
-        return false;
-      }
-    } else {
-      // 已进入块
-      if (/(\bbreak\s*;|\breturn\b|\bexit\s*\(|\bgoto\s+\w+)/.test(line)) return true;
-      braceDepth += countChar(line, '{');
-      braceDepth -= countChar(line, '}');
-      if (braceDepth <= 0) break;
-    }
-  }
-  return false;
-}
-
-function countChar(s: string, ch: string): number {
-  let c = 0;
-  for (let i = 0; i < s.length; i++) if (s[i] === ch) c++;
-  return c;
+// 辅助：判断从循环起始行开始的循环体是否包含 break/return/exit/goto（循环体范围由括号索引给出）
+function loopBodyHasBreak(index: BracketIndex, loopStartIndex: number): boolean {
+  const body = index.loopBody(loopStartIndex);
+  if (!body) return false;
+  return ['break', 'return', 'exit', 'goto'].some(word => index.rangeContains(body, word));
 }
 
 function stripLineComments(s: string): string {
@@ -496,15 +498,15 @@ function checkFormatStrings(ast: any, lines: string[], filePath: string): Issue[
         const format = printfMatch[1];
         const args = printfMatch[2] || '';
         
-        const formatSpecifiers = format.match(/%[sdioxXeEfFgGaAcpn%]/g) || [];
+        const required = parseFormat(format, 'printf').argCount;
         const argCount = args.split(',').filter(arg => arg.trim()).length;
         
-        if (formatSpecifiers.length !== argCount) {
+        if (required !== argCount) {
           issues.push({
             file: filePath,
             line: i + 1,
             category: 'Format',
-            message: `printf格式字符串参数不匹配：需要${formatSpecifiers.length}个参数，提供了${argCount}个`,
+            message: `printf格式字符串参数不匹配：需要${required}个参数，提供了${argCount}个`,
             codeLine: line
           });
         }
@@ -679,13 +681,14 @@ function analyzeWithTextFallback(filePath: string, content: string, lines: strin
   }
   
   // 4. 死循环检测（已在AST路径实现；这里保留启发式以防未走AST路径）
+  const bracketIndex = BracketIndex.build(content);
   for (let i = 0; i < lines.length; i++) {
     const line = lines[i];
     const isForInfinite = /for\s*\(\s*;\s*;\s*\)/.test(line);
     const isWhileInfinite = /while\s*\(\s*1\s*\)/.test(line);
     if (!(isForInfinite || isWhileInfinite)) continue;
     // 若下一行或块内包含 break/return/exit/goto 则不报
-    if (loopBodyHasBreak(lines, i)) continue;
+    if (loopBodyHasBreak(bracketIndex, i)) continue;
     issues.push({ file: filePath, line: i + 1, category: 'Dead loop', message: '检测到可能的死循环', codeLine: line });
   }
   
@@ -769,14 +772,14 @@ function analyzeWithTextFallback(filePath: string, content: string, lines: strin
     if (m) {
       const format = m[1];
       const argsRaw = m[2] || '';
-      const fmtSpecs = (format.match(/%[sdioxXeEfFgGaAcpn%]/g) || []).filter(s => s !== '%%');
+      const required = parseFormat(format, 'printf').argCount;
       let argCount = 0;
       const inner = argsRaw.replace(/^[\s,]*/, '').replace(/[\s\)]*$/, '');
       if (inner.length > 0) {
         argCount = inner.split(',').filter(x => x.trim().length > 0).length;
       }
-      if (fmtSpecs.length !== argCount) {
-        issues.push({ file: filePath, line: i + 1, category: 'Format', message: `printf格式字符串参数不匹配：需要${fmtSpecs.length}个参数，提供了${argCount}个`, codeLine: line });
+      if (required !== argCount) {
+        issues.push({ file: filePath, line: i + 1, category: 'Format', message: `printf格式字符串参数不匹配：需要${required}个参数，提供了${argCount}个`, codeLine: line });
       }
     }
     if (/scanf\s*\(/.test(line)) {
@@ -804,14 +807,14 @@ interface EvalDetailed {
   mismatched: { line: number; expected: string; reported: string }[];
 }
 
-function runEvaluationDetailed(dir: string, issues: Issue[]): EvalDetailed {
-  const files = fs.readdirSync(dir).filter(f => f.endsWith('.c'));
+function runEvaluationDetailed(dir: string, issues: IssueStore): EvalDetailed {
+  const files = discoverSources(dir);
   const expected: LinedExpectation[] = [];
   const reported: LinedExpectation[] = [];
 
-  // 收集reported（按文件相对路径处理到行）
-  for (const iss of issues) {
-    reported.push({ line: iss.line, category: iss.category });
+  // 收集reported（按文件相对路径处理到行；只读行号与类别列，不还原消息）
+  for (let i = 0; i < issues.length; i++) {
+    reported.push({ line: issues.line(i), category: issues.category(i) });
   }
 
   // 解析“BUG: <Category>”
@@ -896,15 +899,11 @@ interface EvalResultSummary {
   mismatch: number;                  // 分类不一致计数（简化为按类别计数差）
 }
 
-function runEvaluation(dir: string, issues: Issue[]): EvalResultSummary {
-  const files = fs.readdirSync(dir).filter(f => f.endsWith('.c'));
+function runEvaluation(dir: string, issues: IssueStore): EvalResultSummary {
+  const files = discoverSources(dir);
   const expectedCountsTotal: Record<string, number> = {};
-  const reportedCountsTotal: Record<string, number> = {};
-
-  // 统计报告
-  for (const iss of issues) {
-    reportedCountsTotal[iss.category] = (reportedCountsTotal[iss.category] || 0) + 1;
-  }
+  // 统计报告：直接在类别列上计数
+  const reportedCountsTotal: Record<string, number> = Object.fromEntries(issues.countBy('category'));
 
   // 解析每个文件的“BUG:”注释作为标准答案
   for (const file of files) {
@@ -1117,22 +1116,74 @@ async function main() {
   const isEval = process.argv.includes('--eval');
   const engineArg = (process.argv.find(a => a.startsWith('--engine=')) || '--engine=auto').split('=')[1] as EngineMode;
   const engine: EngineMode = (engineArg === 'ast' || engineArg === 'heuristic') ? engineArg : 'auto';
+  const outputArg = process.argv.find(a => a.startsWith('--output='));
+  const output = outputArg ? path.resolve(outputArg.slice('--output='.length)) : undefined;
+  const baselineArg = process.argv.find(a => a.startsWith('--baseline='));
+  const writeBaselineArg = process.argv.find(a => a.startsWith('--write-baseline='));
+  const writeBaseline = writeBaselineArg ? path.resolve(writeBaselineArg.slice('--write-baseline='.length)) : undefined;
+  const stats = process.argv.includes('--stats');
+  if (stats) setInstrumentation(true);
+  const traceArg = process.argv.find(a => a.startsWith('--trace='));
+  const traceFile = traceArg ? path.resolve(traceArg.slice('--trace='.length)) : undefined;
+  if (traceFile) startTracing();
+  const flushTrace = () => {
+    if (traceFile) console.error(`已写出跟踪: ${traceFile} (${writeTrace(traceFile)} 个事件)`);
+  };
+  // 日志默认只输出警告与错误；--log-level=info 显示进度，可按模块设置，如 --log-level=info,parser=trace
+  // 无法识别的输出格式或日志级别以状态 2 退出
+  let format: OutputFormat;
+  try {
+    format = parseOutputFormat(process.argv.find(a => a.startsWith('--format=')));
+    configureLogging(parseLogArgs(process.argv));
+  } catch (error: any) {
+    console.error(error.message);
+    process.exit(2);
+  }
+  
+  // 结构化结果写到标准输出时，进度信息改走标准错误
+  if (format !== 'text' && !output) {
+    console.log = console.error;
+  }
   
-  console.log(`正在扫描目录: ${dir}`);
-  console.log(`引擎: ${engine}`);
+  log.info('正在扫描目录', { dir, engine });
   
   try {
-    // 使用完整的分析（根据引擎模式选择 AST 或启发式）
-    const issues = await analyzeDir(dir, engine);
-    
     if (!isEval) {
-      if (issues.length === 0) {
-        console.log('没有发现问题。');
+      // 基线比对：只输出基线中没有的问题；需要写基线时记下全部指纹
+      const baseline = baselineArg ? FingerprintBaseline.load(path.resolve(baselineArg.slice('--baseline='.length))) : undefined;
+      const fingerprints = new Set<number>();
+      const select = (found: Issue[]): Issue[] => {
+        if (writeBaseline) for (const issue of found) fingerprints.add(fingerprintValue(issue.fingerprint!));
+        return baseline ? baseline.newIssues(found) : found;
+      };
+      
+      if (format !== 'text') {
+        const writer = IssueWriter.open(format, output, !!baseline);
+        await analyzeDir(dir, engine, (file, found) => writer.writeFile(file, select(found)));
+        if (baseline) await writer.writeFixed(baseline.fixed());
+        const summary = await writer.close();
+        console.error(`已输出 ${summary.issues} 个问题 (${summary.files} 个文件, ${format})`);
       } else {
-        printIssues(issues);
+        const issues = new IssueStore();
+        await analyzeDir(dir, engine, async (file, found) => issues.addAll(select(found)));
+        if (issues.length === 0) {
+          console.log('没有发现问题。');
+        } else {
+          printIssues(issues);
+        }
+        if (baseline) {
+          console.log(`\n基线比对: 新增 ${issues.length} 个问题，已修复 ${baseline.fixed().length} 个问题`);
+        }
+        printTables();
+      }
+      
+      if (writeBaseline) {
+        const count = FingerprintBaseline.save(writeBaseline, fingerprints);
+        console.error(`已写出基线: ${writeBaseline} (${count} 个指纹)`);
       }
-      printTables();
     } else {
+      // 使用完整的分析（根据引擎模式选择 AST 或启发式）
+      const issues = await analyzeDir(dir, engine);
       // 评测模式：逐行详细比对 + 汇总
       const detail = runEvaluationDetailed(dir, issues);
       const summary = runEvaluation(dir, issues);
@@ -1149,8 +1200,11 @@ async function main() {
       console.log('过报/多报: ', JSON.stringify(summary.over, null, 2));
       console.log(`分类计数差值总和(越小越好): ${summary.mismatch}`);
     }
+    if (stats) printDetectorStats();
+    flushTrace();
   } catch (error) {
     console.error('扫描过程中发生错误:', error);
+    flushTrace();
     process.exit(1);
   }
 }
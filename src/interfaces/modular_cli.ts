@@ -8,7 +8,20 @@ import * as fs from 'fs';
 import { Issue } from './types';
 import { DetectorConfig, ConfigManager, DEFAULT_CONFIG } from '../config/detector_config';
 import { DetectorManager } from '../detectors/detector_manager';
-import { CASTParser } from '../core/ast_parser';
+import { CASTParser, ASTNode } from '../core/ast_parser';
+import { ProgramAnalysis } from '../analysis/program';
+import { SummaryDatabase } from '../analysis/summary_db';
+import { AnalysisSession } from '../analysis/session';
+import { IssueSink, IssueWriter, OutputFormat, parseOutputFormat } from '../core/issue_stream';
+import { IssueStore } from '../core/issue_store';
+import { assignFingerprints, fingerprintValue, FingerprintBaseline } from '../core/fingerprint';
+import { DetectorStats } from '../detectors/base_detector';
+import { setInstrumentation } from '../utils/instrumentation';
+import { tracing, startTracing, traceStart, traceSpan, writeTrace } from '../utils/trace';
+import { getLogger, configureLogging, parseLogArgs } from '../utils/logger';
+import { discoverSources } from '../utils/sources';
+
+const log = getLogger('cli');
 
 export class ModularCLI {
   private detectorManager: DetectorManager;
@@ -21,73 +34,148 @@ export class ModularCLI {
   }
   
   /**
-   * 分析目录中的所有C文件
+   * 分析目录中的所有C文件；给出 sink 时每个文件的问题交给 sink 后即丢弃，返回空存储。
+   * AST 模式下全部源码与 AST 在整个扫描期间常驻内存：全程序摘要与跨文件指向分析要随时访问任意文件的语法树，
+   * 这是全程序分析的代价，内存峰值随语料规模线性增长；只需单文件分析时使用启发式模式
    */
-  async analyzeDirectory(dir: string): Promise<Issue[]> {
-    const files = fs.readdirSync(dir).filter(f => f.endsWith('.c'));
-    const allIssues: Issue[] = [];
+  async analyzeDirectory(dir: string, sink?: IssueSink): Promise<IssueStore> {
+    let start = traceStart();
+    const files = discoverSources(dir);
+    if (tracing.enabled) traceSpan('discovery', 'scan', start, { dir, files: files.length });
+    const allIssues = new IssueStore();
     
-    console.log(`正在分析目录: ${dir}`);
-    console.log(`引擎模式: ${this.config.engine}`);
-    console.log(`启用的检测器: ${this.getEnabledDetectorNames().join(', ')}`);
+    if (log.infoEnabled) log.info('正在分析目录', { dir, engine: this.config.engine, detectors: this.getEnabledDetectorNames() });
     
     // 初始化AST解析器（如果需要）
     if (this.config.engine !== 'heuristic') {
       try {
+        start = traceStart();
         this.astParser = await CASTParser.create();
-        console.log('AST解析器初始化成功');
+        if (tracing.enabled) traceSpan(`init.${this.astParser.backend}`, 'parse', start);
+        log.info('AST解析器初始化成功', { backend: this.astParser.backend });
       } catch (error) {
-        console.log('AST解析器初始化失败，使用启发式模式');
+        log.warn('AST解析器初始化失败，使用启发式模式', { error: String(error) });
         this.config.engine = 'heuristic';
       }
     }
     
-    // 分析每个文件
-    for (const file of files) {
+    const readSource = (file: string) => {
       const filePath = path.join(dir, file);
+      const readStart = traceStart();
       const content = fs.readFileSync(filePath, 'utf8');
       const lines = content.split('\n');
-      
-      console.log(`正在分析文件: ${file}`);
+      if (tracing.enabled) traceSpan('read', 'io', readStart, { file: filePath, bytes: content.length, lines: lines.length });
+      return { file, filePath, content, lines };
+    };
+    
+    // 全程序阶段：先读入并解析全部文件，在跨文件调用图上自底向上计算函数摘要（源码与 AST 保留到扫描结束）；
+    // 启发式模式没有这一阶段，逐个文件读取，读完即可释放
+    const preloaded = new Map<string, ReturnType<typeof readSource>>();
+    const asts = new Map<string, ASTNode>();
+    let program: ProgramAnalysis | undefined;
+    if (this.config.engine !== 'heuristic' && this.astParser) {
+      for (const file of files) {
+        const source = readSource(file);
+        preloaded.set(file, source);
+        const ast = this.parseFile(source.filePath, source.content);
+        if (ast) asts.set(source.filePath, ast);
+      }
+      try {
+        start = traceStart();
+        const database = this.config.advanced.summaryDatabase
+          ? SummaryDatabase.open(this.config.advanced.summaryDatabase)
+          : undefined;
+        if (database && tracing.enabled) traceSpan('summary-db.open', 'cache', start, { entries: database.size });
+        start = traceStart();
+        program = new ProgramAnalysis(
+          [...preloaded.values()].filter(source => asts.has(source.filePath))
+                 .map(source => ({ file: source.filePath, root: asts.get(source.filePath)!, lines: source.lines })),
+          database
+        ).summarizeAll();
+        if (tracing.enabled) traceSpan('summarize', 'summary', start, { functions: program.callGraph.nodes.length });
+        log.info('全程序摘要完成', { functions: program.callGraph.nodes.length });
+        if (database) {
+          start = traceStart();
+          database.save();
+          if (tracing.enabled) traceSpan('summary-db.save', 'cache', start);
+          log.info('摘要数据库', { reused: program.reused, recomputed: program.recomputed });
+        }
+      } catch (error) {
+        log.warn('全程序摘要计算失败，按单文件分析', { error: String(error) });
+        program = undefined;
+      }
+    }
+    
+    // 分析每个文件
+    for (const file of files) {
+      if (log.debugEnabled) log.debug('正在分析文件', { file });
       
       try {
-        const issues = await this.analyzeFile(filePath, content, lines);
-        allIssues.push(...issues);
-        console.log(`  发现 ${issues.length} 个问题`);
+        const source = preloaded.get(file) ?? readSource(file);
+        const fileStart = traceStart();
+        const issues = await this.analyzeFile(source.filePath, source.content, source.lines, asts.get(source.filePath), program);
+        start = traceStart();
+        assignFingerprints(issues, source.file, source.content);
+        if (sink) await sink(source.filePath, issues);
+        else allIssues.addAll(issues);
+        if (tracing.enabled) {
+          traceSpan('output', 'output', start, { file: source.filePath, issues: issues.length });
+          traceSpan('analyze', 'scan', fileStart, { file: source.filePath });
+        }
+        if (log.debugEnabled) log.debug('文件分析完成', { file, issues: issues.length });
       } catch (error) {
-        console.error(`  分析文件 ${file} 时发生错误:`, error);
+        log.error('分析文件时发生错误', { file, error: String(error) });
       }
     }
     
+    // 路径敏感空指针检查的展开规模（结果已在检测时缓存，这里只汇总）
+    if (log.infoEnabled && asts.size > 0 && this.config.nullPointers) {
+      let functions = 0;
+      let states = 0;
+      let exhausted = 0;
+      for (const ast of asts.values()) {
+        const session = AnalysisSession.for(ast);
+        for (const fn of session.functions()) {
+          const paths = session.nullPaths(fn, this.config.advanced.nullPathBudget);
+          functions++;
+          states += paths.states;
+          if (!paths.complete) exhausted++;
+        }
+      }
+      log.info('空指针路径分析', { functions, states, exhausted });
+    }
+    
     return allIssues;
   }
   
   /**
-   * 分析单个文件
+   * 解析单个文件，失败时返回 undefined 以便启发式回退
    */
-  private async analyzeFile(filePath: string, content: string, lines: string[]): Promise<Issue[]> {
-    let ast: any = null;
-    let astParseSuccess = false;
-    
-    // 尝试使用AST解析
-    if (this.config.engine !== 'heuristic' && this.astParser) {
-      try {
-        ast = this.astParser.parse(content);
-        astParseSuccess = true;
-        console.log(`  AST解析成功`);
-      } catch (error: any) {
-        console.log(`  AST解析失败，使用启发式回退: ${error.message}`);
-        astParseSuccess = false;
-      }
+  private parseFile(file: string, content: string): ASTNode | undefined {
+    try {
+      const start = traceStart();
+      const ast = this.astParser!.parse(content);
+      if (tracing.enabled) traceSpan(`parse.${this.astParser!.backend}`, 'parse', start, { file });
+      if (log.debugEnabled) log.debug('AST解析成功', { file });
+      return ast;
+    } catch (error: any) {
+      log.warn('AST解析失败，使用启发式回退', { file, error: error.message });
+      return undefined;
     }
-    
+  }
+  
+  /**
+   * 分析单个文件
+   */
+  private async analyzeFile(filePath: string, content: string, lines: string[], ast?: ASTNode, program?: ProgramAnalysis): Promise<Issue[]> {
     // 创建检测上下文
     const context = {
       filePath,
       content,
       lines,
-      ast: astParseSuccess ? ast : undefined,
-      config: this.config
+      ast,
+      config: this.config,
+      program: ast ? program : undefined
     };
     
     // 执行检测
@@ -119,7 +207,7 @@ export class ModularCLI {
   /**
    * 获取检测器统计信息
    */
-  getDetectorStats(): Array<{ name: string; enabled: boolean; config: any }> {
+  getDetectorStats(): DetectorStats[] {
     return this.detectorManager.getDetectorStats();
   }
   
@@ -133,7 +221,7 @@ export class ModularCLI {
   /**
    * 打印问题报告
    */
-  printIssues(issues: Issue[]): void {
+  printIssues(issues: IssueStore): void {
     if (issues.length === 0) {
       console.log('没有发现问题。');
       return;
@@ -147,6 +235,25 @@ export class ModularCLI {
       console.log(`${relativePath}:${issue.line}: [${issue.category}] ${issue.message}`);
       console.log(`    ${issue.codeLine}`);
     }
+    
+    console.log('\n按类别统计:');
+    for (const [category, count] of issues.countBy('category')) {
+      console.log(`  ${category}: ${count}`);
+    }
+  }
+  
+  /**
+   * 打印各检测器的运行计数（需以 --stats 开启）
+   */
+  printDetectorStats(): void {
+    console.log('\n=== 检测器运行统计 ===');
+    console.log('检测器'.padEnd(22) + ['耗时(ms)', '文件', '行', 'AST节点', '正则', '问题', '堆增长(KB)'].map(h => h.padStart(12)).join(''));
+    for (const stat of this.getDetectorStats()) {
+      const c = stat.counters;
+      if (!c) continue;
+      const cells = [c.wallTimeMs.toFixed(1), c.files, c.lines, c.astNodes, c.regexExecutions, c.issues, (c.heapGrowthBytes / 1024).toFixed(0)];
+      console.log(stat.name.padEnd(22) + cells.map(cell => String(cell).padStart(12)).join(''));
+    }
   }
   
   /**
@@ -170,15 +277,9 @@ export class ModularCLI {
   /**
    * 运行评测模式
    */
-  async runEvaluation(dir: string, issues: Issue[]): Promise<void> {
-    const files = fs.readdirSync(dir).filter(f => f.endsWith('.c'));
+  async runEvaluation(dir: string, issues: IssueStore): Promise<void> {
+    const files = discoverSources(dir);
     const expected: Array<{ line: number; category: string }> = [];
-    const reported: Array<{ line: number; category: string }> = [];
-    
-    // 收集报告的问题
-    for (const issue of issues) {
-      reported.push({ line: issue.line, category: issue.category });
-    }
     
     // 解析标准答案
     for (const file of files) {
@@ -201,16 +302,12 @@ export class ModularCLI {
     
     // 计算统计信息
     const expectedCounts: Record<string, number> = {};
-    const reportedCounts: Record<string, number> = {};
+    const reportedCounts: Record<string, number> = Object.fromEntries(issues.countBy('category'));
     
     for (const exp of expected) {
       expectedCounts[exp.category] = (expectedCounts[exp.category] || 0) + 1;
     }
     
-    for (const rep of reported) {
-      reportedCounts[rep.category] = (reportedCounts[rep.category] || 0) + 1;
-    }
-    
     // 计算差异
     const allCategories = new Set([...Object.keys(expectedCounts), ...Object.keys(reportedCounts)]);
     const missing: Record<string, number> = {};
@@ -273,21 +370,84 @@ async function main() {
   const engineArg = args.find(a => a.startsWith('--engine=')) || '--engine=auto';
   const engine = engineArg.split('=')[1] as 'auto' | 'ast' | 'heuristic';
   
+  const summaryDbArg = args.find(a => a.startsWith('--summary-db='));
+  const summaryDatabase = summaryDbArg ? path.resolve(summaryDbArg.slice('--summary-db='.length)) : '';
+  const budgetArg = args.find(a => a.startsWith('--null-path-budget='));
+  const nullPathBudget = budgetArg ? Number(budgetArg.slice('--null-path-budget='.length)) || DEFAULT_CONFIG.advanced.nullPathBudget : DEFAULT_CONFIG.advanced.nullPathBudget;
+  const outputArg = args.find(a => a.startsWith('--output='));
+  const output = outputArg ? path.resolve(outputArg.slice('--output='.length)) : undefined;
+  const baselineArg = args.find(a => a.startsWith('--baseline='));
+  const writeBaselineArg = args.find(a => a.startsWith('--write-baseline='));
+  const writeBaseline = writeBaselineArg ? path.resolve(writeBaselineArg.slice('--write-baseline='.length)) : undefined;
+  const stats = args.includes('--stats');
+  if (stats) setInstrumentation(true);
+  const traceArg = args.find(a => a.startsWith('--trace='));
+  const traceFile = traceArg ? path.resolve(traceArg.slice('--trace='.length)) : undefined;
+  if (traceFile) startTracing();
+  const flushTrace = () => {
+    if (traceFile) console.error(`已写出跟踪: ${traceFile} (${writeTrace(traceFile)} 个事件)`);
+  };
+  // 日志默认只输出警告与错误；--log-level=info 显示进度，可按模块设置，如 --log-level=info,parser=trace
+  // 无法识别的输出格式或日志级别以状态 2 退出
+  let format: OutputFormat;
+  try {
+    format = parseOutputFormat(args.find(a => a.startsWith('--format=')));
+    configureLogging(parseLogArgs(args));
+  } catch (error: any) {
+    console.error(error.message);
+    process.exit(2);
+  }
+  
+  // 结构化结果写到标准输出时，进度信息改走标准错误，避免混入结果
+  if (format !== 'text' && !output) {
+    console.log = console.error;
+  }
+  
   // 创建CLI实例
-  const cli = new ModularCLI({ engine });
+  const cli = new ModularCLI({ engine, advanced: { ...DEFAULT_CONFIG.advanced, summaryDatabase, nullPathBudget } });
   
   try {
-    // 分析文件
-    const issues = await cli.analyzeDirectory(dir);
+    if (isEval) {
+      await cli.runEvaluation(dir, await cli.analyzeDirectory(dir));
+      if (stats) cli.printDetectorStats();
+      flushTrace();
+      return;
+    }
     
-    if (!isEval) {
+    // 基线比对：只输出基线中没有的问题；需要写基线时记下全部指纹
+    const baseline = baselineArg ? FingerprintBaseline.load(path.resolve(baselineArg.slice('--baseline='.length))) : undefined;
+    const fingerprints = new Set<number>();
+    const select = (issues: Issue[]): Issue[] => {
+      if (writeBaseline) for (const issue of issues) fingerprints.add(fingerprintValue(issue.fingerprint!));
+      return baseline ? baseline.newIssues(issues) : issues;
+    };
+    
+    if (format !== 'text') {
+      // 流式输出：逐文件写出，不累积问题
+      const writer = IssueWriter.open(format, output, !!baseline);
+      await cli.analyzeDirectory(dir, (file, issues) => writer.writeFile(file, select(issues)));
+      if (baseline) await writer.writeFixed(baseline.fixed());
+      const summary = await writer.close();
+      console.error(`已输出 ${summary.issues} 个问题 (${summary.files} 个文件, ${format})`);
+    } else {
+      const issues = new IssueStore();
+      await cli.analyzeDirectory(dir, async (file, found) => issues.addAll(select(found)));
       cli.printIssues(issues);
+      if (baseline) {
+        console.log(`\n基线比对: 新增 ${issues.length} 个问题，已修复 ${baseline.fixed().length} 个问题`);
+      }
       cli.printDetectorInfo();
-    } else {
-      await cli.runEvaluation(dir, issues);
     }
+    
+    if (writeBaseline) {
+      const count = FingerprintBaseline.save(writeBaseline, fingerprints);
+      console.error(`已写出基线: ${writeBaseline} (${count} 个指纹)`);
+    }
+    if (stats) cli.printDetectorStats();
+    flushTrace();
   } catch (error) {
     console.error('扫描过程中发生错误:', error);
+    flushTrace();
     process.exit(1);
   }
 }
@@ -6,6 +6,7 @@ export type Issue = {
   category: string;
   message: string;
   codeLine: string;
+  fingerprint?: string;  // 稳定指纹（与行号无关），见 core/fingerprint.ts
 };
 
 export type VariableInfo = {
@@ -17,8 +18,6 @@ export type VariableInfo = {
   pointerMaybeNull?: boolean;
 };
 
-export type SegmentedTable = Array<Map<string, VariableInfo>>;
-
 export interface MemoryAllocation {
   line: number;
   variable: string;
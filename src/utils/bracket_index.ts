@@ -0,0 +1,324 @@
+// 括号配对索引：单遍扫描源码（跳过注释、字符串与字符字面量），
+// 记录 () [] {} 的配对位置、每行首个循环关键字及其循环体范围，供控制流检测按行号 O(1) 查询
+
+export interface BodyRange {
+  start: number;   // 循环体起始偏移（'{' 或单语句首字符）
+  end: number;     // 循环体结束偏移（'}' 或 ';'，包含）
+}
+
+// 可在循环体内被查询的关键字
+const INDEXED_WORDS = new Set(['break', 'continue', 'return', 'goto', 'exit']);
+const LOOP_KEYWORDS = new Set(['for', 'while', 'do']);
+const HEADER_KEYWORDS = new Set(['for', 'while', 'if', 'switch']);
+
+export class BracketIndex {
+  private readonly content: string;
+  private readonly lineStarts: number[] = [0];
+  private readonly code: Uint8Array;          // 1 表示该偏移为有效代码字符
+  private readonly partner: Int32Array;       // 括号偏移 -> 配对括号偏移，其余为 -1
+  private readonly words = new Map<string, number[]>();
+  private bodyStart!: Int32Array;
+  private bodyEnd!: Int32Array;
+
+  private constructor(content: string) {
+    this.content = content;
+    this.code = new Uint8Array(content.length);
+    this.partner = new Int32Array(content.length).fill(-1);
+  }
+
+  /**
+   * 对整个文件构建索引
+   */
+  static build(content: string): BracketIndex {
+    const index = new BracketIndex(content);
+    const loopKeywordAt = index.scan();
+    index.computeLoopBodies(loopKeywordAt);
+    return index;
+  }
+
+  /**
+   * 行号（0 起始）处首个循环语句的循环体范围；该行没有循环时返回 null
+   */
+  loopBody(line: number): BodyRange | null {
+    if (line < 0 || line >= this.bodyStart.length || this.bodyStart[line] < 0) return null;
+    return { start: this.bodyStart[line], end: this.bodyEnd[line] };
+  }
+
+  /**
+   * 范围 [start, end] 内是否出现指定关键字（仅限 break/continue/return/goto/exit）
+   */
+  rangeContains(range: BodyRange, word: string): boolean {
+    const offsets = this.words.get(word);
+    if (!offsets || offsets.length === 0) return false;
+    const i = lowerBound(offsets, range.start);
+    return i < offsets.length && offsets[i] <= range.end;
+  }
+
+  /**
+   * 偏移所在的行号（0 起始）
+   */
+  lineOf(offset: number): number {
+    return upperBound(this.lineStarts, offset) - 1;
+  }
+
+  /**
+   * 每行（0 起始）所在的顶层函数名，不在函数体内的行为空串；
+   * 函数体即前面紧跟 name(...) 的顶层 '{'
+   */
+  enclosingFunctions(): string[] {
+    const s = this.content;
+    const names: string[] = new Array(this.lineStarts.length).fill('');
+    for (let i = 0; i < s.length; i++) {
+      if (!this.code[i] || s[i] !== '{' || this.partner[i] < 0) continue;
+      const end = this.partner[i];
+      const close = this.prevCode(i - 1);
+      const open = close >= 0 && s[close] === ')' ? this.partner[close] : -1;
+      const nameEnd = open > 0 ? this.prevCode(open - 1) : -1;
+      if (nameEnd >= 0 && isIdentPart(s[nameEnd])) {
+        let nameStart = nameEnd;
+        while (nameStart > 0 && isIdentPart(s[nameStart - 1])) nameStart--;
+        const name = s.slice(nameStart, nameEnd + 1);
+        if (!HEADER_KEYWORDS.has(name)) {
+          for (let line = this.lineOf(i), last = this.lineOf(end); line <= last; line++) names[line] = name;
+        }
+      }
+      // 顶层的其他花括号（结构体、初始化列表）整体跳过
+      i = end;
+    }
+    return names;
+  }
+
+  private scan(): Int32Array {
+    const s = this.content;
+    const len = s.length;
+    const stack: number[] = [];
+    const loopKeywordAt: number[] = [-1];
+
+    let i = 0;
+    while (i < len) {
+      const ch = s[i];
+
+      if (ch === '\n') {
+        this.lineStarts.push(i + 1);
+        loopKeywordAt.push(-1);
+        i++;
+        continue;
+      }
+
+      if (ch === '/' && s[i + 1] === '/') {
+        while (i < len && s[i] !== '\n') i++;
+        continue;
+      }
+      if (ch === '/' && s[i + 1] === '*') {
+        i += 2;
+        while (i < len && !(s[i] === '*' && s[i + 1] === '/')) {
+          if (s[i] === '\n') {
+            this.lineStarts.push(i + 1);
+            loopKeywordAt.push(-1);
+          }
+          i++;
+        }
+        i += 2;
+        continue;
+      }
+
+      if (ch === '"' || ch === '\'') {
+        i++;
+        while (i < len && s[i] !== ch && s[i] !== '\n') {
+          if (s[i] === '\\') i++;
+          i++;
+        }
+        i++;
+        continue;
+      }
+
+      this.code[i] = 1;
+
+      if (isIdentStart(ch)) {
+        const start = i;
+        while (i < len && isIdentPart(s[i])) this.code[i++] = 1;
+        const word = s.slice(start, i);
+        if (INDEXED_WORDS.has(word)) {
+          let list = this.words.get(word);
+          if (!list) {
+            list = [];
+            this.words.set(word, list);
+          }
+          list.push(start);
+        }
+        const line = this.lineStarts.length - 1;
+        if (LOOP_KEYWORDS.has(word) && loopKeywordAt[line] < 0) {
+          loopKeywordAt[line] = start;
+        }
+        continue;
+      }
+
+      if (isDigit(ch)) {
+        while (i < len && isIdentPart(s[i])) this.code[i++] = 1;
+        continue;
+      }
+
+      if (ch === '(' || ch === '[' || ch === '{') {
+        stack.push(i);
+      } else if (ch === ')' || ch === ']' || ch === '}') {
+        // 容忍不配对的括号（预处理分支等）：向下寻找同类开括号
+        const open = ch === ')' ? '(' : ch === ']' ? '[' : '{';
+        let k = stack.length - 1;
+        while (k >= 0 && s[stack[k]] !== open) k--;
+        if (k >= 0) {
+          const o = stack[k];
+          stack.length = k;
+          this.partner[o] = i;
+          this.partner[i] = o;
+        }
+      }
+      i++;
+    }
+
+    return Int32Array.from(loopKeywordAt);
+  }
+
+  private computeLoopBodies(loopKeywordAt: Int32Array): void {
+    const lineCount = loopKeywordAt.length;
+    this.bodyStart = new Int32Array(lineCount).fill(-1);
+    this.bodyEnd = new Int32Array(lineCount).fill(-1);
+
+    for (let line = 0; line < lineCount; line++) {
+      const kw = loopKeywordAt[line];
+      if (kw < 0) continue;
+      const range = this.loopBodyAt(kw);
+      if (range) {
+        this.bodyStart[line] = range.start;
+        this.bodyEnd[line] = range.end;
+      }
+    }
+  }
+
+  private loopBodyAt(kw: number): BodyRange | null {
+    const s = this.content;
+    if (s.startsWith('do', kw) && !isIdentPart(s[kw + 2] || '')) {
+      return this.statementRange(kw + 2);
+    }
+
+    const isWhile = s.startsWith('while', kw);
+    // do { ... } while (...); 的尾部：循环体即前面的 do 块
+    if (isWhile) {
+      const prev = this.prevCode(kw - 1);
+      if (prev >= 0 && s[prev] === '}') {
+        const open = this.partner[prev];
+        const beforeOpen = open >= 0 ? this.prevCode(open - 1) : -1;
+        if (beforeOpen >= 1 && s.startsWith('do', beforeOpen - 1) && !isIdentPart(s[beforeOpen - 2] || '')) {
+          return { start: open, end: prev };
+        }
+      }
+    }
+
+    const paren = this.nextCode(kw + (isWhile ? 5 : 3));
+    if (paren < 0 || s[paren] !== '(' || this.partner[paren] < 0) return null;
+    return this.statementRange(this.partner[paren] + 1);
+  }
+
+  /**
+   * 从 from 开始的下一条语句的范围：复合语句、控制语句（递归）或以 ';' 结尾的简单语句
+   */
+  private statementRange(from: number): BodyRange | null {
+    const s = this.content;
+    const start = this.nextCode(from);
+    if (start < 0) return null;
+
+    if (s[start] === '{') {
+      const end = this.partner[start];
+      return end >= 0 ? { start, end } : null;
+    }
+
+    const word = this.wordAt(start);
+    if (HEADER_KEYWORDS.has(word)) {
+      const paren = this.nextCode(start + word.length);
+      if (paren >= 0 && s[paren] === '(' && this.partner[paren] >= 0) {
+        const inner = this.statementRange(this.partner[paren] + 1);
+        return inner ? { start, end: inner.end } : null;
+      }
+    } else if (word === 'do') {
+      const inner = this.statementRange(start + 2);
+      if (!inner) return null;
+      const tail = this.findSemicolon(inner.end + 1);
+      return tail >= 0 ? { start, end: tail } : null;
+    }
+
+    const end = this.findSemicolon(start);
+    return end >= 0 ? { start, end } : null;
+  }
+
+  private findSemicolon(from: number): number {
+    const s = this.content;
+    for (let i = from; i < s.length; i++) {
+      if (!this.code[i]) continue;
+      const ch = s[i];
+      if (ch === ';') return i;
+      if ((ch === '(' || ch === '[' || ch === '{') && this.partner[i] >= 0) {
+        i = this.partner[i];
+      } else if (ch === '}') {
+        return -1;
+      }
+    }
+    return -1;
+  }
+
+  private nextCode(from: number): number {
+    const s = this.content;
+    for (let i = from; i < s.length; i++) {
+      if (this.code[i] && !isSpace(s[i])) return i;
+    }
+    return -1;
+  }
+
+  private prevCode(from: number): number {
+    const s = this.content;
+    for (let i = from; i >= 0; i--) {
+      if (this.code[i] && !isSpace(s[i])) return i;
+    }
+    return -1;
+  }
+
+  private wordAt(offset: number): string {
+    const s = this.content;
+    if (!isIdentStart(s[offset])) return '';
+    let end = offset;
+    while (end < s.length && isIdentPart(s[end])) end++;
+    return s.slice(offset, end);
+  }
+}
+
+function isSpace(ch: string): boolean {
+  return ch === ' ' || ch === '\t' || ch === '\r' || ch === '\n' || ch === '\f' || ch === '\v';
+}
+
+function isDigit(ch: string): boolean {
+  return ch >= '0' && ch <= '9';
+}
+
+function isIdentStart(ch: string): boolean {
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch === '_';
+}
+
+function isIdentPart(ch: string): boolean {
+  return isIdentStart(ch) || isDigit(ch);
+}
+
+function lowerBound(arr: number[], value: number): number {
+  let lo = 0, hi = arr.length;
+  while (lo < hi) {
+    const mid = (lo + hi) >>> 1;
+    if (arr[mid] < value) lo = mid + 1; else hi = mid;
+  }
+  return lo;
+}
+
+function upperBound(arr: number[], value: number): number {
+  let lo = 0, hi = arr.length;
+  while (lo < hi) {
+    const mid = (lo + hi) >>> 1;
+    if (arr[mid] <= value) lo = mid + 1; else hi = mid;
+  }
+  return lo;
+}
@@ -0,0 +1,394 @@
+// C 算术类型表：按目标数据模型给出各整数类型的精确（BigInt）取值范围，
+// 并提供声明识别与常量初始化表达式折叠，供数值范围检测共用
+
+export type DataModel = 'LP64' | 'ILP32' | 'LLP64';
+
+/**
+ * 数据模型下各基本整数类型的位宽
+ */
+export interface DataModelProfile {
+  char: number;
+  short: number;
+  int: number;
+  long: number;
+  longLong: number;
+  pointer: number;
+}
+
+export const DATA_MODELS: Record<DataModel, DataModelProfile> = {
+  LP64:  { char: 8, short: 16, int: 32, long: 64, longLong: 64, pointer: 64 },  // Linux/macOS 64 位
+  ILP32: { char: 8, short: 16, int: 32, long: 32, longLong: 64, pointer: 32 },  // 32 位平台
+  LLP64: { char: 8, short: 16, int: 32, long: 32, longLong: 64, pointer: 64 }   // Windows 64 位
+};
+
+export const DEFAULT_DATA_MODEL: DataModel = 'LP64';
+
+export interface IntegerRange {
+  min: bigint;
+  max: bigint;
+}
+
+export interface FloatRange {
+  min: number;
+  max: number;
+}
+
+type WidthOf = (profile: DataModelProfile) => number;
+
+interface IntegerTypeEntry {
+  signed: boolean;
+  bits: WidthOf;
+}
+
+// 规范类型名 -> 符号性与位宽（位宽随数据模型变化）
+const INTEGER_TYPES: Record<string, IntegerTypeEntry> = {
+  'char':               { signed: true,  bits: p => p.char },
+  'signed char':        { signed: true,  bits: p => p.char },
+  'unsigned char':      { signed: false, bits: p => p.char },
+  'short':              { signed: true,  bits: p => p.short },
+  'unsigned short':     { signed: false, bits: p => p.short },
+  'int':                { signed: true,  bits: p => p.int },
+  'unsigned int':       { signed: false, bits: p => p.int },
+  'long':               { signed: true,  bits: p => p.long },
+  'unsigned long':      { signed: false, bits: p => p.long },
+  'long long':          { signed: true,  bits: p => p.longLong },
+  'unsigned long long': { signed: false, bits: p => p.longLong },
+  'int8_t':    { signed: true,  bits: () => 8 },
+  'uint8_t':   { signed: false, bits: () => 8 },
+  'int16_t':   { signed: true,  bits: () => 16 },
+  'uint16_t':  { signed: false, bits: () => 16 },
+  'int32_t':   { signed: true,  bits: () => 32 },
+  'uint32_t':  { signed: false, bits: () => 32 },
+  'int64_t':   { signed: true,  bits: () => 64 },
+  'uint64_t':  { signed: false, bits: () => 64 },
+  'size_t':    { signed: false, bits: p => p.pointer },
+  'ssize_t':   { signed: true,  bits: p => p.pointer },
+  'ptrdiff_t': { signed: true,  bits: p => p.pointer },
+  'intptr_t':  { signed: true,  bits: p => p.pointer },
+  'uintptr_t': { signed: false, bits: p => p.pointer }
+};
+
+const FLOAT_TYPES: Record<string, FloatRange> = {
+  'float':  { min: -3.4028235e38, max: 3.4028235e38 },
+  'double': { min: -1.7976931348623157e308, max: 1.7976931348623157e308 }
+};
+
+// 声明说明符中可忽略的存储类与限定符
+const QUALIFIERS = new Set(['const', 'volatile', 'static', 'register', 'extern', 'auto', 'inline', 'restrict']);
+const BASE_WORDS = new Set(['signed', 'unsigned', 'short', 'long', 'char', 'int', 'float', 'double']);
+
+// 每个数据模型的范围表只计算一次
+const rangeCache = new Map<DataModel, Map<string, IntegerRange>>();
+
+/**
+ * 某整数类型在指定数据模型下的范围；非整数类型返回 null
+ */
+export function integerRange(typeName: string, model: DataModel = DEFAULT_DATA_MODEL): IntegerRange | null {
+  let table = rangeCache.get(model);
+  if (!table) {
+    table = new Map();
+    const profile = DATA_MODELS[model];
+    for (const [name, entry] of Object.entries(INTEGER_TYPES)) {
+      const bits = BigInt(entry.bits(profile));
+      table.set(name, entry.signed
+        ? { min: -(1n << (bits - 1n)), max: (1n << (bits - 1n)) - 1n }
+        : { min: 0n, max: (1n << bits) - 1n });
+    }
+    rangeCache.set(model, table);
+  }
+  return table.get(normalizeTypeName(typeName)) || null;
+}
+
+export function floatRange(typeName: string): FloatRange | null {
+  return FLOAT_TYPES[normalizeTypeName(typeName)] || null;
+}
+
+/**
+ * 将声明说明符规范化为类型表中的名字，如 "const unsigned long int" -> "unsigned long"
+ */
+export function normalizeTypeName(typeName: string): string {
+  const words = typeName.trim().split(/\s+/).filter(w => w && !QUALIFIERS.has(w));
+  if (words.length === 1 && (INTEGER_TYPES[words[0]] || FLOAT_TYPES[words[0]])) {
+    return words[0];
+  }
+
+  let unsigned = false, signed = false, longs = 0, short = false, base = '';
+  for (const w of words) {
+    if (w === 'unsigned') unsigned = true;
+    else if (w === 'signed') signed = true;
+    else if (w === 'long') longs++;
+    else if (w === 'short') short = true;
+    else if (w === 'char' || w === 'int' || w === 'float' || w === 'double') base = w;
+    else return words.join(' ');
+  }
+
+  if (base === 'float' || base === 'double') return base;
+  if (base === 'char') return unsigned ? 'unsigned char' : signed ? 'signed char' : 'char';
+  const size = short ? 'short' : longs >= 2 ? 'long long' : longs === 1 ? 'long' : 'int';
+  return unsigned ? `unsigned ${size}` : size;
+}
+
+/**
+ * 源码中的一个带初始化器的声明项
+ */
+export interface DeclaratorInit {
+  typeName: string;      // 规范化类型名
+  name: string;
+  initializer: string;   // 初始化表达式原文
+}
+
+const TYPEDEF_WORDS = Object.keys(INTEGER_TYPES).filter(n => !n.includes(' ') && !BASE_WORDS.has(n));
+const SPECIFIER_RE = new RegExp(
+  `^\\s*((?:(?:${[...QUALIFIERS, ...BASE_WORDS, ...TYPEDEF_WORDS].join('|')})\\b\\s*)+)`
+);
+
+/**
+ * 识别一行开头的算术类型声明，返回其中所有 "名字 = 初始化器" 声明项（指针与数组声明项跳过）
+ */
+export function parseDeclaration(line: string): DeclaratorInit[] {
+  const m = SPECIFIER_RE.exec(line);
+  if (!m) return [];
+  const typeName = normalizeTypeName(m[1]);
+  if (!INTEGER_TYPES[typeName] && !FLOAT_TYPES[typeName]) return [];
+
+  const result: DeclaratorInit[] = [];
+  const rest = line.slice(m[0].length);
+  for (const part of splitTopLevel(rest)) {
+    const d = /^\s*(\w+)\s*=\s*([\s\S]+?)\s*$/.exec(part);
+    if (d) result.push({ typeName, name: d[1], initializer: d[2] });
+  }
+  return result;
+}
+
+// 按顶层逗号切分声明项，遇到顶层 ';' 结束
+function splitTopLevel(s: string): string[] {
+  const parts: string[] = [];
+  let depth = 0, start = 0;
+  for (let i = 0; i < s.length; i++) {
+    const ch = s[i];
+    if (ch === '(' || ch === '[' || ch === '{') depth++;
+    else if (ch === ')' || ch === ']' || ch === '}') depth--;
+    else if (depth === 0 && (ch === ',' || ch === ';')) {
+      parts.push(s.slice(start, i));
+      start = i + 1;
+      if (ch === ';') return parts;
+    }
+  }
+  parts.push(s.slice(start));
+  return parts;
+}
+
+/**
+ * 常量折叠结果：整数以 BigInt 精确表示并带上其 C 类型（符号性与位宽），浮点数以 number 表示。
+ * 无符号整数按模 2^位宽 取值（~0u 为 4294967295），有符号整数保持数学值，溢出由调用方判断
+ */
+export type ConstantValue =
+  | { kind: 'int'; value: bigint; signed: boolean; bits: number }
+  | { kind: 'float'; value: number };
+
+type IntConstant = Extract<ConstantValue, { kind: 'int' }>;
+
+interface IntegerType {
+  signed: boolean;
+  bits: number;
+}
+
+const foldCache = new Map<string, ConstantValue | null>();
+const FOLD_CACHE_LIMIT = 4096;
+
+/**
+ * 折叠由字面量、括号与一元/二元算术位运算组成的常量表达式；含标识符等非常量成分时返回 null
+ */
+export function foldConstant(expr: string, model: DataModel = DEFAULT_DATA_MODEL): ConstantValue | null {
+  const trimmed = expr.trim();
+  const key = `${model}:${trimmed}`;
+  const cached = foldCache.get(key);
+  if (cached !== undefined) return cached;
+
+  let value: ConstantValue | null = null;
+  const tokens = tokenizeExpr(trimmed);
+  if (tokens) {
+    const parser = new ConstExprParser(tokens, DATA_MODELS[model]);
+    value = parser.parse();
+  }
+  if (foldCache.size >= FOLD_CACHE_LIMIT) foldCache.clear();
+  foldCache.set(key, value);
+  return value;
+}
+
+function intConstant(value: bigint, type: IntegerType): IntConstant {
+  return { kind: 'int', value: type.signed ? value : BigInt.asUintN(type.bits, value), signed: type.signed, bits: type.bits };
+}
+
+// 整数提升：窄于 int 的类型提升为 int
+function promote(type: IntegerType, profile: DataModelProfile): IntegerType {
+  return type.bits < profile.int ? { signed: true, bits: profile.int } : type;
+}
+
+// 寻常算术转换（以位宽近似等级）：位宽不同取较宽者，同宽时有一方无符号则为无符号
+function commonType(a: IntegerType, b: IntegerType, profile: DataModelProfile): IntegerType {
+  const x = promote(a, profile);
+  const y = promote(b, profile);
+  if (x.bits !== y.bits) return x.bits > y.bits ? x : y;
+  return { signed: x.signed && y.signed, bits: x.bits };
+}
+
+function tokenizeExpr(s: string): string[] | null {
+  const re = /\s*(0[xX][0-9a-fA-F]+[uUlL]*|0[bB][01]+[uUlL]*|(?:\d+\.?\d*|\.\d+)(?:[eE][+-]?\d+)?[uUlLfF]*|'(?:\\.|[^'\\])+'|<<|>>|[-+*\/%&|^~()!])/y;
+  const tokens: string[] = [];
+  let pos = 0;
+  while (pos < s.length) {
+    re.lastIndex = pos;
+    const m = re.exec(s);
+    if (!m) return s.slice(pos).trim() === '' ? tokens : null;
+    tokens.push(m[1]);
+    pos = re.lastIndex;
+  }
+  return tokens;
+}
+
+const BINARY_PRECEDENCE: Record<string, number> = {
+  '|': 1, '^': 2, '&': 3, '<<': 4, '>>': 4, '+': 5, '-': 5, '*': 6, '/': 6, '%': 6
+};
+
+class ConstExprParser {
+  private pos = 0;
+
+  constructor(private tokens: string[], private profile: DataModelProfile) {}
+
+  parse(): ConstantValue | null {
+    const v = this.binary(1);
+    return v && this.pos === this.tokens.length ? v : null;
+  }
+
+  private binary(minPrec: number): ConstantValue | null {
+    let left = this.unary();
+    while (left) {
+      const op = this.tokens[this.pos];
+      const prec = BINARY_PRECEDENCE[op];
+      if (prec === undefined || prec < minPrec) break;
+      this.pos++;
+      const right = this.binary(prec + 1);
+      if (!right) return null;
+      left = applyBinary(op, left, right, this.profile);
+    }
+    return left;
+  }
+
+  private unary(): ConstantValue | null {
+    const tok = this.tokens[this.pos++];
+    if (tok === undefined) return null;
+    if (tok === '-' || tok === '+' || tok === '~' || tok === '!') {
+      const v = this.unary();
+      if (!v) return null;
+      if (v.kind !== 'int') {
+        if (tok === '+') return v;
+        return tok === '-' ? { kind: 'float', value: -v.value } : null;
+      }
+      // 一元 + - ~ 作用于提升后的类型，无符号结果按位宽回绕
+      const type = promote(v, this.profile);
+      if (tok === '+') return intConstant(v.value, type);
+      if (tok === '-') return intConstant(-v.value, type);
+      if (tok === '~') return intConstant(~v.value, type);
+      return intConstant(v.value === 0n ? 1n : 0n, { signed: true, bits: this.profile.int });
+    }
+    if (tok === '(') {
+      const v = this.binary(1);
+      if (this.tokens[this.pos++] !== ')') return null;
+      return v;
+    }
+    return parseLiteralWith(tok, this.profile);
+  }
+}
+
+function applyBinary(op: string, a: ConstantValue, b: ConstantValue, profile: DataModelProfile): ConstantValue | null {
+  if (a.kind === 'int' && b.kind === 'int') {
+    // 移位的结果类型是提升后的左操作数类型，其余运算先做寻常算术转换
+    if (op === '<<' || op === '>>') {
+      const y = b.value;
+      // 移位量超出任何 C 整数位宽时不折叠
+      if (y < 0n || y > 128n) return null;
+      const type = promote(a, profile);
+      return intConstant(op === '<<' ? a.value << y : a.value >> y, type);
+    }
+    const type = commonType(a, b, profile);
+    const x = intConstant(a.value, type).value, y = intConstant(b.value, type).value;
+    switch (op) {
+      case '+': return intConstant(x + y, type);
+      case '-': return intConstant(x - y, type);
+      case '*': return intConstant(x * y, type);
+      case '/': return y === 0n ? null : intConstant(x / y, type);
+      case '%': return y === 0n ? null : intConstant(x % y, type);
+      case '&': return intConstant(x & y, type);
+      case '|': return intConstant(x | y, type);
+      case '^': return intConstant(x ^ y, type);
+    }
+    return null;
+  }
+  const x = Number(a.value), y = Number(b.value);
+  switch (op) {
+    case '+': return { kind: 'float', value: x + y };
+    case '-': return { kind: 'float', value: x - y };
+    case '*': return { kind: 'float', value: x * y };
+    case '/': return y === 0 ? null : { kind: 'float', value: x / y };
+  }
+  return null;
+}
+
+/**
+ * 解析单个 C 数值或字符字面量（十进制/十六进制/八进制/二进制）；整数按 u/l 后缀与数值大小确定其 C 类型
+ */
+export function parseLiteral(tok: string, model: DataModel = DEFAULT_DATA_MODEL): ConstantValue | null {
+  return parseLiteralWith(tok, DATA_MODELS[model]);
+}
+
+function parseLiteralWith(tok: string, profile: DataModelProfile): ConstantValue | null {
+  if (tok.startsWith('\'')) {
+    // 字符常量的类型是 int
+    const int = { signed: true, bits: profile.int };
+    const body = tok.slice(1, -1);
+    if (body.length === 1) return intConstant(BigInt(body.charCodeAt(0)), int);
+    const escapes: Record<string, number> = { n: 10, t: 9, r: 13, '0': 0, '\\': 92, '\'': 39, '"': 34, a: 7, b: 8, f: 12, v: 11 };
+    if (body.length === 2 && body[0] === '\\' && escapes[body[1]] !== undefined) {
+      return intConstant(BigInt(escapes[body[1]]), int);
+    }
+    return null;
+  }
+
+  const m = /^(0[xX][0-9a-fA-F]+|0[bB][01]+|\d+)([uUlL]*)$/.exec(tok);
+  if (m) {
+    const [, digits, suffix] = m;
+    let value: bigint;
+    if (/^0[xXbB]/.test(digits)) value = BigInt(digits);
+    else if (digits.length > 1 && digits.startsWith('0')) {
+      if (!/^[0-7]+$/.test(digits)) return null;
+      value = BigInt('0o' + digits.slice(1));
+    } else value = BigInt(digits);
+    return intConstant(value, literalType(value, suffix, !/^0./.test(digits), profile));
+  }
+  if (/^(?:\d+\.?\d*|\.\d+)(?:[eE][+-]?\d+)?[fFlL]?$/.test(tok)) {
+    const value = parseFloat(tok);
+    return isNaN(value) ? null : { kind: 'float', value };
+  }
+  return null;
+}
+
+/**
+ * 整数字面量的类型：依次尝试后缀允许的类型，取第一个能表示该值的；
+ * 十进制无 u 后缀时只用有符号类型，八/十六/二进制还可以用同宽的无符号类型
+ */
+function literalType(value: bigint, suffix: string, decimal: boolean, profile: DataModelProfile): IntegerType {
+  const unsigned = /u/i.test(suffix);
+  const longs = (suffix.match(/l/gi) || []).length;
+  const widths = [profile.int, profile.long, profile.longLong].slice(Math.min(longs, 2));
+  const candidates: IntegerType[] = [];
+  for (const bits of widths) {
+    if (!unsigned) candidates.push({ signed: true, bits });
+    if (unsigned || !decimal) candidates.push({ signed: false, bits });
+  }
+  for (const type of candidates) {
+    const max = type.signed ? (1n << BigInt(type.bits - 1)) - 1n : (1n << BigInt(type.bits)) - 1n;
+    if (value <= max) return type;
+  }
+  return candidates[candidates.length - 1];
+}
@@ -0,0 +1,299 @@
+// C99/C11 格式字符串解析器：解析 printf/scanf 系列的转换说明，按字面量文本缓存结果，
+// 并提供基于参数类型的匹配检查
+
+export type FormatFlavor = 'printf' | 'scanf';
+
+export type LengthModifier = '' | 'hh' | 'h' | 'l' | 'll' | 'j' | 'z' | 't' | 'L';
+
+/**
+ * 一个转换说明，如 "%-08.3lf"
+ */
+export interface ConversionSpec {
+  text: string;                 // 原文（含 '%'）
+  offset: number;               // 在格式串中的偏移
+  flags: string;                // printf: "-+ #0"；scanf 不使用
+  width: number | '*' | null;   // '*' 表示由参数提供（仅 printf）
+  precision: number | '*' | null;
+  length: LengthModifier;
+  conversion: string;           // d i o u x X f F e E g G a A c s p n [
+  suppressed: boolean;          // scanf 的 '*' 赋值抑制
+}
+
+export interface ParsedFormat {
+  specs: ConversionSpec[];
+  argCount: number;             // 该格式串消耗的可变参数个数（含 '*' 宽度/精度）
+  errors: string[];             // 无法识别或不完整的转换说明
+}
+
+const PRINTF_CONVERSIONS = 'diouxXfFeEgGaAcspn';
+const SCANF_CONVERSIONS = 'diouxXfFeEgGaAcspn[';
+const PRINTF_FLAGS = '-+ #0';
+
+// 按 (风格, 字面量) 缓存解析结果；日志密集的代码中同一字面量会重复出现成千上万次
+const cache: Record<FormatFlavor, Map<string, ParsedFormat>> = {
+  printf: new Map(),
+  scanf: new Map()
+};
+const CACHE_LIMIT = 8192;
+
+/**
+ * 解析格式字符串（字面量内容，不含两侧引号），结果被缓存且不可修改
+ */
+export function parseFormat(format: string, flavor: FormatFlavor): ParsedFormat {
+  const table = cache[flavor];
+  const hit = table.get(format);
+  if (hit) return hit;
+
+  const parsed = flavor === 'printf' ? parsePrintf(format) : parseScanf(format);
+  Object.freeze(parsed.specs);
+  if (table.size >= CACHE_LIMIT) table.clear();
+  table.set(format, parsed);
+  return parsed;
+}
+
+function parsePrintf(format: string): ParsedFormat {
+  const specs: ConversionSpec[] = [];
+  const errors: string[] = [];
+  let argCount = 0;
+
+  for (let i = 0; i < format.length; i++) {
+    if (format[i] !== '%') continue;
+    const start = i++;
+    if (format[i] === '%') continue;
+
+    let flags = '';
+    while (i < format.length && PRINTF_FLAGS.includes(format[i])) flags += format[i++];
+
+    let width: number | '*' | null = null;
+    if (format[i] === '*') {
+      width = '*';
+      argCount++;
+      i++;
+    } else {
+      const w = readNumber(format, i);
+      if (w) { width = w.value; i = w.end; }
+    }
+
+    let precision: number | '*' | null = null;
+    if (format[i] === '.') {
+      i++;
+      if (format[i] === '*') {
+        precision = '*';
+        argCount++;
+        i++;
+      } else {
+        const p = readNumber(format, i);
+        precision = p ? p.value : 0;
+        if (p) i = p.end;
+      }
+    }
+
+    const len = readLength(format, i);
+    i = len.end;
+
+    const conversion = format[i];
+    if (conversion === undefined || !PRINTF_CONVERSIONS.includes(conversion)) {
+      errors.push(format.slice(start, i + 1));
+      i--;
+      continue;
+    }
+
+    specs.push({
+      text: format.slice(start, i + 1),
+      offset: start,
+      flags, width, precision,
+      length: len.length,
+      conversion,
+      suppressed: false
+    });
+    argCount++;
+  }
+
+  return { specs, argCount, errors };
+}
+
+function parseScanf(format: string): ParsedFormat {
+  const specs: ConversionSpec[] = [];
+  const errors: string[] = [];
+  let argCount = 0;
+
+  for (let i = 0; i < format.length; i++) {
+    if (format[i] !== '%') continue;
+    const start = i++;
+    if (format[i] === '%') continue;
+
+    let suppressed = false;
+    if (format[i] === '*') {
+      suppressed = true;
+      i++;
+    }
+
+    let width: number | null = null;
+    const w = readNumber(format, i);
+    if (w) { width = w.value; i = w.end; }
+
+    const len = readLength(format, i);
+    i = len.end;
+
+    const conversion = format[i];
+    if (conversion === undefined || !SCANF_CONVERSIONS.includes(conversion)) {
+      errors.push(format.slice(start, i + 1));
+      i--;
+      continue;
+    }
+
+    // 扫描集 %[...]，']' 紧跟 '[' 或 '[^' 时属于集合本身
+    if (conversion === '[') {
+      let j = i + 1;
+      if (format[j] === '^') j++;
+      if (format[j] === ']') j++;
+      while (j < format.length && format[j] !== ']') j++;
+      if (j >= format.length) {
+        errors.push(format.slice(start));
+        break;
+      }
+      i = j;
+    }
+
+    specs.push({
+      text: format.slice(start, i + 1),
+      offset: start,
+      flags: '',
+      width,
+      precision: null,
+      length: len.length,
+      conversion,
+      suppressed
+    });
+    if (!suppressed) argCount++;
+  }
+
+  return { specs, argCount, errors };
+}
+
+function readNumber(s: string, i: number): { value: number; end: number } | null {
+  let end = i;
+  while (end < s.length && s[end] >= '0' && s[end] <= '9') end++;
+  return end > i ? { value: parseInt(s.slice(i, end), 10), end } : null;
+}
+
+function readLength(s: string, i: number): { length: LengthModifier; end: number } {
+  const two = s.slice(i, i + 2);
+  if (two === 'hh' || two === 'll') return { length: two, end: i + 2 };
+  const one = s[i];
+  if (one === 'h' || one === 'l' || one === 'j' || one === 'z' || one === 't' || one === 'L') {
+    return { length: one, end: i + 1 };
+  }
+  return { length: '', end: i };
+}
+
+/**
+ * 参数类型的粗粒度分类，用于格式匹配检查
+ */
+export type ArgClass = 'int' | 'long' | 'long long' | 'size' | 'double' | 'long double' | 'string' | 'pointer' | 'unknown';
+
+/**
+ * 格式串期望的一个可变参数
+ */
+export interface ExpectedArgument {
+  spec: ConversionSpec;
+  expected: ArgClass;
+}
+
+/**
+ * 按可变参数的出现顺序，给出格式串期望的参数分类（'*' 宽度/精度期望 int；scanf 期望对应的指针）
+ */
+export function expectedArguments(parsed: ParsedFormat, flavor: FormatFlavor): ExpectedArgument[] {
+  const result: ExpectedArgument[] = [];
+  for (const spec of parsed.specs) {
+    if (spec.width === '*') result.push({ spec, expected: 'int' });
+    if (spec.precision === '*') result.push({ spec, expected: 'int' });
+    if (spec.suppressed) continue;
+    result.push({ spec, expected: flavor === 'printf' ? printfClass(spec) : scanfClass(spec) });
+  }
+  return result;
+}
+
+/**
+ * printf/scanf 系列函数：格式串参数下标与风格
+ */
+export const FORMAT_FUNCTIONS: Record<string, { formatIndex: number; flavor: FormatFlavor }> = {
+  printf:   { formatIndex: 0, flavor: 'printf' },
+  fprintf:  { formatIndex: 1, flavor: 'printf' },
+  dprintf:  { formatIndex: 1, flavor: 'printf' },
+  sprintf:  { formatIndex: 1, flavor: 'printf' },
+  snprintf: { formatIndex: 2, flavor: 'printf' },
+  scanf:    { formatIndex: 0, flavor: 'scanf' },
+  fscanf:   { formatIndex: 1, flavor: 'scanf' },
+  sscanf:   { formatIndex: 1, flavor: 'scanf' }
+};
+
+function integerClass(length: LengthModifier): ArgClass {
+  switch (length) {
+    case 'l': return 'long';
+    case 'll': case 'j': return 'long long';
+    case 'z': case 't': return 'size';
+    default: return 'int';
+  }
+}
+
+function printfClass(spec: ConversionSpec): ArgClass {
+  switch (spec.conversion) {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+      return spec.conversion === 'c' ? 'int' : integerClass(spec.length);
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+      return spec.length === 'L' ? 'long double' : 'double';
+    case 's':
+      return 'string';
+    case 'p': case 'n':
+      return 'pointer';
+  }
+  return 'unknown';
+}
+
+function scanfClass(spec: ConversionSpec): ArgClass {
+  // scanf 的所有非抑制转换都需要指针；%s/%c/%[ 需要字符缓冲区
+  if (spec.conversion === 's' || spec.conversion === 'c' || spec.conversion === '[') return 'string';
+  return 'pointer';
+}
+
+/**
+ * 将 C 类型文本（如 "unsigned long", "char *", "double"）归入参数分类；无法判断时返回 'unknown'
+ */
+export function classifyCType(type: string): ArgClass {
+  const t = type.replace(/\b(const|volatile|static|register|extern|restrict)\b/g, '').replace(/\s+/g, ' ').trim();
+  if (!t) return 'unknown';
+  if (/\*|\[\]$/.test(t)) {
+    return /^(signed |unsigned )?char ?(\*|\[\])$/.test(t) ? 'string' : 'pointer';
+  }
+  if (/^long double$/.test(t)) return 'long double';
+  if (/^(float|double)$/.test(t)) return 'double';
+  if (/^(size_t|ssize_t|ptrdiff_t|uintptr_t|intptr_t)$/.test(t)) return 'size';
+  if (/\blong long\b|^u?int64_t$|^u?intmax_t$/.test(t)) return 'long long';
+  if (/\blong\b/.test(t)) return 'long';
+  if (/^(signed |unsigned )?(char|short|int|short int)$|^(signed|unsigned|_Bool|bool)$|^u?int(8|16|32)_t$/.test(t)) return 'int';
+  return 'unknown';
+}
+
+/**
+ * 期望分类与实参分类是否明显冲突（任一未知时不判定）
+ */
+export function isArgMismatch(expected: ArgClass, actual: ArgClass, flavor: FormatFlavor): boolean {
+  if (expected === 'unknown' || actual === 'unknown') return false;
+  if (flavor === 'scanf') {
+    // scanf 只检查"需要地址却传入了非指针值"
+    return actual !== 'pointer' && actual !== 'string';
+  }
+  const integers: ArgClass[] = ['int', 'long', 'long long', 'size'];
+  if (integers.includes(expected)) {
+    if (!integers.includes(actual)) return true;
+    // 宽度不一致：long 在 LP64 下与 size 同宽，只报告 int 与 64 位整数的混用
+    return (expected === 'int') !== (actual === 'int');
+  }
+  if (expected === 'double' || expected === 'long double') {
+    return actual !== 'double' && actual !== 'long double';
+  }
+  if (expected === 'string') return actual !== 'string' && actual !== 'pointer';
+  if (expected === 'pointer') return actual !== 'pointer' && actual !== 'string';
+  return false;
+}
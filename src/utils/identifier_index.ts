@@ -0,0 +1,277 @@
+// 标识符出现位置索引：单遍词法扫描，按标识符聚合所有出现位置及其上下文类别
+
+/**
+ * 出现位置的上下文类别
+ * - assigned: 作为简单赋值/初始化的左值（p = ...）
+ * - stored:   作为整个右值被存入其他位置（q = p; *out = p; s->f = p;）
+ * - passed:   作为普通函数调用的实参
+ * - freed:    作为 free() 的实参
+ * - returned: 作为 return 语句的返回值
+ * - used:     其他读取
+ */
+export type OccurrenceKind = 'assigned' | 'stored' | 'passed' | 'freed' | 'returned' | 'used';
+
+export interface Occurrence {
+  offset: number;
+  line: number;            // 0 起始行号
+  kind: OccurrenceKind;
+  source?: string;         // assigned 时右值若为函数调用，记录被调函数名（如 malloc）
+  target?: string;         // stored 时左值的基础标识符
+}
+
+type TokenType = 'ident' | 'number' | 'punct';
+
+interface Token {
+  type: TokenType;
+  text: string;
+  offset: number;
+  line: number;
+}
+
+// 不视为函数调用的关键字（其后的括号只是语法分组）
+const NON_CALL_KEYWORDS = new Set([
+  'if', 'while', 'for', 'switch', 'return', 'sizeof', 'do', 'else', 'case',
+  '_Alignof', 'alignof', 'defined', '__attribute__', 'typeof', '__typeof__'
+]);
+
+// 作为语句起始、其后的 '*' 为解引用而非指针声明的记号
+const STATEMENT_BOUNDARY = new Set([';', '{', '}', ')', ':']);
+
+const PUNCTUATORS = [
+  '<<=', '>>=', '...', '->', '++', '--', '<<', '>>', '<=', '>=', '==', '!=',
+  '&&', '||', '*=', '/=', '%=', '+=', '-=', '&=', '^=', '|='
+];
+
+export class IdentifierIndex {
+  private occurrences = new Map<string, Occurrence[]>();
+
+  private constructor() {}
+
+  /**
+   * 对源码做一次词法扫描并建立索引（跳过注释、字符串与字符字面量）
+   */
+  static build(content: string): IdentifierIndex {
+    const index = new IdentifierIndex();
+    index.classify(IdentifierIndex.tokenize(content));
+    return index;
+  }
+
+  /**
+   * 获取某标识符按偏移排序的全部出现位置
+   */
+  get(name: string): Occurrence[] {
+    return this.occurrences.get(name) || [];
+  }
+
+  /**
+   * 遍历所有标识符及其出现列表
+   */
+  entries(): IterableIterator<[string, Occurrence[]]> {
+    return this.occurrences.entries();
+  }
+
+  private static tokenize(content: string): Token[] {
+    const tokens: Token[] = [];
+    const len = content.length;
+    let line = 0;
+    let i = 0;
+
+    while (i < len) {
+      const ch = content[i];
+
+      if (ch === '\n') { line++; i++; continue; }
+      if (ch === ' ' || ch === '\t' || ch === '\r' || ch === '\f' || ch === '\v') { i++; continue; }
+
+      // 注释
+      if (ch === '/' && content[i + 1] === '/') {
+        while (i < len && content[i] !== '\n') i++;
+        continue;
+      }
+      if (ch === '/' && content[i + 1] === '*') {
+        i += 2;
+        while (i < len && !(content[i] === '*' && content[i + 1] === '/')) {
+          if (content[i] === '\n') line++;
+          i++;
+        }
+        i += 2;
+        continue;
+      }
+
+      // 字符串与字符字面量：整体作为一个记号
+      if (ch === '"' || ch === '\'') {
+        const start = i;
+        i++;
+        while (i < len && content[i] !== ch && content[i] !== '\n') {
+          if (content[i] === '\\') i++;
+          i++;
+        }
+        i++;
+        tokens.push({ type: 'punct', text: ch, offset: start, line });
+        continue;
+      }
+
+      if (/[A-Za-z_]/.test(ch)) {
+        const start = i;
+        while (i < len && /\w/.test(content[i])) i++;
+        tokens.push({ type: 'ident', text: content.slice(start, i), offset: start, line });
+        continue;
+      }
+
+      if (/[0-9]/.test(ch) || (ch === '.' && /[0-9]/.test(content[i + 1] || ''))) {
+        const start = i;
+        while (i < len && /[\w.]/.test(content[i])) i++;
+        tokens.push({ type: 'number', text: content.slice(start, i), offset: start, line });
+        continue;
+      }
+
+      let text = ch;
+      for (const p of PUNCTUATORS) {
+        if (content.startsWith(p, i)) { text = p; break; }
+      }
+      tokens.push({ type: 'punct', text, offset: i, line });
+      i += text.length;
+    }
+
+    return tokens;
+  }
+
+  private classify(tokens: Token[]): void {
+    // 括号栈：记录每层 '(' 所属的被调函数名（分组括号为 null）
+    const parenStack: Array<string | null> = [];
+
+    for (let t = 0; t < tokens.length; t++) {
+      const tok = tokens[t];
+
+      if (tok.type === 'punct') {
+        if (tok.text === '(') {
+          const prev = tokens[t - 1];
+          const isCall = prev && prev.type === 'ident' && !NON_CALL_KEYWORDS.has(prev.text);
+          parenStack.push(isCall ? prev.text : null);
+        } else if (tok.text === ')') {
+          parenStack.pop();
+        }
+        continue;
+      }
+      if (tok.type !== 'ident') continue;
+
+      const next = tokens[t + 1];
+      // 函数名本身不是变量出现；成员名（s->f）按名字一并索引，以覆盖 s->f = malloc(...)
+      if (next && next.text === '(') continue;
+
+      this.add(tok.text, this.classifyOccurrence(tokens, t, parenStack, tok));
+    }
+  }
+
+  private classifyOccurrence(tokens: Token[], t: number, parenStack: Array<string | null>, tok: Token): Occurrence {
+    const occ: Occurrence = { offset: tok.offset, line: tok.line, kind: 'used' };
+    const prev = tokens[t - 1];
+    const next = tokens[t + 1];
+
+    // return x; / return (x); / return *x;
+    if (this.isReturnOperand(tokens, t)) {
+      occ.kind = 'returned';
+      return occ;
+    }
+
+    // free(x) / free((T *)x)
+    const callee = this.innermostCallee(parenStack);
+    if (callee !== undefined) {
+      const afterIsClose = next && next.text === ')';
+      if (callee === 'free' && afterIsClose) {
+        occ.kind = 'freed';
+        return occ;
+      }
+    }
+
+    // 左值：x = ...（排除 *x = ... 的解引用写入）
+    if (next && next.text === '=' && !(prev && prev.text === '*' && this.isDerefStar(tokens, t - 1))) {
+      occ.kind = 'assigned';
+      occ.source = this.rhsCallee(tokens, t + 2);
+      return occ;
+    }
+
+    // 右值整体：lhs = x;
+    if (prev && prev.text === '=' && next && (next.text === ';' || next.text === ',')) {
+      occ.kind = 'stored';
+      occ.target = this.lhsBase(tokens, t - 1);
+      return occ;
+    }
+
+    if (callee) {
+      occ.kind = 'passed';
+    }
+    return occ;
+  }
+
+  private innermostCallee(parenStack: Array<string | null>): string | null | undefined {
+    // 跳过类型转换等分组括号，找到最近一层函数调用
+    for (let i = parenStack.length - 1; i >= 0; i--) {
+      if (parenStack[i] !== null) return parenStack[i];
+    }
+    return parenStack.length > 0 ? null : undefined;
+  }
+
+  private isReturnOperand(tokens: Token[], t: number): boolean {
+    let b = t - 1;
+    while (b >= 0 && (tokens[b].text === '(' || tokens[b].text === '*')) b--;
+    if (b < 0 || tokens[b].text !== 'return') return false;
+    let f = t + 1;
+    while (f < tokens.length && tokens[f].text === ')') f++;
+    return f < tokens.length && tokens[f].text === ';';
+  }
+
+  private isDerefStar(tokens: Token[], starIndex: number): boolean {
+    // 语句开头的 '*' 是解引用；类型名之后的 '*' 是指针声明
+    const before = tokens[starIndex - 1];
+    return !before || STATEMENT_BOUNDARY.has(before.text) || before.text === '=' || before.text === ',';
+  }
+
+  private rhsCallee(tokens: Token[], start: number): string | undefined {
+    let i = start;
+    // 跳过类型转换：(T *) 或 (struct T *)
+    if (tokens[i] && tokens[i].text === '(') {
+      let j = i + 1;
+      while (j < tokens.length && (tokens[j].type === 'ident' || tokens[j].text === '*')) j++;
+      if (tokens[j] && tokens[j].text === ')' && j > i + 1) i = j + 1;
+    }
+    const tok = tokens[i];
+    const after = tokens[i + 1];
+    if (tok && tok.type === 'ident' && after && after.text === '(') return tok.text;
+    return undefined;
+  }
+
+  private lhsBase(tokens: Token[], eqIndex: number): string | undefined {
+    // 从 '=' 向前回溯到左值表达式的起始标识符（*out / a->b / a.b / a[i]）
+    let depth = 0;
+    let base: string | undefined;
+    for (let i = eqIndex - 1; i >= 0; i--) {
+      const text = tokens[i].text;
+      if (text === ']' || text === ')') { depth++; continue; }
+      if (text === '[' || text === '(') {
+        if (depth === 0) break;
+        depth--;
+        continue;
+      }
+      if (depth > 0) continue;
+      if (tokens[i].type === 'ident') {
+        base = text;
+        // 仅沿成员访问继续回溯，遇到类型名（声明）即停止
+        const before = tokens[i - 1];
+        if (before && (before.text === '.' || before.text === '->')) continue;
+        break;
+      }
+      if (text === '.' || text === '->' || text === '*') continue;
+      break;
+    }
+    return base;
+  }
+
+  private add(name: string, occ: Occurrence): void {
+    let list = this.occurrences.get(name);
+    if (!list) {
+      list = [];
+      this.occurrences.set(name, list);
+    }
+    list.push(occ);
+  }
+}
@@ -0,0 +1,31 @@
+// 运行计数：默认关闭，关闭时各计数点只有一次布尔判断；
+// 开启后累计语法树节点访问次数与检测器各正则调用点的执行次数（不改动全局的 RegExp）
+
+export const instrumentation = {
+  enabled: false,
+  /** 语法树节点访问次数（取命名子节点时逐个检查的子节点） */
+  nodes: 0,
+  /** 检测器正则调用点的执行次数 */
+  regex: 0
+};
+
+/**
+ * 在检测器的正则调用点记一次执行
+ */
+export function countRegex(): void {
+  if (instrumentation.enabled) instrumentation.regex++;
+}
+
+/**
+ * 开启或关闭计数
+ */
+export function setInstrumentation(enabled: boolean): void {
+  instrumentation.enabled = enabled;
+}
+
+/**
+ * 单调时钟（毫秒）
+ */
+export function now(): number {
+  return Number(process.hrtime.bigint()) / 1e6;
+}
@@ -0,0 +1,46 @@
+// 字符串驻留表：相同内容的字符串只保存一份，可按整数 id 引用。
+// 表本身不会收缩，只应驻留有界的词汇（节点类型、标识符、路径、类别），
+// 并由一次扫描或一个存储持有，随持有者一起释放；不要建立进程级的共用实例
+
+export class StringInterner {
+  private readonly ids = new Map<string, number>();
+  private readonly strings: string[] = [];
+
+  /**
+   * 已驻留的字符串个数
+   */
+  get size(): number {
+    return this.strings.length;
+  }
+
+  /**
+   * 字符串对应的 id，首次出现时分配
+   */
+  id(value: string): number {
+    let id = this.ids.get(value);
+    if (id === undefined) {
+      id = this.strings.length;
+      this.ids.set(value, id);
+      this.strings.push(value);
+    }
+    return id;
+  }
+
+  /**
+   * 规范实例：内容相同的字符串总是返回同一个对象
+   */
+  intern(value: string): string {
+    return this.strings[this.id(value)];
+  }
+
+  /**
+   * 按 id 取回字符串
+   */
+  get(id: number): string {
+    const value = this.strings[id];
+    if (value === undefined) {
+      throw new RangeError(`未知的字符串 id: ${id}`);
+    }
+    return value;
+  }
+}
@@ -0,0 +1,138 @@
+// 分级结构化日志：消息为固定文本，可变部分放在字段对象中，只在输出时格式化；
+// 每个模块一个 Logger，级别可按模块单独设置。热路径先判断 log.debugEnabled 等标志再构造字段，关闭时不做任何格式化
+
+export type LogLevel = 'silent' | 'error' | 'warn' | 'info' | 'debug' | 'trace';
+export type LogFormat = 'text' | 'json';
+export type LogFields = Record<string, unknown>;
+
+const LEVELS: Record<LogLevel, number> = { silent: 0, error: 1, warn: 2, info: 3, debug: 4, trace: 5 };
+
+/**
+ * 日志配置：全局级别与按模块覆盖的级别
+ */
+export interface LogConfig {
+  level: LogLevel;
+  modules: Record<string, LogLevel>;
+  format: LogFormat;
+}
+
+// 默认安静：只输出警告与错误
+const config: LogConfig = { level: 'warn', modules: {}, format: 'text' };
+const loggers = new Map<string, Logger>();
+
+export class Logger {
+  errorEnabled = false;
+  warnEnabled = false;
+  infoEnabled = false;
+  debugEnabled = false;
+  traceEnabled = false;
+
+  constructor(readonly module: string) {
+    this.configure();
+  }
+
+  error(message: string, fields?: LogFields): void {
+    if (this.errorEnabled) write('error', this.module, message, fields);
+  }
+
+  warn(message: string, fields?: LogFields): void {
+    if (this.warnEnabled) write('warn', this.module, message, fields);
+  }
+
+  info(message: string, fields?: LogFields): void {
+    if (this.infoEnabled) write('info', this.module, message, fields);
+  }
+
+  debug(message: string, fields?: LogFields): void {
+    if (this.debugEnabled) write('debug', this.module, message, fields);
+  }
+
+  trace(message: string, fields?: LogFields): void {
+    if (this.traceEnabled) write('trace', this.module, message, fields);
+  }
+
+  /**
+   * 按当前配置刷新各级别开关
+   */
+  configure(): void {
+    const threshold = LEVELS[config.modules[this.module] ?? config.level];
+    this.errorEnabled = threshold >= LEVELS.error;
+    this.warnEnabled = threshold >= LEVELS.warn;
+    this.infoEnabled = threshold >= LEVELS.info;
+    this.debugEnabled = threshold >= LEVELS.debug;
+    this.traceEnabled = threshold >= LEVELS.trace;
+  }
+}
+
+/**
+ * 获取（或创建）某个模块的 Logger
+ */
+export function getLogger(module: string): Logger {
+  let logger = loggers.get(module);
+  if (!logger) {
+    logger = new Logger(module);
+    loggers.set(module, logger);
+  }
+  return logger;
+}
+
+/**
+ * 修改日志配置并刷新全部已创建的 Logger
+ */
+export function configureLogging(options: Partial<LogConfig>): void {
+  if (options.level) config.level = options.level;
+  if (options.modules) config.modules = { ...options.modules };
+  if (options.format) config.format = options.format;
+  for (const logger of loggers.values()) logger.configure();
+}
+
+/**
+ * 解析 --log-level 的值：`debug`、`info,parser=trace,detectors=silent` 等
+ * 未带模块名的一项设置全局级别，`模块=级别` 覆盖单个模块
+ */
+export function parseLogLevel(spec: string): Pick<LogConfig, 'level' | 'modules'> {
+  const result: Pick<LogConfig, 'level' | 'modules'> = { level: config.level, modules: {} };
+  for (const part of spec.split(',').map(p => p.trim()).filter(Boolean)) {
+    const [name, value] = part.includes('=') ? part.split('=', 2) : [undefined, part];
+    if (!(value in LEVELS)) throw new Error(`未知日志级别: ${value}`);
+    if (name) result.modules[name] = value as LogLevel;
+    else result.level = value as LogLevel;
+  }
+  return result;
+}
+
+/**
+ * 从命令行参数读取 --log-level=<级别[,模块=级别...]> 与 --log-format=text|json
+ */
+export function parseLogArgs(args: string[]): Partial<LogConfig> {
+  const result: Partial<LogConfig> = {};
+  const level = args.find(a => a.startsWith('--log-level='));
+  if (level) Object.assign(result, parseLogLevel(level.slice('--log-level='.length)));
+  const format = args.find(a => a.startsWith('--log-format='));
+  if (format) {
+    const value = format.slice('--log-format='.length);
+    if (value !== 'text' && value !== 'json') throw new Error(`未知日志格式: ${value}`);
+    result.format = value;
+  }
+  return result;
+}
+
+function write(level: LogLevel, module: string, message: string, fields?: LogFields): void {
+  let line: string;
+  if (config.format === 'json') {
+    line = JSON.stringify({ time: new Date().toISOString(), level, module, message, ...fields });
+  } else {
+    line = `[${level}] ${module}: ${message}`;
+    if (fields) {
+      for (const key of Object.keys(fields)) line += ` ${key}=${formatValue(fields[key])}`;
+    }
+  }
+  process.stderr.write(line + '\n');
+}
+
+function formatValue(value: unknown): string {
+  if (typeof value === 'string') return /[\s"=]/.test(value) || value === '' ? JSON.stringify(value) : value;
+  if (value instanceof Error) return JSON.stringify(value.message);
+  if (typeof value === 'object' && value !== null) return JSON.stringify(value);
+  return String(value);
+}
@@ -0,0 +1,68 @@
+// 扁平作用域符号表：名字驻留为整数 id，每个 id 只保存当前可见的绑定；
+// 进入作用域时记下撤销日志的位置，离开时按日志回滚被遮蔽的绑定，查找只需一次哈希探测
+
+export class ScopedSymbolTable<T> {
+  private readonly ids = new Map<string, number>();
+  private readonly visible: Array<T | undefined> = [];
+  // 撤销日志：每次声明前该 id 的绑定
+  private readonly undoIds: number[] = [];
+  private readonly undoBindings: Array<T | undefined> = [];
+  private readonly marks: number[] = [];
+
+  /**
+   * 当前作用域深度（最外层为 0）
+   */
+  get depth(): number {
+    return this.marks.length;
+  }
+
+  /**
+   * 名字对应的整数 id，首次出现时分配
+   */
+  intern(name: string): number {
+    let id = this.ids.get(name);
+    if (id === undefined) {
+      id = this.visible.length;
+      this.ids.set(name, id);
+      this.visible.push(undefined);
+    }
+    return id;
+  }
+
+  pushScope(): void {
+    this.marks.push(this.undoIds.length);
+  }
+
+  /**
+   * 离开作用域：回滚该作用域内的全部声明；已在最外层时不做任何事
+   */
+  popScope(): void {
+    const mark = this.marks.pop();
+    if (mark === undefined) return;
+    while (this.undoIds.length > mark) {
+      this.visible[this.undoIds.pop()!] = this.undoBindings.pop();
+    }
+  }
+
+  /**
+   * 在当前作用域声明（同一作用域内重复声明时覆盖）
+   */
+  declare(name: string, value: T): void {
+    const id = this.intern(name);
+    this.undoIds.push(id);
+    this.undoBindings.push(this.visible[id]);
+    this.visible[id] = value;
+  }
+
+  /**
+   * 当前可见的绑定（最内层的声明）
+   */
+  lookup(name: string): T | undefined {
+    const id = this.ids.get(name);
+    return id === undefined ? undefined : this.visible[id];
+  }
+
+  has(name: string): boolean {
+    return this.lookup(name) !== undefined;
+  }
+}
@@ -0,0 +1,20 @@
+// 源文件发现：CLI、评测与基准测试共用同一份规则，保证它们扫描的是同一组文件
+
+import * as fs from 'fs';
+import * as path from 'path';
+
+/**
+ * 递归收集目录下的 .c 文件，返回相对 dir 的路径（按路径排序，保证各次扫描顺序一致）
+ */
+export function discoverSources(dir: string): string[] {
+  const files: string[] = [];
+  const walk = (relative: string) => {
+    for (const entry of fs.readdirSync(path.join(dir, relative), { withFileTypes: true })) {
+      const name = relative ? path.join(relative, entry.name) : entry.name;
+      if (entry.isDirectory()) walk(name);
+      else if (entry.isFile() && entry.name.endsWith('.c')) files.push(name);
+    }
+  };
+  walk('');
+  return files.sort();
+}
@@ -0,0 +1,109 @@
+// Chrome / Perfetto 跟踪事件：默认关闭，关闭时各埋点只有一次布尔判断，不取时间也不分配对象；
+// 开启后以完整事件（ph: 'X'）记录扫描各阶段，结束时写成 chrome://tracing 与 ui.perfetto.dev 可直接打开的 JSON。
+// tid 由线程号与并发通道组成：主线程为 0，worker 线程为 threadId * 1000，同一线程内的并发任务各占一个通道。
+// 除写文件外也可注册监听器逐个接收跨度（基准测试据此按阶段计时），两者互不影响
+
+import * as fs from 'fs';
+import { threadId } from 'worker_threads';
+import { now } from './instrumentation';
+
+export interface TraceEvent {
+  name: string;
+  cat: string;
+  ph: 'X' | 'M';
+  /** 微秒 */
+  ts: number;
+  dur?: number;
+  pid: number;
+  tid: number;
+  args?: Record<string, unknown>;
+}
+
+// 每个线程可区分的并发通道数
+const LANES = 1000;
+
+export type TraceListener = (event: TraceEvent) => void;
+
+export const tracing = {
+  enabled: false
+};
+
+let recording = false;
+let listener: TraceListener | null = null;
+let events: TraceEvent[] = [];
+const threads = new Map<number, string>();
+
+/**
+ * 开始记录（清空此前的事件）
+ */
+export function startTracing(): void {
+  recording = true;
+  tracing.enabled = true;
+  events = [];
+  threads.clear();
+}
+
+/**
+ * 设置（或以 null 清除）跨度监听器；监听器收到的事件不会被保存
+ */
+export function setTraceListener(next: TraceListener | null): void {
+  listener = next;
+  tracing.enabled = recording || listener !== null;
+}
+
+/**
+ * 跨度起点（微秒）；未开启时返回 0
+ */
+export function traceStart(): number {
+  return tracing.enabled ? now() * 1000 : 0;
+}
+
+/**
+ * 记录从 start 到现在的一个跨度；lane 为当前线程内的并发通道号
+ */
+export function traceSpan(name: string, cat: string, start: number, args?: Record<string, unknown>, lane: number = 0): void {
+  if (!tracing.enabled) return;
+  const tid = threadId * LANES + lane;
+  const event: TraceEvent = { name, cat, ph: 'X', ts: start, dur: now() * 1000 - start, pid: process.pid, tid, args };
+  if (listener) listener(event);
+  if (!recording) return;
+  if (!threads.has(tid)) {
+    const thread = threadId === 0 ? 'main' : `worker ${threadId}`;
+    threads.set(tid, lane === 0 ? thread : `${thread} / lane ${lane}`);
+  }
+  events.push(event);
+}
+
+/**
+ * 已记录的事件数
+ */
+export function traceEventCount(): number {
+  return events.length;
+}
+
+/**
+ * 停止记录并写出 JSON（逐事件写入，不拼接整份文档）
+ */
+export function writeTrace(filePath: string): number {
+  recording = false;
+  tracing.enabled = listener !== null;
+  const metadata: TraceEvent[] = [{ name: 'process_name', cat: '__metadata', ph: 'M', ts: 0, pid: process.pid, tid: 0, args: { name: 'c-scanner' } }];
+  for (const [tid, name] of threads) {
+    metadata.push({ name: 'thread_name', cat: '__metadata', ph: 'M', ts: 0, pid: process.pid, tid, args: { name } });
+  }
+  const fd = fs.openSync(filePath, 'w');
+  try {
+    fs.writeSync(fd, '{"displayTimeUnit":"ms","traceEvents":[\n');
+    let first = true;
+    for (const event of [...metadata, ...events]) {
+      fs.writeSync(fd, (first ? '' : ',\n') + JSON.stringify(event));
+      first = false;
+    }
+    fs.writeSync(fd, '\n]}\n');
+  } finally {
+    fs.closeSync(fd);
+  }
+  const count = events.length;
+  events = [];
+  return count;
+}
@@ -0,0 +1,27 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// BUG: 循环结束后指针必为空的解引用测试
+typedef struct Node {
+    int v;
+    struct Node *next;
+} Node;
+
+// 测试1: while 循环以 q == NULL 退出，之后解引用 q
+void set_after_loop(Node *head) {
+    Node *q = head;
+    while (q) q = q->next;
+    q->v = 1; // BUG: null pointer - 循环退出时 q 必为 NULL
+}
+
+int main() {
+    Node *head = (Node *)malloc(sizeof(Node));
+    if (head == NULL) {
+        return 1;
+    }
+    head->v = 0;
+    head->next = NULL;
+    set_after_loop(head);
+    free(head);
+    return 0;
+}
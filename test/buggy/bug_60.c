@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// BUG: 经由别名与同文件函数的内存泄漏/返回已释放内存测试
+
+// 只读取参数，既不释放也不保存指针
+static void sink(char *s) {
+    printf("%s\n", s);
+}
+
+// 测试1: 传给同文件函数不等于转移所有权
+void leak_through_call(void) {
+    char *p = malloc(16); // BUG: memory leak - sink 既不释放也不保存 p
+    if (p == NULL) {
+        return;
+    }
+    strcpy(p, "hello");
+    sink(p);
+}
+
+// 测试2: 通过别名 q 释放后返回 p
+char *return_freed_alias(void) {
+    char *p = malloc(16);
+    char *q;
+    q = p;
+    free(q);
+    return p; // BUG: Dangling pointer return - 返回已释放内存
+}
+
+// 测试3: 同文件函数经由局部别名释放了形参
+static void release(char *p) {
+    char *q = p;
+    free(q);
+}
+
+char *return_released(void) {
+    char *p = malloc(16);
+    release(p);
+    return p; // BUG: Dangling pointer return - release 经由别名释放了 p
+}
+
+int main() {
+    leak_through_call();
+    char *t = return_released(); // BUG: dangling pointer - t 接收了已释放内存
+    printf("%p\n", (void *)t);
+    char *s = return_freed_alias(); // BUG: dangling pointer - s 接收了已释放内存
+    printf("%p\n", (void *)s);
+    return 0;
+}
@@ -0,0 +1,23 @@
+#include <stdio.h>
+
+// BUG: 区间分析下的赋值溢出与恒不为假的循环条件测试
+
+// 测试1: 255 + 1 赋回 unsigned char 必然溢出
+void wrap_counter(void) {
+    unsigned char x = 255;
+    x = x + 1; // BUG: range overflow - 256 超出 unsigned char 范围
+    printf("%u\n", x);
+}
+
+// 测试2: 无符号变量恒 >= 0，循环无法退出
+void count_down(void) {
+    for (unsigned i = 10; i >= 0; i--) { // BUG: dead loop - i >= 0 恒为真
+        printf("%u\n", i);
+    }
+}
+
+int main() {
+    wrap_counter();
+    count_down();
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// BUG: 依赖控制流边的死循环测试
+
+// 测试1: goto 的目标仍在循环体内，没有离开循环
+void goto_inside(int n) {
+    int i = 0;
+    while (1) { // BUG: dead loop - goto 只跳到循环体内的标签
+        i += n;
+        if (i > 100) goto reset;
+        continue;
+    reset:
+        i = 0;
+    }
+}
+
+// 测试2: switch 内的 break 只跳出 switch，不跳出外层循环
+void break_in_switch(int mode) {
+    while (1) { // BUG: dead loop - break 只结束 switch
+        switch (mode) {
+        case 0:
+            printf("zero\n");
+            break;
+        default:
+            printf("other\n");
+            break;
+        }
+    }
+}
+
+// 测试3: 贯穿的 case 没有离开循环
+void fallthrough(int mode) {
+    for (;;) { // BUG: dead loop - 各 case 贯穿后都回到循环
+        switch (mode) {
+        case 1:
+            mode = 2;
+        case 2:
+            mode = 3;
+        default:
+            continue;
+        }
+    }
+}
+
+int main() {
+    goto_inside(1);
+    break_in_switch(0);
+    fallthrough(1);
+    return 0;
+}
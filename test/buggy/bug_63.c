@@ -0,0 +1,32 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// BUG: 只在一条分支上赋值的流敏感未初始化/空指针测试
+
+// 测试1: 只有 flag 为真时 value 才被赋值
+int pick(int flag) {
+    int value;
+    if (flag) {
+        value = 1;
+    }
+    return value; // BUG: uninitialized variable - flag 为假时 value 未赋值
+}
+
+// 测试2: p 只在一条分支上指向 x，判空的分支写反了
+void store(int flag) {
+    int x = 0;
+    int *p = NULL;
+    if (flag) {
+        p = &x;
+    }
+    if (p == NULL) {
+        *p = 1; // BUG: null pointer - 此分支上 p 必为 NULL
+    }
+    printf("%d\n", x);
+}
+
+int main() {
+    printf("%d\n", pick(1));
+    store(1);
+    return 0;
+}
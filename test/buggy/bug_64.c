@@ -0,0 +1,20 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// BUG: 分配后既未释放也未转移所有权的内存泄漏测试
+
+// 测试1: 指针只在本函数内读写，返回前未释放
+void forget(void) {
+    char *lost = malloc(32); // BUG: memory leak - lost 从未释放
+    if (lost == NULL) {
+        return;
+    }
+    lost[0] = 'a';
+    lost[1] = '\0';
+    printf("filled\n");
+}
+
+int main() {
+    forget();
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 经由别名释放：不应报告内存泄漏
+void free_through_alias(void) {
+    char *p = malloc(16);
+    if (p == NULL) {
+        return;
+    }
+    strcpy(p, "hello");
+    printf("%s\n", p);
+    char *q = p;
+    free(q);
+}
+
+int main() {
+    free_through_alias();
+    return 0;
+}
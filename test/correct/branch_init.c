@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// 两条分支都赋值、或解引用前重新判空：不应报告未初始化或空指针
+int pick(int flag) {
+    int value;
+    if (flag) {
+        value = 1;
+    } else {
+        value = 2;
+    }
+    return value;
+}
+
+void store(int flag) {
+    int x = 0;
+    int y = 0;
+    int *p = NULL;
+    if (flag) {
+        p = &x;
+    } else {
+        p = &y;
+    }
+    *p = 1;
+    printf("%d %d\n", x, y);
+}
+
+void store_checked(int flag) {
+    int x = 0;
+    int *p = NULL;
+    if (flag) {
+        p = &x;
+    }
+    if (p != NULL) {
+        *p = 1;
+    }
+    printf("%d\n", x);
+}
+
+int main() {
+    printf("%d\n", pick(1));
+    store(0);
+    store_checked(1);
+    return 0;
+}
@@ -0,0 +1,461 @@
+#include <stdio.h>
+
+// 循环体超过 200 行、退出语句在末尾附近：不应报告死循环
+int long_body(int step) {
+    int total = 0;
+    while (1) {
+        total += step * 1;
+        total += step * 2;
+        total += step * 3;
+        total += step * 4;
+        total += step * 5;
+        total += step * 6;
+        total += step * 7;
+        total += step * 8;
+        total += step * 9;
+        total += step * 10;
+        total += step * 11;
+        total += step * 12;
+        total += step * 13;
+        total += step * 14;
+        total += step * 15;
+        total += step * 16;
+        total += step * 17;
+        total += step * 18;
+        total += step * 19;
+        total += step * 20;
+        total += step * 21;
+        total += step * 22;
+        total += step * 23;
+        total += step * 24;
+        total += step * 25;
+        total += step * 26;
+        total += step * 27;
+        total += step * 28;
+        total += step * 29;
+        total += step * 30;
+        printf("checkpoint 1: %d\n", total);
+        total += step * 31;
+        total += step * 32;
+        total += step * 33;
+        total += step * 34;
+        total += step * 35;
+        total += step * 36;
+        total += step * 37;
+        total += step * 38;
+        total += step * 39;
+        total += step * 40;
+        total += step * 41;
+        total += step * 42;
+        total += step * 43;
+        total += step * 44;
+        total += step * 45;
+        total += step * 46;
+        total += step * 47;
+        total += step * 48;
+        total += step * 49;
+        total += step * 50;
+        total += step * 51;
+        total += step * 52;
+        total += step * 53;
+        total += step * 54;
+        total += step * 55;
+        total += step * 56;
+        total += step * 57;
+        total += step * 58;
+        total += step * 59;
+        total += step * 60;
+        printf("checkpoint 2: %d\n", total);
+        total += step * 61;
+        total += step * 62;
+        total += step * 63;
+        total += step * 64;
+        total += step * 65;
+        total += step * 66;
+        total += step * 67;
+        total += step * 68;
+        total += step * 69;
+        total += step * 70;
+        total += step * 71;
+        total += step * 72;
+        total += step * 73;
+        total += step * 74;
+        total += step * 75;
+        total += step * 76;
+        total += step * 77;
+        total += step * 78;
+        total += step * 79;
+        total += step * 80;
+        total += step * 81;
+        total += step * 82;
+        total += step * 83;
+        total += step * 84;
+        total += step * 85;
+        total += step * 86;
+        total += step * 87;
+        total += step * 88;
+        total += step * 89;
+        total += step * 90;
+        printf("checkpoint 3: %d\n", total);
+        total += step * 91;
+        total += step * 92;
+        total += step * 93;
+        total += step * 94;
+        total += step * 95;
+        total += step * 96;
+        total += step * 97;
+        total += step * 98;
+        total += step * 99;
+        total += step * 100;
+        total += step * 101;
+        total += step * 102;
+        total += step * 103;
+        total += step * 104;
+        total += step * 105;
+        total += step * 106;
+        total += step * 107;
+        total += step * 108;
+        total += step * 109;
+        total += step * 110;
+        total += step * 111;
+        total += step * 112;
+        total += step * 113;
+        total += step * 114;
+        total += step * 115;
+        total += step * 116;
+        total += step * 117;
+        total += step * 118;
+        total += step * 119;
+        total += step * 120;
+        printf("checkpoint 4: %d\n", total);
+        total += step * 121;
+        total += step * 122;
+        total += step * 123;
+        total += step * 124;
+        total += step * 125;
+        total += step * 126;
+        total += step * 127;
+        total += step * 128;
+        total += step * 129;
+        total += step * 130;
+        total += step * 131;
+        total += step * 132;
+        total += step * 133;
+        total += step * 134;
+        total += step * 135;
+        total += step * 136;
+        total += step * 137;
+        total += step * 138;
+        total += step * 139;
+        total += step * 140;
+        total += step * 141;
+        total += step * 142;
+        total += step * 143;
+        total += step * 144;
+        total += step * 145;
+        total += step * 146;
+        total += step * 147;
+        total += step * 148;
+        total += step * 149;
+        total += step * 150;
+        printf("checkpoint 5: %d\n", total);
+        total += step * 151;
+        total += step * 152;
+        total += step * 153;
+        total += step * 154;
+        total += step * 155;
+        total += step * 156;
+        total += step * 157;
+        total += step * 158;
+        total += step * 159;
+        total += step * 160;
+        total += step * 161;
+        total += step * 162;
+        total += step * 163;
+        total += step * 164;
+        total += step * 165;
+        total += step * 166;
+        total += step * 167;
+        total += step * 168;
+        total += step * 169;
+        total += step * 170;
+        total += step * 171;
+        total += step * 172;
+        total += step * 173;
+        total += step * 174;
+        total += step * 175;
+        total += step * 176;
+        total += step * 177;
+        total += step * 178;
+        total += step * 179;
+        total += step * 180;
+        printf("checkpoint 6: %d\n", total);
+        total += step * 181;
+        total += step * 182;
+        total += step * 183;
+        total += step * 184;
+        total += step * 185;
+        total += step * 186;
+        total += step * 187;
+        total += step * 188;
+        total += step * 189;
+        total += step * 190;
+        total += step * 191;
+        total += step * 192;
+        total += step * 193;
+        total += step * 194;
+        total += step * 195;
+        total += step * 196;
+        total += step * 197;
+        total += step * 198;
+        total += step * 199;
+        total += step * 200;
+        total += step * 201;
+        total += step * 202;
+        total += step * 203;
+        total += step * 204;
+        total += step * 205;
+        total += step * 206;
+        total += step * 207;
+        total += step * 208;
+        total += step * 209;
+        total += step * 210;
+        printf("checkpoint 7: %d\n", total);
+        if (total > 1000000) {
+            break;
+        }
+    }
+    return total;
+}
+
+int long_body_return(int step) {
+    int total = 0;
+    for (;;) {
+        total += step * 1;
+        total += step * 2;
+        total += step * 3;
+        total += step * 4;
+        total += step * 5;
+        total += step * 6;
+        total += step * 7;
+        total += step * 8;
+        total += step * 9;
+        total += step * 10;
+        total += step * 11;
+        total += step * 12;
+        total += step * 13;
+        total += step * 14;
+        total += step * 15;
+        total += step * 16;
+        total += step * 17;
+        total += step * 18;
+        total += step * 19;
+        total += step * 20;
+        total += step * 21;
+        total += step * 22;
+        total += step * 23;
+        total += step * 24;
+        total += step * 25;
+        total += step * 26;
+        total += step * 27;
+        total += step * 28;
+        total += step * 29;
+        total += step * 30;
+        printf("checkpoint 1: %d\n", total);
+        total += step * 31;
+        total += step * 32;
+        total += step * 33;
+        total += step * 34;
+        total += step * 35;
+        total += step * 36;
+        total += step * 37;
+        total += step * 38;
+        total += step * 39;
+        total += step * 40;
+        total += step * 41;
+        total += step * 42;
+        total += step * 43;
+        total += step * 44;
+        total += step * 45;
+        total += step * 46;
+        total += step * 47;
+        total += step * 48;
+        total += step * 49;
+        total += step * 50;
+        total += step * 51;
+        total += step * 52;
+        total += step * 53;
+        total += step * 54;
+        total += step * 55;
+        total += step * 56;
+        total += step * 57;
+        total += step * 58;
+        total += step * 59;
+        total += step * 60;
+        printf("checkpoint 2: %d\n", total);
+        total += step * 61;
+        total += step * 62;
+        total += step * 63;
+        total += step * 64;
+        total += step * 65;
+        total += step * 66;
+        total += step * 67;
+        total += step * 68;
+        total += step * 69;
+        total += step * 70;
+        total += step * 71;
+        total += step * 72;
+        total += step * 73;
+        total += step * 74;
+        total += step * 75;
+        total += step * 76;
+        total += step * 77;
+        total += step * 78;
+        total += step * 79;
+        total += step * 80;
+        total += step * 81;
+        total += step * 82;
+        total += step * 83;
+        total += step * 84;
+        total += step * 85;
+        total += step * 86;
+        total += step * 87;
+        total += step * 88;
+        total += step * 89;
+        total += step * 90;
+        printf("checkpoint 3: %d\n", total);
+        total += step * 91;
+        total += step * 92;
+        total += step * 93;
+        total += step * 94;
+        total += step * 95;
+        total += step * 96;
+        total += step * 97;
+        total += step * 98;
+        total += step * 99;
+        total += step * 100;
+        total += step * 101;
+        total += step * 102;
+        total += step * 103;
+        total += step * 104;
+        total += step * 105;
+        total += step * 106;
+        total += step * 107;
+        total += step * 108;
+        total += step * 109;
+        total += step * 110;
+        total += step * 111;
+        total += step * 112;
+        total += step * 113;
+        total += step * 114;
+        total += step * 115;
+        total += step * 116;
+        total += step * 117;
+        total += step * 118;
+        total += step * 119;
+        total += step * 120;
+        printf("checkpoint 4: %d\n", total);
+        total += step * 121;
+        total += step * 122;
+        total += step * 123;
+        total += step * 124;
+        total += step * 125;
+        total += step * 126;
+        total += step * 127;
+        total += step * 128;
+        total += step * 129;
+        total += step * 130;
+        total += step * 131;
+        total += step * 132;
+        total += step * 133;
+        total += step * 134;
+        total += step * 135;
+        total += step * 136;
+        total += step * 137;
+        total += step * 138;
+        total += step * 139;
+        total += step * 140;
+        total += step * 141;
+        total += step * 142;
+        total += step * 143;
+        total += step * 144;
+        total += step * 145;
+        total += step * 146;
+        total += step * 147;
+        total += step * 148;
+        total += step * 149;
+        total += step * 150;
+        printf("checkpoint 5: %d\n", total);
+        total += step * 151;
+        total += step * 152;
+        total += step * 153;
+        total += step * 154;
+        total += step * 155;
+        total += step * 156;
+        total += step * 157;
+        total += step * 158;
+        total += step * 159;
+        total += step * 160;
+        total += step * 161;
+        total += step * 162;
+        total += step * 163;
+        total += step * 164;
+        total += step * 165;
+        total += step * 166;
+        total += step * 167;
+        total += step * 168;
+        total += step * 169;
+        total += step * 170;
+        total += step * 171;
+        total += step * 172;
+        total += step * 173;
+        total += step * 174;
+        total += step * 175;
+        total += step * 176;
+        total += step * 177;
+        total += step * 178;
+        total += step * 179;
+        total += step * 180;
+        printf("checkpoint 6: %d\n", total);
+        total += step * 181;
+        total += step * 182;
+        total += step * 183;
+        total += step * 184;
+        total += step * 185;
+        total += step * 186;
+        total += step * 187;
+        total += step * 188;
+        total += step * 189;
+        total += step * 190;
+        total += step * 191;
+        total += step * 192;
+        total += step * 193;
+        total += step * 194;
+        total += step * 195;
+        total += step * 196;
+        total += step * 197;
+        total += step * 198;
+        total += step * 199;
+        total += step * 200;
+        total += step * 201;
+        total += step * 202;
+        total += step * 203;
+        total += step * 204;
+        total += step * 205;
+        total += step * 206;
+        total += step * 207;
+        total += step * 208;
+        total += step * 209;
+        total += step * 210;
+        printf("checkpoint 7: %d\n", total);
+        if (total > 1000000) {
+            return total;
+        }
+    }
+}
+
+int main() {
+    printf("%d\n", long_body(1));
+    printf("%d\n", long_body_return(1));
+    return 0;
+}
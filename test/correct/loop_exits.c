@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// 经由 goto、switch 贯穿与 exit() 离开的循环：不应报告死循环
+int goto_out(int n) {
+    int i = 0;
+    while (1) {
+        i += n;
+        if (i > 100) goto done;
+    }
+done:
+    return i;
+}
+
+void exit_in_switch(int mode) {
+    while (1) {
+        switch (mode) {
+        case 0:
+            printf("zero\n");
+            break;
+        default:
+            exit(0);
+        }
+    }
+}
+
+int fallthrough_return(int mode) {
+    for (;;) {
+        switch (mode) {
+        case 1:
+            mode = 2;
+        case 2:
+            return mode;
+        default:
+            mode = 1;
+        }
+    }
+}
+
+int flag_in_switch(int mode) {
+    int running = 1;
+    while (running) {
+        switch (mode) {
+        case 0:
+            running = 0;
+            break;
+        default:
+            mode--;
+            break;
+        }
+    }
+    return mode;
+}
+
+int main() {
+    printf("%d\n", goto_out(1));
+    printf("%d\n", fallthrough_return(1));
+    printf("%d\n", flag_in_switch(3));
+    exit_in_switch(1);
+    return 0;
+}
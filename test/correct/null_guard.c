@@ -0,0 +1,18 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// 判空保护后的解引用：不应报告空指针
+void set_if_present(int *p) {
+    if (p) *p = 1;
+}
+
+int main() {
+    int value = 0;
+    int *p = NULL;
+    set_if_present(p);
+    p = &value;
+    set_if_present(p);
+    if (p) *p = 2;
+    printf("%d\n", value);
+    return 0;
+}
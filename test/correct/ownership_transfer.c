@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// 分配后存入别处、作为实参传出或返回即转移了所有权：不应报告内存泄漏
+typedef struct Holder {
+    char *f;
+} Holder;
+
+static char *keep;
+
+void store_global(void) {
+    char *kept = malloc(8);
+    keep = kept;
+}
+
+void store_field(Holder *s) {
+    char *field = malloc(8);
+    s->f = field;
+}
+
+void store_out(char **out) {
+    char *buffer = malloc(8);
+    *out = buffer;
+}
+
+char *make(void) {
+    char *made = malloc(8);
+    return made;
+}
+
+static void consume(char *p) {
+    free(p);
+}
+
+void pass(void) {
+    char *owned = malloc(8);
+    consume(owned);
+}
+
+int main() {
+    Holder h;
+    char *o = NULL;
+    char *m = make();
+    store_global();
+    store_field(&h);
+    store_out(&o);
+    pass();
+    free(keep);
+    free(h.f);
+    free(o);
+    free(m);
+    return 0;
+}
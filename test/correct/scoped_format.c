@@ -0,0 +1,24 @@
+#include <stdio.h>
+
+// 同名局部变量只在其作用域内遮蔽全局变量：不应报告格式不匹配
+int count = 0;
+
+void scale(void) {
+    double count = 1.5;
+    printf("%f\n", count);
+}
+
+void report(void) {
+    printf("%d\n", count);
+}
+
+int main() {
+    for (int i = 0; i < 2; i++) {
+        double count = 2.0;
+        printf("%f\n", count);
+    }
+    printf("%d\n", count);
+    scale();
+    report();
+    return 0;
+}
@@ -0,0 +1,25 @@
+#include <stdio.h>
+
+// 无符号变量的算术与倒数循环：不应报告数值溢出或死循环
+void bump_counter(void) {
+    unsigned char x = 254;
+    x = x + 1;
+    printf("%u\n", x);
+}
+
+void count_down(void) {
+    for (unsigned i = 10; i > 0; i--) {
+        printf("%u\n", i);
+    }
+    for (int j = 10; j >= 0; j--) {
+        printf("%d\n", j);
+    }
+}
+
+int main() {
+    unsigned int all = ~0u;
+    bump_counter();
+    count_down();
+    printf("%u\n", all);
+    return 0;
+}
@@ -0,0 +1,12 @@
+#include <stdio.h>
+
+// 无符号常量按其类型回绕：不应报告数值溢出
+int main() {
+    unsigned int all = ~0u;
+    unsigned long mask = ~0UL;
+    unsigned int max = 0xFFFFFFFFu;
+    unsigned int wrap = -1u;
+    unsigned long high = 1UL << 31;
+    printf("%u %lu %u %u %lu\n", all, mask, max, wrap, high);
+    return 0;
+}